@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""
+Auxiliary Layer Benchmark
+
+Measures end-to-end semantic hint extraction throughput against the local
+mock LLM server, across worker counts, injected failures (and the retries
+they cause), batching, cold/warm response caches, streaming with
+early termination against a verbose model, and a failing endpoint with
+and without the circuit breaker. The mock server
+makes the numbers reproducible without a GPU.
+
+Usage:
+    python benchmarks/bench_auxiliary.py --functions 200 --latency 0.05
+"""
+
+import argparse
+import logging
+import os
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+
+from lisa_ir.core.auxiliary_layer import AuxiliaryLayer, LLMResponseCache  # noqa: E402
+from mock_llm_server import MockLLMServer  # noqa: E402
+
+
+# Comments the heuristics cannot resolve, so every function reaches the LLM
+_AMBIGUOUS_COMMENTS = [
+    "Combines the cached state of the widget with the supplied value and hands back the outcome.",
+    "Looks the key up in the registry and gives the matching entry to the caller.",
+    "Builds a fresh summary of the collection, consulting the configuration object.",
+]
+
+
+def generate_module(functions: int) -> str:
+    """
+    Generate a C extension module with the given number of commented functions.
+
+    Args:
+        functions: Number of functions to generate
+
+    Returns:
+        C source code
+    """
+    parts = ["#include <Python.h>", ""]
+    for i in range(functions):
+        comment = _AMBIGUOUS_COMMENTS[i % len(_AMBIGUOUS_COMMENTS)]
+        parts.extend([
+            f"/* {comment} (variant {i}) */",
+            f"static PyObject *bench_func_{i}(PyObject *self, PyObject *arg)",
+            "{",
+            "    return PyLong_FromLong(0);",
+            "}",
+            "",
+        ])
+    return "\n".join(parts)
+
+
+def run_case(c_code: str, server: MockLLMServer, cache_path: Path, **options) -> dict:
+    """
+    Run one extraction and collect its timing.
+
+    Args:
+        c_code: C source code
+        server: Running mock server
+        cache_path: Response cache file (None disables the cache)
+        **options: Extra AuxiliaryLayer options
+
+    Returns:
+        Dictionary of measurements
+    """
+    cache = LLMResponseCache(cache_path) if cache_path else None
+    auxiliary = AuxiliaryLayer(llm_endpoint=server.url, cache=cache,
+                               use_cache=cache is not None, **options)
+
+    requests_before = server.request_count
+    start = time.perf_counter()
+    hints = auxiliary.extract_semantic_hints(c_code)
+    elapsed = time.perf_counter() - start
+
+    return {
+        "seconds": elapsed,
+        "hints": len(hints),
+        "requests": server.request_count - requests_before,
+        "throughput": len(hints) / elapsed if elapsed > 0 else float("inf"),
+    }
+
+
+def main():
+    """Run the benchmark matrix and print a table."""
+    parser = argparse.ArgumentParser(description="Benchmark the auxiliary layer against the mock LLM server")
+    parser.add_argument("--functions", type=int, default=64, help="Functions in the synthetic module")
+    parser.add_argument("--latency", type=float, default=0.05, help="Mock server latency in seconds")
+    parser.add_argument("--jitter", type=float, default=0.01, help="Mock server latency jitter in seconds")
+    parser.add_argument("--error-rate", type=float, default=0.1, help="Failure rate for the retry cases")
+    parser.add_argument("--workers", type=int, nargs="+", default=[1, 4, 16], help="Worker counts to compare")
+    parser.add_argument("--batch-size", type=int, default=8, help="Batch size for the batching case")
+    parser.add_argument("--trailing-chars", type=int, default=2000,
+                        help="Commentary after each answer for the streaming cases")
+    parser.add_argument("--chunk-delay", type=float, default=0.001,
+                        help="Seconds between streamed chunks for the streaming cases")
+    parser.add_argument("--seed", type=int, default=0, help="Seed for the mock server")
+    args = parser.parse_args()
+
+    logging.disable(logging.WARNING)  # keep the table readable
+
+    c_code = generate_module(args.functions)
+    rows = []
+
+    with tempfile.TemporaryDirectory() as tmp:
+        def cache_file(name):
+            return Path(tmp) / f"{name}.json"
+
+        with MockLLMServer(latency=args.latency, latency_jitter=args.jitter, seed=args.seed) as server:
+            for workers in args.workers:
+                rows.append((f"workers={workers}", run_case(c_code, server, None, max_workers=workers)))
+
+            workers = max(args.workers)
+            rows.append((f"workers={workers} batch={args.batch_size}",
+                         run_case(c_code, server, None, max_workers=workers, batch_size=args.batch_size)))
+
+            path = cache_file("warm")
+            rows.append((f"workers={workers} cache cold", run_case(c_code, server, path, max_workers=workers)))
+            rows.append((f"workers={workers} cache warm", run_case(c_code, server, path, max_workers=workers)))
+
+        with MockLLMServer(latency=args.latency, latency_jitter=args.jitter,
+                           error_rate=args.error_rate, seed=args.seed) as server:
+            for retries in (1, 3):
+                rows.append((f"workers={workers} errors={args.error_rate:g} retries={retries}",
+                             run_case(c_code, server, None, max_workers=workers, max_retries=retries)))
+
+        with MockLLMServer(latency=args.latency, latency_jitter=args.jitter, trailing_chars=args.trailing_chars,
+                           chunk_delay=args.chunk_delay, seed=args.seed) as server:
+            for stream in (False, True):
+                rows.append((f"workers={workers} verbose model stream={'on' if stream else 'off'}",
+                             run_case(c_code, server, None, max_workers=workers, stream=stream)))
+
+        with MockLLMServer(latency=args.latency, error_rate=1.0, seed=args.seed) as server:
+            for threshold in (0, 5):
+                rows.append((f"workers={workers} endpoint down breaker={threshold or 'off'}",
+                             run_case(c_code, server, None, max_workers=workers, breaker_threshold=threshold)))
+
+    print(f"{args.functions} functions, latency {args.latency:g}s +/- {args.jitter:g}s")
+    print(f"{'case':<44} {'seconds':>8} {'hints':>6} {'requests':>9} {'func/s':>8}")
+    for name, result in rows:
+        print(f"{name:<44} {result['seconds']:>8.2f} {result['hints']:>6} "
+              f"{result['requests']:>9} {result['throughput']:>8.1f}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+"""
+SSA Construction Benchmark
+
+Builds synthetic functions of about N basic blocks directly in the IR and
+times dominators (Cooper-Harvey-Kennedy), dominance frontiers, SSA
+construction and the out-of-SSA printer on them. Three shapes are
+generated: a chain of if/else diamonds that all assign the same few
+variables (many phis), nested counting loops, and a seeded random graph
+with irreducible regions. With ``--baseline`` the dominators are also
+computed with the textbook dataflow over dominator bit sets for
+comparison.
+
+Usage:
+    python benchmarks/bench_ssa.py --blocks 1000 10000
+"""
+
+import argparse
+import os
+import random
+import sys
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+
+from lisa_ir.analysis.cfg import ControlFlowGraph  # noqa: E402
+from lisa_ir.ir.ir_nodes import (  # noqa: E402
+    FuncDef, BasicBlock, Param, Variable, make_assign, make_binary_op, make_branch_if, make_constant_int,
+    make_jump, make_return, make_variable
+)
+from lisa_ir.transforms.ssa import to_ssa, format_out_of_ssa  # noqa: E402
+
+VARIABLES = ["a", "b", "c", "d"]
+
+
+def new_function(name: str) -> FuncDef:
+    """Create an empty function over the benchmark variables."""
+    func = FuncDef(name=name, params=[Param(name="n", param_type="int")], entry_point="entry_0",
+                   return_type="int")
+    for var in VARIABLES:
+        func.add_local_var(var, "int")
+    return func
+
+
+def add_block(func: FuncDef, ops=(), terminator=None) -> BasicBlock:
+    """Append a block named after its position."""
+    block = BasicBlock(name=f"{'entry' if not func.blocks else 'bb'}_{len(func.blocks)}",
+                       operations=list(ops), terminator=terminator)
+    func.add_block(block)
+    return block
+
+
+def update(var: str, k: int):
+    """An assignment ``var = var + k``."""
+    return make_assign(var, make_binary_op('+', make_variable(var), make_constant_int(k)))
+
+
+def diamonds(blocks: int) -> FuncDef:
+    """Chain of if/else diamonds; each arm assigns one of the variables."""
+    func = new_function("diamonds")
+    current = add_block(func, [make_assign(var, make_constant_int(0)) for var in VARIABLES])
+    k = 0
+    while len(func.blocks) + 3 < blocks:
+        then_block = add_block(func, [update(VARIABLES[k % 4], k)])
+        else_block = add_block(func, [update(VARIABLES[(k + 1) % 4], k)])
+        merge = add_block(func)
+        current.set_terminator(make_branch_if(make_binary_op('<', make_variable("a"), make_variable("n")),
+                                              then_block.name, else_block.name))
+        then_block.set_terminator(make_jump(merge.name))
+        else_block.set_terminator(make_jump(merge.name))
+        current = merge
+        k += 1
+    current.set_terminator(make_return(make_variable("a")))
+    return func
+
+
+def loops(blocks: int, depth: int = 4) -> FuncDef:
+    """Sequence of loop nests ``depth`` deep; every level counts its own variable."""
+    func = new_function("loops")
+    current = add_block(func)
+    while len(func.blocks) + 3 * depth + 1 < blocks:
+        exits = []
+        for level in range(depth):
+            var = VARIABLES[level % 4]
+            current.add_operation(make_assign(var, make_constant_int(0)))
+            header = add_block(func)
+            body = add_block(func, [update("b", level)])
+            exit_block = add_block(func)
+            current.set_terminator(make_jump(header.name))
+            header.set_terminator(make_branch_if(make_binary_op('<', make_variable(var), make_variable("n")),
+                                                 body.name, exit_block.name))
+            exits.append((header, exit_block, var))
+            current = body
+        for header, exit_block, var in reversed(exits):
+            current.add_operation(update(var, 1))
+            current.set_terminator(make_jump(header.name))
+            current = exit_block
+    current.set_terminator(make_return(make_variable("b")))
+    return func
+
+
+def random_graph(blocks: int, seed: int = 1) -> FuncDef:
+    """Random graph: a spine plus forward and backward branches (irreducible in places)."""
+    rng = random.Random(seed)
+    func = new_function("random")
+    nodes = [add_block(func, [make_assign(var, make_constant_int(0)) for var in VARIABLES])]
+    nodes += [add_block(func, [update(rng.choice(VARIABLES), i)] if rng.random() < 0.5 else [])
+              for i in range(1, blocks)]
+    for i, block in enumerate(nodes[:-1]):
+        if rng.random() < 0.3:
+            other = nodes[rng.randrange(1, len(nodes))]
+            block.set_terminator(make_branch_if(make_binary_op('<', make_variable(rng.choice(VARIABLES)),
+                                                               make_variable("n")),
+                                                nodes[i + 1].name, other.name))
+        else:
+            block.set_terminator(make_jump(nodes[i + 1].name))
+    nodes[-1].set_terminator(make_return(Variable(name="a")))
+    return func
+
+
+def bitset_dominators(cfg: ControlFlowGraph) -> list:
+    """Reference: iterate Dom(b) = {b} | intersection of Dom(p) over predecessors, with int bit sets."""
+    everything = (1 << len(cfg)) - 1
+    dom = [everything] * len(cfg)
+    dom[cfg.entry] = 1 << cfg.entry
+    changed = True
+    while changed:
+        changed = False
+        for block_id in cfg.rpo[1:]:
+            new = everything
+            for pred in cfg.preds[block_id]:
+                if cfg.reachable(pred):
+                    new &= dom[pred]
+            new |= 1 << block_id
+            if new != dom[block_id]:
+                dom[block_id] = new
+                changed = True
+    return dom
+
+
+def timed(function, *args):
+    """Run a function and return (result, seconds)."""
+    start = time.perf_counter()
+    result = function(*args)
+    return result, time.perf_counter() - start
+
+
+def main():
+    """Run the benchmark matrix and print a table."""
+    parser = argparse.ArgumentParser(description="Benchmark dominators and SSA construction")
+    parser.add_argument("--blocks", type=int, nargs="+", default=[1000, 10000],
+                        help="Approximate basic blocks per synthetic function")
+    parser.add_argument("--baseline", action="store_true",
+                        help="Also time the bit-set dataflow dominator computation")
+    args = parser.parse_args()
+
+    print(f"{'shape':<9} {'blocks':>7} {'cfg':>7} {'idom':>7} {'df':>7} {'ssa':>7} {'phis':>6} {'out':>7}"
+          + (f" {'bitset':>8}" if args.baseline else ""))
+    for blocks in args.blocks:
+        for shape in (diamonds, loops, random_graph):
+            func = shape(blocks)
+            cfg, cfg_time = timed(ControlFlowGraph, func)
+            idom, idom_time = timed(cfg.immediate_dominators)
+            _, df_time = timed(cfg.dominance_frontiers)
+            ssa, ssa_time = timed(to_ssa, func)
+            _, out_time = timed(format_out_of_ssa, ssa)
+            phis = sum(1 for block in ssa.blocks.values() for op in block.operations
+                       if type(op).__name__ == "Phi")
+            line = (f"{func.name:<9} {len(func.blocks):>7} {cfg_time:>7.3f} {idom_time:>7.3f} {df_time:>7.3f} "
+                    f"{ssa_time:>7.3f} {phis:>6} {out_time:>7.3f}")
+            if args.baseline:
+                dom, bitset_time = timed(bitset_dominators, cfg)
+                for block_id in cfg.rpo[1:]:
+                    assert dom[block_id] >> idom[block_id] & 1, "dominator mismatch"
+                line += f" {bitset_time:>8.3f}"
+            print(line)
+
+
+if __name__ == "__main__":
+    main()
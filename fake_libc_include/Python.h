@@ -2,13 +2,40 @@
 #define _PYTHON_H
 
 typedef struct _object PyObject;
+typedef struct _typeobject PyTypeObject;
 typedef void (*PyCFunction)(void);
 typedef int Py_ssize_t;
 typedef unsigned long size_t;
 
+/*
+ * Ownership annotations
+ *
+ * These expand to nothing for the compiler. LISA-IR reads them from the
+ * raw header text and turns each annotated prototype into a semantic
+ * database entry:
+ *
+ *   LISA_NEW_REF          returns a new reference
+ *   LISA_BORROWED_REF     returns a borrowed reference
+ *   LISA_STEALS(n)        steals a reference to argument n (0-based)
+ *   LISA_ERROR_RETURN(v)  returns v on failure
+ *   LISA_NO_ERROR         cannot fail
+ */
+#define LISA_NEW_REF
+#define LISA_BORROWED_REF
+#define LISA_STEALS(n)
+#define LISA_ERROR_RETURN(v)
+#define LISA_NO_ERROR
+
 /* Exception types */
 extern PyObject *PyExc_TypeError;
 
+/* Type objects */
+extern PyTypeObject PyDict_Type;
+extern PyTypeObject PyList_Type;
+extern PyTypeObject PyTuple_Type;
+extern PyTypeObject PyLong_Type;
+extern PyTypeObject PyUnicode_Type;
+
 /* Method definitions */
 typedef struct PyMethodDef {
     const char  *ml_name;
@@ -39,26 +66,32 @@ typedef struct PyModuleDef {
 #define METH_KEYWORDS 0x0002
 #define METH_NOARGS   0x0004
 #define METH_O        0x0008
+#define METH_CLASS    0x0010
+#define METH_STATIC   0x0020
+#define METH_COEXIST  0x0040
+#define METH_FASTCALL 0x0080
+#define METH_METHOD   0x0200
 
 /* Additional functions */
-PyObject *PyLong_FromSsize_t(Py_ssize_t v);
-Py_ssize_t PyList_Size(PyObject *list);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyLong_FromSsize_t(Py_ssize_t v);
+LISA_ERROR_RETURN(-1) Py_ssize_t PyList_Size(PyObject *list);
 
 /* Module initialization macro */
 #define PyMODINIT_FUNC PyObject *
 
 /* Object creation and destruction */
-PyObject *PyLong_FromLong(long v);
-PyObject *PyLong_FromUnsignedLong(unsigned long v);
-PyObject *PyLong_FromLongLong(long long v);
-PyObject *PyFloat_FromDouble(double v);
-PyObject *PyUnicode_FromString(const char *u);
-PyObject *PyUnicode_FromStringAndSize(const char *u, Py_ssize_t size);
-PyObject *PyBytes_FromString(const char *v);
-PyObject *PyBytes_FromStringAndSize(const char *v, Py_ssize_t len);
-PyObject *PyList_New(Py_ssize_t len);
-PyObject *PyTuple_New(Py_ssize_t len);
-PyObject *PyDict_New(void);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyLong_FromLong(long v);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyLong_FromUnsignedLong(unsigned long v);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyLong_FromLongLong(long long v);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyFloat_FromDouble(double v);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyUnicode_FromString(const char *u);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyUnicode_FromStringAndSize(const char *u, Py_ssize_t size);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyBytes_FromString(const char *v);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyBytes_FromStringAndSize(const char *v, Py_ssize_t len);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyList_New(Py_ssize_t len);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyTuple_New(Py_ssize_t len);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyDict_New(void);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *Py_BuildValue(const char *format, ...);
 
 /* Reference counting */
 void Py_INCREF(PyObject *op);
@@ -67,77 +100,81 @@ void Py_XINCREF(PyObject *op);
 void Py_XDECREF(PyObject *op);
 
 /* Sequence operations */
-PyObject *PyList_GetItem(PyObject *list, Py_ssize_t index);
-int PyList_SetItem(PyObject *list, Py_ssize_t index, PyObject *item);
-int PyList_Append(PyObject *list, PyObject *item);
-PyObject *PyTuple_GetItem(PyObject *tuple, Py_ssize_t index);
-int PyTuple_SetItem(PyObject *tuple, Py_ssize_t index, PyObject *item);
+LISA_BORROWED_REF LISA_ERROR_RETURN(NULL) PyObject *PyList_GetItem(PyObject *list, Py_ssize_t index);
+LISA_STEALS(2) LISA_ERROR_RETURN(-1) int PyList_SetItem(PyObject *list, Py_ssize_t index, PyObject *item);
+LISA_ERROR_RETURN(-1) int PyList_Append(PyObject *list, PyObject *item);
+LISA_BORROWED_REF LISA_ERROR_RETURN(NULL) PyObject *PyTuple_GetItem(PyObject *tuple, Py_ssize_t index);
+LISA_STEALS(2) LISA_ERROR_RETURN(-1) int PyTuple_SetItem(PyObject *tuple, Py_ssize_t index, PyObject *item);
+LISA_ERROR_RETURN(-1) Py_ssize_t PySequence_Length(PyObject *o);
+LISA_ERROR_RETURN(-1) Py_ssize_t PySequence_Size(PyObject *o);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PySequence_GetItem(PyObject *o, Py_ssize_t i);
 
 /* Mapping operations */
-PyObject *PyDict_GetItemString(PyObject *p, const char *key);
-int PyDict_SetItemString(PyObject *p, const char *key, PyObject *val);
-PyObject *PyDict_GetItem(PyObject *p, PyObject *key);
-int PyDict_SetItem(PyObject *p, PyObject *key, PyObject *val);
+LISA_BORROWED_REF LISA_ERROR_RETURN(NULL) PyObject *PyDict_GetItemString(PyObject *p, const char *key);
+LISA_ERROR_RETURN(-1) int PyDict_SetItemString(PyObject *p, const char *key, PyObject *val);
+LISA_BORROWED_REF LISA_ERROR_RETURN(NULL) PyObject *PyDict_GetItem(PyObject *p, PyObject *key);
+LISA_ERROR_RETURN(-1) int PyDict_SetItem(PyObject *p, PyObject *key, PyObject *val);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyDict_Keys(PyObject *p);
 
 /* Type checking */
-int PyLong_Check(PyObject *p);
-int PyFloat_Check(PyObject *p);
-int PyUnicode_Check(PyObject *p);
-int PyBytes_Check(PyObject *p);
-int PyList_Check(PyObject *p);
-int PyTuple_Check(PyObject *p);
-int PyDict_Check(PyObject *p);
-int PyCallable_Check(PyObject *p);
+LISA_NO_ERROR int PyLong_Check(PyObject *p);
+LISA_NO_ERROR int PyFloat_Check(PyObject *p);
+LISA_NO_ERROR int PyUnicode_Check(PyObject *p);
+LISA_NO_ERROR int PyBytes_Check(PyObject *p);
+LISA_NO_ERROR int PyList_Check(PyObject *p);
+LISA_NO_ERROR int PyTuple_Check(PyObject *p);
+LISA_NO_ERROR int PyDict_Check(PyObject *p);
+LISA_NO_ERROR int PyCallable_Check(PyObject *p);
 
 /* Argument parsing */
-int PyArg_ParseTuple(PyObject *args, const char *format, ...);
-int PyArg_ParseTupleAndKeywords(PyObject *args, PyObject *kw, const char *format, char **kwlist, ...);
+LISA_ERROR_RETURN(0) int PyArg_ParseTuple(PyObject *args, const char *format, ...);
+LISA_ERROR_RETURN(0) int PyArg_ParseTupleAndKeywords(PyObject *args, PyObject *kw, const char *format, char **kwlist, ...);
 
 /* Exception handling */
-void PyErr_SetString(PyObject *exception, const char *string);
-PyObject *PyErr_Occurred(void);
-void PyErr_Clear(void);
+LISA_NO_ERROR void PyErr_SetString(PyObject *exception, const char *string);
+LISA_BORROWED_REF LISA_NO_ERROR PyObject *PyErr_Occurred(void);
+LISA_NO_ERROR void PyErr_Clear(void);
 
 /* Module creation */
 struct PyModuleDef;
-PyObject *PyModule_Create(struct PyModuleDef *def);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyModule_Create(struct PyModuleDef *def);
 
 /* Object protocol */
-PyObject *PyObject_Str(PyObject *v);
-PyObject *PyObject_Repr(PyObject *v);
-int PyObject_HasAttrString(PyObject *v, const char *name);
-PyObject *PyObject_GetAttrString(PyObject *v, const char *name);
-int PyObject_SetAttrString(PyObject *v, const char *name, PyObject *w);
-PyObject *PyObject_GetAttr(PyObject *v, PyObject *name);
-int PyObject_SetAttr(PyObject *v, PyObject *name, PyObject *w);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyObject_Str(PyObject *v);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyObject_Repr(PyObject *v);
+LISA_NO_ERROR int PyObject_HasAttrString(PyObject *v, const char *name);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyObject_GetAttrString(PyObject *v, const char *name);
+LISA_ERROR_RETURN(-1) int PyObject_SetAttrString(PyObject *v, const char *name, PyObject *w);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyObject_GetAttr(PyObject *v, PyObject *name);
+LISA_ERROR_RETURN(-1) int PyObject_SetAttr(PyObject *v, PyObject *name, PyObject *w);
 
 /* Number protocol */
-PyObject *PyNumber_Add(PyObject *o1, PyObject *o2);
-PyObject *PyNumber_Subtract(PyObject *o1, PyObject *o2);
-PyObject *PyNumber_Multiply(PyObject *o1, PyObject *o2);
-PyObject *PyNumber_TrueDivide(PyObject *o1, PyObject *o2);
-PyObject *PyNumber_FloorDivide(PyObject *o1, PyObject *o2);
-PyObject *PyNumber_Remainder(PyObject *o1, PyObject *o2);
-PyObject *PyNumber_Power(PyObject *o1, PyObject *o2, PyObject *o3);
-PyObject *PyNumber_Negative(PyObject *o);
-PyObject *PyNumber_Positive(PyObject *o);
-PyObject *PyNumber_Absolute(PyObject *o);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyNumber_Add(PyObject *o1, PyObject *o2);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyNumber_Subtract(PyObject *o1, PyObject *o2);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyNumber_Multiply(PyObject *o1, PyObject *o2);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyNumber_TrueDivide(PyObject *o1, PyObject *o2);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyNumber_FloorDivide(PyObject *o1, PyObject *o2);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyNumber_Remainder(PyObject *o1, PyObject *o2);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyNumber_Power(PyObject *o1, PyObject *o2, PyObject *o3);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyNumber_Negative(PyObject *o);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyNumber_Positive(PyObject *o);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyNumber_Absolute(PyObject *o);
 
 /* Conversion functions */
-long PyLong_AsLong(PyObject *);
-long long PyLong_AsLongLong(PyObject *);
-double PyFloat_AsDouble(PyObject *);
-char *PyUnicode_AsUTF8(PyObject *);
-char *PyUnicode_AsUTF8AndSize(PyObject *, Py_ssize_t *);
+LISA_ERROR_RETURN(-1) long PyLong_AsLong(PyObject *);
+LISA_ERROR_RETURN(-1) long long PyLong_AsLongLong(PyObject *);
+LISA_ERROR_RETURN(-1.0) double PyFloat_AsDouble(PyObject *);
+LISA_ERROR_RETURN(NULL) char *PyUnicode_AsUTF8(PyObject *);
+LISA_ERROR_RETURN(NULL) char *PyUnicode_AsUTF8AndSize(PyObject *, Py_ssize_t *);
 
 /* Iterator protocol */
-PyObject *PyObject_GetIter(PyObject *);
-PyObject *PyIter_Next(PyObject *);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyObject_GetIter(PyObject *);
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyIter_Next(PyObject *);
 
 /* Memory management */
-void *PyMem_Malloc(size_t size);
-void *PyMem_Realloc(void *ptr, size_t newsize);
-void PyMem_Free(void *ptr);
-void *PyMem_Calloc(size_t nelem, size_t elsize);
+LISA_ERROR_RETURN(NULL) void *PyMem_Malloc(size_t size);
+LISA_ERROR_RETURN(NULL) void *PyMem_Realloc(void *ptr, size_t newsize);
+LISA_NO_ERROR void PyMem_Free(void *ptr);
+LISA_ERROR_RETURN(NULL) void *PyMem_Calloc(size_t nelem, size_t elsize);
 
-#endif
\ No newline at end of file
+#endif
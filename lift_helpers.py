@@ -0,0 +1,31 @@
+#!/usr/bin/env python3
+"""
+Shared helpers for the lifter test scripts
+"""
+
+import logging
+import os
+import tempfile
+
+from lisa_ir.core.lifter import Lifter
+
+
+def lift(path=None, code=None, db_path=None):
+    """Lift a file or source string (with a fresh semantic database unless one is given).
+
+    Args:
+        path: C file to lift
+        code: C source to lift when no path is given
+        db_path: semantic database to use instead of a temporary one
+
+    Returns:
+        The lifted module, paired with the semantic database when db_path is given
+    """
+    logging.disable(logging.WARNING)
+    try:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            lifter = Lifter(semantic_db_path=db_path or os.path.join(tmp_dir, "semantic_db.json"))
+            module = lifter.lift_file(path) if path else lifter.lift_code(code)
+            return (module, lifter.semantic_db) if db_path else module
+    finally:
+        logging.disable(logging.NOTSET)
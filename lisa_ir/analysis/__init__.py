@@ -0,0 +1,13 @@
+"""
+Analysis module for LISA-IR
+"""
+
+from .cfg import ControlFlowGraph
+from .liveness import Liveness
+from .refcount import RefcountChecker, RefcountIssue, check_function, check_module
+from .interprocedural import analyze_module, build_call_graph, reachable_functions, strongly_connected_components
+from .signatures import SignatureIssue, check_method_signatures
+
+__all__ = ['ControlFlowGraph', 'Liveness', 'RefcountChecker', 'RefcountIssue', 'check_function', 'check_module',
+           'analyze_module', 'build_call_graph', 'reachable_functions', 'strongly_connected_components',
+           'SignatureIssue', 'check_method_signatures']
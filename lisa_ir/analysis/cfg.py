@@ -0,0 +1,247 @@
+"""
+Control Flow Graph for LISA-IR
+
+This module indexes the basic blocks of a ``FuncDef`` with integer IDs and
+precomputes successor/predecessor lists and a reverse postorder, which
+every dataflow analysis over the IR starts from, plus the natural loops
+analyses use to find widening points.
+
+Dominators are computed with the iterative algorithm of Cooper, Harvey
+and Kennedy ("A Simple, Fast Dominance Algorithm"): immediate dominators
+live in a flat list indexed by block ID and are intersected by walking up
+the tree in reverse postorder numbers, which converges in a couple of
+passes for the reducible graphs the converter produces.
+"""
+
+from typing import Dict, List, Set
+
+from lisa_ir.ir.ir_nodes import FuncDef, BranchIf, Jump, Switch
+
+
+def terminator_targets(terminator) -> List[str]:
+    """
+    Return the names of the blocks a terminator may transfer control to.
+
+    Args:
+        terminator: A block terminator (or None)
+
+    Returns:
+        List of target block names, without duplicates, in branch order
+    """
+    if isinstance(terminator, BranchIf):
+        targets = [terminator.true_target, terminator.false_target]
+    elif isinstance(terminator, Jump):
+        targets = [terminator.target]
+    elif isinstance(terminator, Switch):
+        targets = list(terminator.cases.values())
+        if terminator.default_target is not None:
+            targets.append(terminator.default_target)
+    else:
+        targets = []
+    return list(dict.fromkeys(targets))
+
+
+class ControlFlowGraph:
+    """
+    Integer-indexed view of a function's control flow graph.
+
+    Block IDs follow the order of ``FuncDef.blocks``. Edges to blocks that
+    do not exist are ignored.
+    """
+
+    def __init__(self, func: FuncDef):
+        """
+        Build the graph.
+
+        Args:
+            func: The function whose blocks to index
+        """
+        self.func = func
+        self.names: List[str] = list(func.blocks)
+        self.index: Dict[str, int] = {name: i for i, name in enumerate(self.names)}
+        self.blocks = [func.blocks[name] for name in self.names]
+        self.entry = self.index.get(func.entry_point, 0)
+
+        self.succs: List[List[int]] = []
+        self.preds: List[List[int]] = [[] for _ in self.names]
+        for i, block in enumerate(self.blocks):
+            succs = [self.index[t] for t in terminator_targets(block.terminator) if t in self.index]
+            self.succs.append(succs)
+            for s in succs:
+                self.preds[s].append(i)
+
+        self.rpo = self._reverse_postorder()
+        self.rpo_index = [-1] * len(self.names)
+        for position, block_id in enumerate(self.rpo):
+            self.rpo_index[block_id] = position
+
+        self._loops = None
+        self._idom = None
+        self._frontiers = None
+
+    def __len__(self) -> int:
+        return len(self.names)
+
+    def _reverse_postorder(self) -> List[int]:
+        """Depth-first reverse postorder of the blocks reachable from the entry (iterative)."""
+        if not self.names:
+            return []
+        visited = [False] * len(self.names)
+        postorder: List[int] = []
+        stack = [(self.entry, 0)]
+        visited[self.entry] = True
+        while stack:
+            block_id, child = stack[-1]
+            succs = self.succs[block_id]
+            if child < len(succs):
+                stack[-1] = (block_id, child + 1)
+                succ = succs[child]
+                if not visited[succ]:
+                    visited[succ] = True
+                    stack.append((succ, 0))
+            else:
+                stack.pop()
+                postorder.append(block_id)
+        postorder.reverse()
+        return postorder
+
+    def reachable(self, block_id: int) -> bool:
+        """Return whether a block is reachable from the entry."""
+        return self.rpo_index[block_id] >= 0
+
+    def is_back_edge(self, source: int, target: int) -> bool:
+        """Return whether an edge goes backwards in reverse postorder (a loop edge)."""
+        return self.rpo_index[target] <= self.rpo_index[source]
+
+    def immediate_dominators(self) -> List[int]:
+        """
+        Compute the immediate dominator of every block.
+
+        Returns:
+            List indexed by block ID; the entry is its own immediate
+            dominator and unreachable blocks have -1
+        """
+        if self._idom is None:
+            idom = [-1] * len(self.names)
+            if self.rpo:
+                order = self.rpo_index
+                idom[self.entry] = self.entry
+                changed = True
+                while changed:
+                    changed = False
+                    for block_id in self.rpo[1:]:
+                        new_idom = -1
+                        for pred in self.preds[block_id]:
+                            if idom[pred] < 0:
+                                continue
+                            if new_idom < 0:
+                                new_idom = pred
+                                continue
+                            # Intersect: climb from the deeper finger until both meet
+                            a, b = pred, new_idom
+                            while a != b:
+                                while order[a] > order[b]:
+                                    a = idom[a]
+                                while order[b] > order[a]:
+                                    b = idom[b]
+                            new_idom = a
+                        if idom[block_id] != new_idom:
+                            idom[block_id] = new_idom
+                            changed = True
+            self._idom = idom
+        return self._idom
+
+    def dominates(self, a: int, b: int) -> bool:
+        """Return whether block ``a`` dominates block ``b`` (both reachable)."""
+        idom = self.immediate_dominators()
+        order = self.rpo_index
+        while order[b] > order[a]:
+            b = idom[b]
+        return a == b
+
+    def dominator_tree(self) -> List[List[int]]:
+        """
+        Return the children of every block in the dominator tree.
+
+        Returns:
+            List indexed by block ID of child IDs, in reverse postorder
+        """
+        idom = self.immediate_dominators()
+        children: List[List[int]] = [[] for _ in self.names]
+        for block_id in self.rpo[1:]:
+            children[idom[block_id]].append(block_id)
+        return children
+
+    def dominance_frontiers(self) -> List[Set[int]]:
+        """
+        Compute the dominance frontier of every block.
+
+        Returns:
+            List indexed by block ID of the blocks where its dominance ends
+        """
+        if self._frontiers is None:
+            idom = self.immediate_dominators()
+            frontiers: List[Set[int]] = [set() for _ in self.names]
+            for block_id in self.rpo:
+                preds = [p for p in self.preds[block_id] if idom[p] >= 0]
+                if len(preds) < 2 and block_id != self.entry:
+                    continue
+                # The entry also joins the function's implicit entry edge, and is
+                # its own idom but still in its own frontier when it heads a loop
+                stop = idom[block_id] if block_id != self.entry else -1
+                for pred in preds:
+                    runner = pred
+                    while runner != stop:
+                        frontiers[runner].add(block_id)
+                        if runner == self.entry:
+                            break
+                        runner = idom[runner]
+            self._frontiers = frontiers
+        return self._frontiers
+
+    def iterated_frontier(self, block_ids) -> Set[int]:
+        """
+        Compute the iterated dominance frontier of a set of blocks.
+
+        Args:
+            block_ids: IDs of the blocks (e.g. those defining a variable)
+
+        Returns:
+            The blocks where their definitions meet, transitively
+        """
+        frontiers = self.dominance_frontiers()
+        result: Set[int] = set()
+        work = list(block_ids)
+        while work:
+            for block_id in frontiers[work.pop()]:
+                if block_id not in result:
+                    result.add(block_id)
+                    work.append(block_id)
+        return result
+
+    def natural_loops(self) -> Dict[int, Set[int]]:
+        """
+        Find the natural loops of the reachable graph.
+
+        Loops sharing a header are combined. The converter only produces
+        structured control flow, so every back edge targets a loop header.
+
+        Returns:
+            Dictionary mapping each loop header to the IDs of its body blocks (header included)
+        """
+        if self._loops is None:
+            loops: Dict[int, Set[int]] = {}
+            for source in self.rpo:
+                for target in self.succs[source]:
+                    if not self.is_back_edge(source, target):
+                        continue
+                    body = loops.setdefault(target, {target})
+                    stack = [source]
+                    while stack:
+                        block_id = stack.pop()
+                        if block_id in body:
+                            continue
+                        body.add(block_id)
+                        stack.extend(p for p in self.preds[block_id] if self.reachable(p))
+            self._loops = loops
+        return self._loops
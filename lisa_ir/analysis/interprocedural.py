@@ -0,0 +1,421 @@
+"""
+Interprocedural Reference Count Analysis for LISA-IR
+
+This module runs the reference count checker over a whole module
+bottom-up: it builds the call graph of the module's own functions, splits
+it into strongly connected components and analyzes each component after
+all of its callees, so calls to user helpers are checked against the
+ownership summaries inferred for those helpers. Mutually recursive
+functions are iterated together until their summaries stop changing.
+
+When the module's entry points are known (method tables and module
+initializers in ``Module.metadata``), the analysis can be limited to the
+functions reachable from them and from non-static functions, skipping
+static helpers nothing can call. It can also be limited to a chosen set
+of functions (e.g. the callers of an API whose semantics changed) and the
+module functions they call.
+
+Components whose callees are all finished do not depend on each other and
+are analyzed in parallel worker processes. The inferred summaries are
+written back to the semantic database, where lifts of other files pick
+them up like any other entry; the converter ignores them for functions
+defined in the file being lifted, whose summaries are inferred afresh
+each time so an edited helper is never checked against its old
+behaviour. With a result cache, components whose IR and consulted
+semantics are unchanged since an earlier run are not analyzed again.
+"""
+
+import logging
+import os
+from concurrent.futures import ProcessPoolExecutor, FIRST_COMPLETED, wait
+from dataclasses import dataclass, field
+from typing import Dict, Iterable, List, Optional, Any, Tuple
+
+from lisa_ir.ir.ir_nodes import FuncDef, Module, Call
+from lisa_ir.analysis.refcount import RefcountChecker, RefcountIssue
+from lisa_ir.analysis.result_cache import RefcountResultCache, component_key
+from lisa_ir.database.semantic_db import INFERRED_SOURCE, VERSION_KEY
+
+# Bound on the summary fixpoint inside one recursive component
+MAX_COMPONENT_ITERATIONS = 8
+
+# Smaller modules are analyzed in-process; worker start-up would dominate
+PARALLEL_MIN_FUNCTIONS = 32
+
+
+def build_call_graph(module: Module) -> Dict[str, List[str]]:
+    """
+    Build the call graph between the functions defined in a module.
+
+    Args:
+        module: The lifted module
+
+    Returns:
+        Dictionary mapping each function to the module functions it calls, in call order
+    """
+    graph: Dict[str, List[str]] = {}
+    for name, func in module.functions.items():
+        callees = []
+        for block in func.blocks.values():
+            for op in block.operations:
+                if isinstance(op, Call) and op.function_name in module.functions:
+                    callees.append(op.function_name)
+        graph[name] = list(dict.fromkeys(callees))
+    return graph
+
+
+def reachable_functions(module: Module, graph: Optional[Dict[str, List[str]]] = None) -> Optional[List[str]]:
+    """
+    List the functions callable from outside the file, directly or through calls.
+
+    Roots are the registered entry points and every non-static function.
+
+    Args:
+        module: The lifted module
+        graph: Its call graph (built if not given)
+
+    Returns:
+        Reachable function names in module order, or None if the module has no entry point metadata
+    """
+    if "entry_points" not in module.metadata:
+        return None
+    graph = graph if graph is not None else build_call_graph(module)
+    static = set(module.metadata.get("static_functions", []))
+    roots = [name for name in module.metadata["entry_points"] if name in graph]
+    roots += [name for name in graph if name not in static]
+
+    reached = set()
+    stack = roots
+    while stack:
+        name = stack.pop()
+        if name not in reached:
+            reached.add(name)
+            stack.extend(graph[name])
+    return [name for name in graph if name in reached]
+
+
+def transitive_callers(graph: Dict[str, List[str]], names: Iterable[str]) -> List[str]:
+    """
+    List functions together with every module function calling them, directly or through calls.
+
+    Args:
+        graph: Call graph of the module
+        names: Functions to start from (names outside the graph are ignored)
+
+    Returns:
+        The functions and their transitive callers in module order
+    """
+    callers: Dict[str, List[str]] = {}
+    for caller, callees in graph.items():
+        for callee in callees:
+            callers.setdefault(callee, []).append(caller)
+
+    reached = set()
+    stack = [name for name in names if name in graph]
+    while stack:
+        name = stack.pop()
+        if name not in reached:
+            reached.add(name)
+            stack.extend(callers.get(name, ()))
+    return [name for name in graph if name in reached]
+
+
+def strongly_connected_components(graph: Dict[str, List[str]]) -> List[List[str]]:
+    """
+    Compute strongly connected components with Tarjan's algorithm.
+
+    The traversal is iterative so deep call chains cannot overflow the
+    Python stack.
+
+    Args:
+        graph: Adjacency lists
+
+    Returns:
+        Components in reverse topological order (callees before callers)
+    """
+    index: Dict[str, int] = {}
+    lowlink: Dict[str, int] = {}
+    on_stack = set()
+    stack: List[str] = []
+    components: List[List[str]] = []
+
+    for root in graph:
+        if root in index:
+            continue
+        work = [(root, iter(graph[root]))]
+        index[root] = lowlink[root] = len(index)
+        stack.append(root)
+        on_stack.add(root)
+
+        while work:
+            node, successors = work[-1]
+            for succ in successors:
+                if succ not in index:
+                    index[succ] = lowlink[succ] = len(index)
+                    stack.append(succ)
+                    on_stack.add(succ)
+                    work.append((succ, iter(graph.get(succ, ()))))
+                    break
+                if succ in on_stack:
+                    lowlink[node] = min(lowlink[node], index[succ])
+            else:
+                work.pop()
+                if work:
+                    parent = work[-1][0]
+                    lowlink[parent] = min(lowlink[parent], lowlink[node])
+                if lowlink[node] == index[node]:
+                    component = []
+                    while True:
+                        member = stack.pop()
+                        on_stack.discard(member)
+                        component.append(member)
+                        if member == node:
+                            break
+                    components.append(component[::-1])
+
+    return components
+
+
+def analyze_component(functions: List[FuncDef], summaries: Dict[str, Dict[str, Any]], recursive: bool,
+                      options: Optional[Dict[str, Any]] = None
+                      ) -> Tuple[Dict[str, Optional[Dict[str, Any]]], List[RefcountIssue], List[str]]:
+    """
+    Check one strongly connected component and infer its summaries.
+
+    Runs in worker processes, so it only takes and returns picklable data.
+
+    Args:
+        functions: The component's functions
+        summaries: Summaries of the functions it calls outside the component
+        recursive: Whether the component calls itself (needs a fixpoint)
+        options: Extra RefcountChecker options
+
+    Returns:
+        Tuple (summary per function, issues from the final iteration,
+        functions that exhausted their path state budget)
+    """
+    known = dict(summaries)
+    inferred: Dict[str, Optional[Dict[str, Any]]] = {}
+    issues: List[RefcountIssue] = []
+    exhausted: List[str] = []
+
+    for _ in range(MAX_COMPONENT_ITERATIONS if recursive else 1):
+        changed = False
+        issues = []
+        exhausted = []
+        for func in functions:
+            checker = RefcountChecker(func, known, **(options or {}))
+            issues.extend(checker.check())
+            if checker.budget_exhausted:
+                exhausted.append(func.name)
+            summary = checker.summary()
+            if summary != inferred.get(func.name):
+                changed = True
+            inferred[func.name] = summary
+            if summary is None:
+                known.pop(func.name, None)
+            else:
+                known[func.name] = summary
+        if not changed:
+            break
+
+    return inferred, issues, exhausted
+
+
+@dataclass
+class InterproceduralResult:
+    """Outcome of a bottom-up module analysis."""
+    summaries: Dict[str, Dict[str, Any]] = field(default_factory=dict)
+    issues: List[RefcountIssue] = field(default_factory=list)
+    components: int = 0
+    stored: int = 0
+    budget_exhausted: List[str] = field(default_factory=list)
+    skipped: List[str] = field(default_factory=list)
+    cached: int = 0
+    updated: List[str] = field(default_factory=list)
+
+
+def analyze_module(module: Module, semantic_db=None, max_workers: Optional[int] = None,
+                   min_parallel_functions: int = PARALLEL_MIN_FUNCTIONS, reachable_only: bool = False,
+                   functions: Optional[Iterable[str]] = None, cache: Optional[RefcountResultCache] = None,
+                   **options) -> InterproceduralResult:
+    """
+    Check a module bottom-up over its call graph.
+
+    Args:
+        module: The lifted module
+        semantic_db: Database to store inferred summaries in (None to skip storing)
+        max_workers: Worker processes for independent components (None uses the CPU count)
+        min_parallel_functions: Modules with fewer functions are analyzed in-process
+        reachable_only: Skip static functions no entry point can reach
+        functions: Only check these functions and the module functions they call
+        cache: Result cache to answer unchanged components from (saved before returning)
+        **options: RefcountChecker options (path_sensitive, state_budget, ...)
+
+    Returns:
+        InterproceduralResult with summaries, issues in module order and the entries stored
+    """
+    logger = logging.getLogger(__name__)
+
+    graph = build_call_graph(module)
+    skipped: List[str] = []
+    if reachable_only:
+        reachable = reachable_functions(module, graph)
+        if reachable is not None:
+            reached = set(reachable)
+            skipped = [name for name in graph if name not in reached]
+            graph = {name: graph[name] for name in reachable}
+    if functions is not None:
+        reached = set()
+        stack = [name for name in functions if name in graph]
+        while stack:
+            name = stack.pop()
+            if name not in reached:
+                reached.add(name)
+                stack.extend(graph[name])
+        skipped += [name for name in graph if name not in reached]
+        graph = {name: callees for name, callees in graph.items() if name in reached}
+    components = strongly_connected_components(graph)
+    component_of = {name: i for i, component in enumerate(components) for name in component}
+
+    # Components each component waits for, and the reverse edges
+    dependencies = [set() for _ in components]
+    dependents = [set() for _ in components]
+    for caller, callees in graph.items():
+        for callee in callees:
+            src, dst = component_of[caller], component_of[callee]
+            if src != dst:
+                dependencies[src].add(dst)
+                dependents[dst].add(src)
+    recursive = [len(component) > 1 or component[0] in graph[component[0]] for component in components]
+
+    summaries: Dict[str, Dict[str, Any]] = {}
+    unsummarized: List[str] = []
+    issues_by_function: Dict[str, List[RefcountIssue]] = {}
+    exhausted = set()
+    keys: Dict[int, str] = {}
+    cached = 0
+
+    def job(i):
+        callees = {callee for name in components[i] for callee in graph[name]}
+        known = {name: summaries[name] for name in callees if name in summaries}
+        return [module.functions[name] for name in components[i]], known, recursive[i], options
+
+    def lookup(i):
+        """Return the cached results of a component, remembering its key on a miss."""
+        nonlocal cached
+        if cache is None:
+            return None
+        key = component_key(*job(i), semantic_db=semantic_db, local=module.functions)
+        result = cache.get(key)
+        if result is None:
+            keys[i] = key
+        else:
+            cached += 1
+        return result
+
+    def finish(i, result):
+        if i in keys:
+            cache.put(keys.pop(i), result)
+        inferred, issues, budget_exhausted = result
+        exhausted.update(budget_exhausted)
+        for name, summary in inferred.items():
+            if summary is not None:
+                summaries[name] = summary
+            else:
+                unsummarized.append(name)
+        for issue in issues:
+            issues_by_function.setdefault(issue.function, []).append(issue)
+
+    workers = max_workers or os.cpu_count() or 1
+    if workers <= 1 or len(components) <= 1 or len(graph) < min_parallel_functions:
+        # Tarjan's order already puts every callee component first
+        for i in range(len(components)):
+            finish(i, lookup(i) or analyze_component(*job(i)))
+    else:
+        waiting = [len(deps) for deps in dependencies]
+        with ProcessPoolExecutor(max_workers=workers) as pool:
+            running = {}
+
+            def start(ready):
+                # Cached components finish at once and may make their dependents ready
+                while ready:
+                    i = ready.pop()
+                    result = lookup(i)
+                    if result is None:
+                        running[pool.submit(analyze_component, *job(i))] = i
+                        continue
+                    finish(i, result)
+                    ready.extend(release(i))
+
+            def release(i):
+                released = []
+                for dependent in dependents[i]:
+                    waiting[dependent] -= 1
+                    if waiting[dependent] == 0:
+                        released.append(dependent)
+                return released
+
+            start([i for i, count in enumerate(waiting) if count == 0])
+            while running:
+                done, _ = wait(running, return_when=FIRST_COMPLETED)
+                for future in done:
+                    i = running.pop(future)
+                    finish(i, future.result())
+                    start(release(i))
+
+    result = InterproceduralResult(summaries=summaries, components=len(components), skipped=skipped,
+                                   cached=cached)
+    for name in module.functions:
+        result.issues.extend(issues_by_function.get(name, []))
+        if name in exhausted:
+            result.budget_exhausted.append(name)
+            logger.warning(f"Path state budget exhausted in {name}, used path-insensitive results")
+
+    if semantic_db is not None:
+        result.updated = store_summaries(semantic_db, summaries, unsummarized)
+        result.stored = len(result.updated)
+    if cache is not None:
+        cache.save()
+
+    logger.info(f"Analyzed {len(graph)} functions in {len(components)} components "
+                f"({cached} from cache), {len(result.issues)} issues, {result.stored} summaries stored")
+    return result
+
+
+def store_summaries(semantic_db, summaries: Dict[str, Dict[str, Any]],
+                    unsummarized: Iterable[str] = ()) -> List[str]:
+    """
+    Write inferred summaries to the semantic database.
+
+    An inferred entry is replaced whole by the new summary, and removed
+    when nothing could be inferred for the function any more. Entries that
+    came from elsewhere (curated, header annotations or the auxiliary
+    layer) take precedence and are never overwritten or removed.
+
+    Args:
+        semantic_db: The semantic database
+        summaries: Inferred summaries keyed by function name
+        unsummarized: Analyzed functions nothing was inferred for
+
+    Returns:
+        Names of the entries written (new or changed) or removed
+    """
+    entries = []
+    for name, summary in summaries.items():
+        existing = semantic_db.get_function_info(name)
+        if existing is not None and existing.get("source") != INFERRED_SOURCE:
+            continue
+        info = dict(summary, source=INFERRED_SOURCE)
+        if existing is not None and {k: v for k, v in existing.items() if k != VERSION_KEY} == info:
+            continue
+        entries.append({"func_name": name, "info": info})
+    if entries:
+        semantic_db.bulk_update(entries)
+
+    removed = []
+    for name in unsummarized:
+        existing = semantic_db.get_function_info(name)
+        if existing is not None and existing.get("source") == INFERRED_SOURCE and semantic_db.remove_function(name):
+            removed.append(name)
+    return [entry["func_name"] for entry in entries] + removed
@@ -0,0 +1,209 @@
+"""
+Liveness Analysis for LISA-IR
+
+This module computes which variables are live (may still be read) on
+entry to and exit from every basic block. Each variable gets a bit, so the
+per-block sets are single integers and the backward dataflow equations
+
+    live_out(b) = union of live_in(s) over successors s
+    live_in(b)  = uses(b) | (live_out(b) & ~defs(b))
+
+are a handful of bitwise operations per block, iterated in postorder.
+
+Reads are variables in expressions and terminators and the variables
+semantic operations inspect (``decr-ref`` targets, ``error-check``
+sources, ...). A call result, an assignment target and the target of
+``new-ref``/``borrow-ref``/``parse-convert``/``parse-assign`` are
+definitions. The blocks in which a variable is live form its live range.
+"""
+
+from typing import Dict, Iterable, List, Optional, Set, Tuple
+
+from lisa_ir.analysis.cfg import ControlFlowGraph
+from lisa_ir.ir.ir_nodes import IRNode, FuncDef, Variable, Assign, Call, SemanticOp, Phi
+
+
+# Semantic operation attributes that name a variable
+VARIABLE_ATTRIBUTES = ("target", "dest", "source")
+
+# Semantic operation attributes that define their variable instead of reading it
+DEFINING_ATTRIBUTES = {
+    ("new-ref", "target"), ("borrow-ref", "dest"), ("parse-convert", "target"), ("parse-assign", "target"),
+}
+
+
+def _variables(node) -> Iterable[str]:
+    """Yield the names of all variables referenced in an expression tree."""
+    stack = [node]
+    while stack:
+        current = stack.pop()
+        if isinstance(current, Variable):
+            yield current.name
+            continue
+        for value in current.__dict__.values():
+            if isinstance(value, IRNode):
+                stack.append(value)
+            elif isinstance(value, list):
+                stack.extend(item for item in value if isinstance(item, IRNode))
+            elif isinstance(value, dict):
+                stack.extend(item for item in value.values() if isinstance(item, IRNode))
+
+
+def uses_and_defs(op) -> Tuple[Set[str], Set[str]]:
+    """
+    Return the variables an operation or terminator reads and those it writes.
+
+    Args:
+        op: The operation or terminator
+
+    Returns:
+        Tuple (read names, written names); reads happen before writes
+    """
+    if isinstance(op, Assign):
+        return set(_variables(op.value)), {op.target.name}
+    if isinstance(op, Call):
+        uses: Set[str] = set()
+        for arg in op.args:
+            uses.update(_variables(arg))
+        return uses, {op.dest_var} if op.dest_var else set()
+    if isinstance(op, Phi):
+        return set(), {op.target.name}  # operands are read on the incoming edges
+    if isinstance(op, SemanticOp):
+        uses, defs = set(), set()
+        for key in VARIABLE_ATTRIBUTES:
+            value = op.attributes.get(key)
+            if isinstance(value, str):
+                (defs if (op.op_type, key) in DEFINING_ATTRIBUTES else uses).add(value)
+        return uses, defs
+    return set(_variables(op)), set()
+
+
+class Liveness:
+    """Per-block live variable sets of one function, as bit sets."""
+
+    def __init__(self, func: FuncDef, cfg: Optional[ControlFlowGraph] = None,
+                 variables: Optional[Iterable[str]] = None):
+        """
+        Solve liveness for a function.
+
+        Args:
+            func: The function
+            cfg: Its control flow graph, if already built
+            variables: Variables to track (default: the parameters, locals and every
+                variable an operation defines, leaving out globals and constants like NULL)
+        """
+        self.cfg = cfg if cfg is not None and cfg.func is func else ControlFlowGraph(func)
+        block_effects = []
+        defined: Dict[str, None] = {}
+        for block in self.cfg.blocks:
+            effects = [uses_and_defs(op) for op in block.operations]
+            if block.terminator is not None:
+                effects.append(uses_and_defs(block.terminator))
+            block_effects.append(effects)
+            for _, defs in effects:
+                defined.update(dict.fromkeys(sorted(defs)))
+
+        if variables is None:
+            variables = [param.name for param in func.params] + list(func.local_vars) + list(defined)
+        self.variables: List[str] = list(dict.fromkeys(variables))
+        self.index: Dict[str, int] = {name: i for i, name in enumerate(self.variables)}
+
+        # Operation effects as bit sets, kept for live_after()
+        self._effects: List[List[Tuple[int, int]]] = []
+        self.uses: List[int] = []
+        self.defs: List[int] = []
+        for effects in block_effects:
+            bits = [(self.bits(uses), self.bits(defs)) for uses, defs in effects]
+            self._effects.append(bits)
+            block_uses = block_defs = 0
+            for uses, defs in bits:
+                block_uses |= uses & ~block_defs
+                block_defs |= defs
+            self.uses.append(block_uses)
+            self.defs.append(block_defs)
+
+        # Phi operands are live out of the predecessor they come from
+        self.phi_uses: List[int] = [0] * len(self.cfg)
+        for block in self.cfg.blocks:
+            for op in block.operations:
+                if isinstance(op, Phi):
+                    for pred, value in op.incoming.items():
+                        if pred in self.cfg.index:
+                            self.phi_uses[self.cfg.index[pred]] |= self.bits(_variables(value))
+
+        self.live_in: List[int] = [0] * len(self.cfg)
+        self.live_out: List[int] = [0] * len(self.cfg)
+        self.iterations = 0
+        self._solve()
+
+    def bits(self, names: Iterable[str]) -> int:
+        """Return the bit set of the tracked variables among names."""
+        result = 0
+        for name in names:
+            i = self.index.get(name)
+            if i is not None:
+                result |= 1 << i
+        return result
+
+    def names(self, bits: int) -> Set[str]:
+        """Return the variable names in a bit set."""
+        return {name for i, name in enumerate(self.variables) if bits >> i & 1}
+
+    def _solve(self) -> None:
+        """Iterate the backward equations to a fixpoint, visiting blocks in postorder."""
+        order = list(reversed(self.cfg.rpo))
+        order += [b for b in range(len(self.cfg)) if not self.cfg.reachable(b)]
+        changed = True
+        while changed:
+            changed = False
+            self.iterations += 1
+            for block_id in order:
+                out = self.phi_uses[block_id]
+                for succ in self.cfg.succs[block_id]:
+                    out |= self.live_in[succ]
+                live_in = self.uses[block_id] | (out & ~self.defs[block_id])
+                if out != self.live_out[block_id] or live_in != self.live_in[block_id]:
+                    self.live_out[block_id] = out
+                    self.live_in[block_id] = live_in
+                    changed = True
+
+    def live_after(self, block_id: int) -> List[int]:
+        """
+        Return the live set after each operation of a block.
+
+        Args:
+            block_id: The block
+
+        Returns:
+            One bit set per operation (the terminator, if any, is last)
+        """
+        live = self.live_out[block_id]
+        result = []
+        for uses, defs in reversed(self._effects[block_id]):
+            result.append(live)
+            live = uses | (live & ~defs)
+        result.reverse()
+        return result
+
+    def is_live_in(self, name: str, block_name: str) -> bool:
+        """Return whether a variable is live on entry to a block."""
+        return bool(self.live_in[self.cfg.index[block_name]] >> self.index[name] & 1)
+
+    def live_ranges(self) -> Dict[str, List[str]]:
+        """
+        Return the blocks each variable is live in.
+
+        A variable is in a block's range when it is live on entry to or on
+        exit from it; variables that never live across a block boundary
+        have an empty range.
+
+        Returns:
+            Block names per variable, in block order
+        """
+        ranges: Dict[str, List[str]] = {name: [] for name in self.variables}
+        for block_id, name in enumerate(self.cfg.names):
+            live = self.live_in[block_id] | self.live_out[block_id]
+            for i, variable in enumerate(self.variables):
+                if live >> i & 1:
+                    ranges[variable].append(name)
+        return ranges
@@ -0,0 +1,786 @@
+"""
+Reference Count Checker for LISA-IR
+
+This module runs a forward dataflow analysis over the lifted control flow
+graph of each function and reports reference counting bugs:
+
+- ``leak``: an owned reference is still held when the function returns,
+  or the variable holding it is overwritten
+- ``over-decref``: a borrowed or already released reference is decremented
+- ``use-after-steal``: a reference is decremented or stolen again after a
+  call stole it
+
+The abstract value of each tracked ``PyObject *`` variable is the set of
+ownership facts that may hold for it (a may-analysis), packed six bits per
+variable into a single integer so that joins are one bitwise OR. The
+analysis only reads semantic operations (``new-ref``, ``borrow-ref``,
+``steal-ref``, ``incr-ref``, ``decr-ref``, ``error-check``,
+``parse-convert``), assignments and
+branch conditions, so it needs no knowledge of individual APIs. Calls
+the converter could not annotate can be described by ownership summaries
+(the semantic database format), which is how the interprocedural driver
+feeds callee results into their callers; after a run the checker infers
+such a summary for the function itself.
+
+Copying a reference between two named variables (``b = a``) does not
+create a second reference: both names then hold the same one. An owned
+variable's facts say whether its reference may be its own (``unshared``);
+releasing, stealing, storing or NULL-testing a variable that certainly
+holds a copied reference applies to every variable of its alias class that
+certainly holds one too, so ``b = a; Py_DECREF(b)`` also releases ``a``,
+while ``b = a; Py_INCREF(b)`` gives ``b`` a reference of its own.
+
+In path-sensitive mode each block keeps one state per distinct set of
+owned references instead of a single joined state, so facts that only
+hold together on one path (a variable that was assigned from a
+successful call, say) are not mixed with the other paths. States that
+agree on ownership are merged at join points, which collapses the
+error paths of calls that reconverge after cleanup; a per-function
+state budget bounds the rest, after which the function falls back to
+the path-insensitive analysis.
+
+Facts are only kept while they can still matter: on entry to a block,
+variables that are dead there (never read again before being redefined)
+keep just their ownership bits (whether they own a reference and whether it
+is their own), which is all a later leak report needs.
+This narrows each object's tracked window to its live range, so states
+that differ only in stale facts of dead temporaries become equal.
+
+Loops are summarized by their abstract per-iteration ownership delta:
+the facts one pass through the body can give each variable it writes,
+directly or through copies.
+Once a loop header has been visited a few times, variables whose facts
+are still growing are widened by that delta in one step, so every loop
+settles after a bounded number of iterations however deeply it is
+nested; in path-sensitive mode the header's path states are also
+merged into one.
+"""
+
+import heapq
+import re
+from dataclasses import dataclass, asdict
+from typing import Dict, List, Optional, Any, Tuple
+
+from lisa_ir.ir.ir_nodes import (
+    FuncDef, Module, BasicBlock, Assign, Call, Store, SemanticOp, Return, BranchIf,
+    Variable, Constant, Cast, UnaryOp, BinaryOp
+)
+from lisa_ir.analysis.cfg import ControlFlowGraph
+from lisa_ir.analysis.liveness import Liveness
+from lisa_ir.core.ast_converter import is_temporary
+
+
+# Ownership facts (one bit each)
+NULL = 1        # the pointer may be NULL
+OWNED = 2       # we hold a reference that must be released
+BORROWED = 4    # we may use the object but do not own a reference
+STOLEN = 8      # a call took our reference
+RELEASED = 16   # we decremented our reference
+UNSHARED = 32   # the reference held may be this variable's own rather than a copy
+
+FACT_BITS = 6
+FACT_MASK = (1 << FACT_BITS) - 1
+
+# Distinct states a path-sensitive run may create per function before falling back
+DEFAULT_STATE_BUDGET = 20000
+
+# Visits of a loop header before its incoming states are widened
+DEFAULT_WIDEN_DELAY = 2
+
+# Facts a semantic operation can give the variable named by one of its attributes
+_LOOP_EFFECTS = {
+    "new-ref": ("target", OWNED | UNSHARED),
+    "borrow-ref": ("dest", BORROWED),
+    "incr-ref": ("target", OWNED | UNSHARED),
+    "decr-ref": ("target", RELEASED),
+    "steal-ref": ("target", STOLEN),
+    "error-check": ("source", NULL),
+}
+
+FACT_NAMES = {NULL: "null", OWNED: "owned", BORROWED: "borrowed", STOLEN: "stolen", RELEASED: "released",
+              UNSHARED: "unshared"}
+
+_OBJECT_TYPE_PATTERN = re.compile(r'^(?:const\s+)?PyObject\s*\*$')
+
+
+def is_object_type(type_string: Optional[str]) -> bool:
+    """Return whether a C type string is a single ``PyObject`` pointer."""
+    return bool(type_string) and bool(_OBJECT_TYPE_PATTERN.match(type_string.strip()))
+
+
+def describe_facts(facts: int) -> str:
+    """Render a fact set as e.g. ``owned|null``."""
+    return "|".join(name for bit, name in FACT_NAMES.items() if facts & bit) or "unknown"
+
+
+def strip_casts(expr):
+    """Remove casts around an expression."""
+    while isinstance(expr, Cast):
+        expr = expr.expr
+    return expr
+
+
+def is_null_constant(expr) -> bool:
+    """Return whether an expression is a null pointer constant (``NULL``, ``0``, ``(void *)0``)."""
+    expr = strip_casts(expr)
+    if isinstance(expr, Constant):
+        return expr.value in (0, "0", "NULL")
+    return isinstance(expr, Variable) and expr.name == "NULL"
+
+
+@dataclass
+class RefcountIssue:
+    """A reference counting problem found by the checker."""
+    kind: str
+    function: str
+    variable: str
+    coord: Optional[str]
+    message: str
+
+    def to_dict(self) -> Dict[str, Any]:
+        return asdict(self)
+
+    def __str__(self) -> str:
+        return f"{self.coord or self.function}: {self.kind}: {self.message}"
+
+
+class RefcountChecker:
+    """
+    Worklist dataflow analysis of reference ownership in one function.
+
+    Blocks are visited in reverse postorder from a priority worklist, so
+    forward facts reach most blocks after a single visit and loops only
+    re-queue the blocks they contain.
+    """
+
+    def __init__(self, func: FuncDef, summaries: Optional[Dict[str, Dict[str, Any]]] = None,
+                 path_sensitive: bool = False, state_budget: int = DEFAULT_STATE_BUDGET,
+                 merge_states: bool = True, widen_delay: Optional[int] = DEFAULT_WIDEN_DELAY,
+                 narrow_liveness: bool = True):
+        """
+        Prepare the analysis of a function.
+
+        Args:
+            func: The lifted function to check
+            summaries: Ownership summaries of callees whose calls carry no semantic operations
+            path_sensitive: Keep separate states per path instead of joining them at every block
+            state_budget: Maximum states a path-sensitive run may create before falling back
+            merge_states: Merge path states that agree on which variables own a reference
+            widen_delay: Loop header visits before widening (None disables widening)
+            narrow_liveness: Forget all but ownership of variables that are dead on entry to a block
+        """
+        self.func = func
+        self.cfg = ControlFlowGraph(func)
+        self.summaries = summaries or {}
+        self.path_sensitive = path_sensitive
+        self.state_budget = state_budget
+        self.merge_states = merge_states
+        self.widen_delay = widen_delay
+
+        params = [p.name for p in func.params if is_object_type(p.param_type)]
+        locals_ = [name for name, var_type in func.local_vars.items() if is_object_type(var_type)]
+        self.variables: List[str] = list(dict.fromkeys(params + locals_))
+        self.slot: Dict[str, int] = {name: i for i, name in enumerate(self.variables)}
+        self.params = params
+
+        self.alias_parent: Dict[str, str] = {name: name for name in self.variables}
+        for block in self.cfg.blocks:
+            for op in block.operations:
+                if isinstance(op, Assign):
+                    source = strip_casts(op.value)
+                    if (isinstance(source, Variable) and op.target.name in self.slot
+                            and source.name in self.slot and not is_temporary(source.name)):
+                        self._union(op.target.name, source.name)
+        # Other members of each variable's alias class
+        self.aliases: Dict[str, List[str]] = {}
+        for name in self.variables:
+            members = [other for other in self.variables if other != name and self._find(other) == self._find(name)]
+            if members:
+                self.aliases[name] = members
+
+        # Calls the converter already followed with semantic operations
+        self.annotated_calls = set()
+        for block in self.cfg.blocks:
+            for op, following in zip(block.operations, block.operations[1:]):
+                if isinstance(op, Call) and isinstance(following, SemanticOp) and following.coord == op.coord:
+                    self.annotated_calls.add(id(op))
+
+        # Observations for summary inference, gathered while reporting
+        self.param_index = {p.name: i for i, p in enumerate(func.params)}
+        self.stolen_params = set()
+        self.return_facts = 0
+        self.returns_null = False
+        self.return_constants = set()
+
+        # Bits compared when deciding whether two path states may be merged, and
+        # bits kept for dead variables (whether they still own, and whose reference)
+        self.ownership_mask = 0
+        retained_mask = 0
+        for i in range(len(self.variables)):
+            self.ownership_mask |= OWNED << (i * FACT_BITS)
+            retained_mask |= (OWNED | UNSHARED) << (i * FACT_BITS)
+
+        # Facts kept on entry to each block: dead variables can only still leak
+        self.live_masks: Optional[List[int]] = None
+        if narrow_liveness and self.variables:
+            liveness = Liveness(func, self.cfg, self.variables)
+            self.live_masks = []
+            for live in liveness.live_in:
+                mask = retained_mask
+                for i in range(len(self.variables)):
+                    if live >> i & 1:
+                        mask |= FACT_MASK << (i * FACT_BITS)
+                self.live_masks.append(mask)
+
+        # Per-iteration ownership delta of every loop, keyed by header block ID
+        self.loop_deltas = {header: self.loop_delta(body) for header, body in self.cfg.natural_loops().items()}
+        self.header_visits: Dict[int, int] = {}
+        self.widenings = 0
+
+        self.issues: Dict[tuple, RefcountIssue] = {}
+        self.visits = 0
+        self.states = 0
+        self.budget_exhausted = False
+
+    def _find(self, name: str) -> str:
+        while self.alias_parent[name] != name:
+            self.alias_parent[name] = self.alias_parent[self.alias_parent[name]]
+            name = self.alias_parent[name]
+        return name
+
+    def _union(self, a: str, b: str) -> None:
+        self.alias_parent[self._find(a)] = self._find(b)
+
+    def sharing(self, state: int, name: str) -> List[str]:
+        """Return the variables certainly holding the same copied reference as a variable (itself first)."""
+        if self.facts(state, name) & (OWNED | UNSHARED) != OWNED:
+            return [name]
+        return [name] + [other for other in self.aliases.get(name, ())
+                         if self.facts(state, other) & (OWNED | UNSHARED) == OWNED]
+
+    def loop_delta(self, body) -> Tuple[Dict[str, int], List[Tuple[str, str]]]:
+        """
+        Summarize what one iteration of a loop can do to each variable.
+
+        Args:
+            body: Block IDs of the loop
+
+        Returns:
+            Tuple (facts the body's operations can produce per variable,
+            variable-to-variable copies in the body as (target, source))
+        """
+        gen: Dict[str, int] = {}
+        copies: List[Tuple[str, str]] = []
+
+        def add(name, facts):
+            if name in self.slot:
+                gen[name] = gen.get(name, 0) | facts
+
+        for block_id in body:
+            for op in self.cfg.blocks[block_id].operations:
+                if isinstance(op, SemanticOp):
+                    attrs = op.attributes
+                    effect = _LOOP_EFFECTS.get(op.op_type)
+                    if effect:
+                        add(attrs.get(effect[0]), effect[1])
+                elif isinstance(op, Assign):
+                    source = strip_casts(op.value)
+                    if isinstance(source, Variable) and source.name in self.slot:
+                        if op.target.name in self.slot:
+                            copies.append((op.target.name, source.name))
+                    else:
+                        add(op.target.name, NULL if is_null_constant(source) else 0)
+                elif isinstance(op, Store):
+                    value = strip_casts(op.value)
+                    if isinstance(value, Variable):
+                        add(value.name, BORROWED)
+                elif isinstance(op, Call) and op.function_name in self.summaries:
+                    add(op.dest_var, OWNED | UNSHARED | BORROWED | NULL)
+                    for arg in op.args:
+                        arg = strip_casts(arg)
+                        if isinstance(arg, Variable):
+                            add(arg.name, STOLEN)
+        return gen, copies
+
+    def widen(self, header: int, old: int, new: int) -> int:
+        """
+        Widen a loop header state that is still growing.
+
+        While the header state keeps growing, every variable the loop
+        writes gets all the facts the loop can give it in one step: those
+        its operations produce plus, through copies, those of the
+        variables it is copied from. A new OWNED fact is only kept when
+        an iteration already ends owning the reference, so widening does
+        not invent leaks on overwrite.
+
+        Args:
+            header: Loop header block ID
+            old: Header state before this arrival
+            new: Header state after joining the arrival
+
+        Returns:
+            The widened state
+        """
+        gen, copies = self.loop_deltas[header]
+        if new == old:
+            return new
+
+        reach = dict(gen)
+        for target, source in copies:
+            reach.setdefault(target, 0)
+            reach[source] = reach.get(source, 0) | self.facts(new, source)
+        changed = True
+        while changed:
+            changed = False
+            for target, source in copies:
+                if reach[source] & ~reach[target]:
+                    reach[target] |= reach[source]
+                    changed = True
+
+        widened = new
+        for name in reach:
+            facts = self.facts(new, name)
+            extra = reach[name] if facts & OWNED else reach[name] & ~(OWNED | UNSHARED)
+            widened = self.with_facts(widened, name, facts | extra)
+        if self.live_masks is not None:
+            widened &= self.live_masks[header]
+        if widened != new:
+            self.widenings += 1
+        return widened
+
+    def widening_due(self, block_id: int) -> bool:
+        """Return whether states flowing into a block are widened."""
+        return (self.widen_delay is not None and block_id in self.loop_deltas
+                and self.header_visits.get(block_id, 0) >= self.widen_delay)
+
+    def facts(self, state: int, name: str) -> int:
+        """Return the facts of a tracked variable in a state."""
+        return (state >> (self.slot[name] * FACT_BITS)) & FACT_MASK
+
+    def with_facts(self, state: int, name: str, facts: int) -> int:
+        """Return a state with a tracked variable's facts replaced."""
+        shift = self.slot[name] * FACT_BITS
+        return (state & ~(FACT_MASK << shift)) | (facts << shift)
+
+    def entry_state(self) -> int:
+        """Parameters are borrowed references; locals start without facts."""
+        state = 0
+        for name in self.params:
+            state = self.with_facts(state, name, BORROWED | NULL)
+        if self.live_masks is not None:
+            state &= self.live_masks[self.cfg.entry]
+        return state
+
+    def report(self, kind: str, name: str, coord: Optional[str], message: str) -> None:
+        """Record an issue (once per kind, variable and location)."""
+        key = (kind, name, coord)
+        if key not in self.issues:
+            self.issues[key] = RefcountIssue(kind=kind, function=self.func.name, variable=name,
+                                             coord=coord, message=message)
+
+    def _overwrite(self, state: int, name: str, coord: Optional[str], report: bool) -> None:
+        """Report a leak when an owned reference is about to be overwritten."""
+        if report and self.facts(state, name) & OWNED:
+            self.report("leak", name, coord, f"'{name}' may still own a reference when it is overwritten")
+
+    def transfer_operation(self, op, state: int, report: bool) -> int:
+        """
+        Apply one operation to a state.
+
+        Args:
+            op: The IR operation
+            state: Facts before the operation
+            report: Whether to record issues (only on the final pass)
+
+        Returns:
+            Facts after the operation
+        """
+        if isinstance(op, SemanticOp):
+            attrs = op.attributes
+            kind = op.op_type
+
+            if kind == "new-ref" and attrs.get("target") in self.slot:
+                self._overwrite(state, attrs["target"], op.coord, report)
+                return self.with_facts(state, attrs["target"], OWNED | UNSHARED)
+
+            if kind == "borrow-ref" and attrs.get("dest") in self.slot:
+                self._overwrite(state, attrs["dest"], op.coord, report)
+                return self.with_facts(state, attrs["dest"], BORROWED)
+
+            if kind == "error-check" and attrs.get("source") in self.slot and attrs.get("value") == "NULL":
+                facts = self.facts(state, attrs["source"])
+                return self.with_facts(state, attrs["source"], facts | NULL) if facts else state
+
+            if kind == "incr-ref" and attrs.get("target") in self.slot:
+                facts = self.facts(state, attrs["target"])
+                return self.with_facts(state, attrs["target"], (facts & NULL) | OWNED | UNSHARED)
+
+            if kind == "decr-ref" and attrs.get("target") in self.slot:
+                name = attrs["target"]
+                facts = self.facts(state, name)
+                if report:
+                    if facts & STOLEN:
+                        self.report("use-after-steal", name, op.coord,
+                                    f"'{name}' may be decremented after its reference was stolen")
+                    elif facts & (BORROWED | RELEASED):
+                        what = "borrowed" if facts & BORROWED else "already released"
+                        self.report("over-decref", name, op.coord,
+                                    f"'{name}' may be decremented although its reference is {what}")
+                for holder in self.sharing(state, name):
+                    state = self.with_facts(state, holder, (self.facts(state, holder) & NULL) | RELEASED)
+                return state
+
+            if kind == "steal-ref" and attrs.get("target") in self.slot:
+                return self.steal(state, attrs["target"], attrs.get("func"), op.coord, report)
+
+            if kind == "parse-convert" and attrs.get("target") in self.slot:
+                # What an O& converter stores is up to the converter
+                self._overwrite(state, attrs["target"], op.coord, report)
+                return self.with_facts(state, attrs["target"], 0)
+
+            return state
+
+        if isinstance(op, Call) and op.function_name in self.summaries and id(op) not in self.annotated_calls:
+            return self.apply_summary(op, self.summaries[op.function_name], state, report)
+
+        if isinstance(op, Assign) and op.target.name in self.slot:
+            target = op.target.name
+            source = strip_casts(op.value)
+            if isinstance(source, Variable) and source.name == target:
+                return state
+            self._overwrite(state, target, op.coord, report)
+            if isinstance(source, Variable) and source.name in self.slot:
+                facts = self.facts(state, source.name)
+                if is_temporary(source.name):
+                    state = self.with_facts(state, source.name, 0)  # ownership moves out of temporaries
+                elif facts & OWNED:
+                    facts &= ~UNSHARED  # both names now hold the one reference
+                    state = self.with_facts(state, source.name, facts)
+                return self.with_facts(state, target, facts)
+            if is_null_constant(source):
+                return self.with_facts(state, target, NULL)
+            return self.with_facts(state, target, 0)
+
+        if isinstance(op, Store):
+            value = strip_casts(op.value)
+            if isinstance(value, Variable) and value.name in self.slot:
+                facts = self.facts(state, value.name)
+                if facts & OWNED:
+                    # Stored into memory we do not track: the reference escapes
+                    for holder in self.sharing(state, value.name):
+                        state = self.with_facts(state, holder, (self.facts(state, holder) & NULL) | BORROWED)
+            return state
+
+        return state
+
+    def steal(self, state: int, name: str, func_name: Optional[str], coord: Optional[str], report: bool) -> int:
+        """Hand a tracked variable's reference to a call that steals it."""
+        facts = self.facts(state, name)
+        if report:
+            if facts & STOLEN:
+                self.report("use-after-steal", name, coord,
+                            f"'{name}' may be stolen by {func_name} after its reference was already stolen")
+            if facts & BORROWED and name in self.param_index:
+                self.stolen_params.add(self.param_index[name])
+        for holder in self.sharing(state, name):
+            state = self.with_facts(state, holder, (self.facts(state, holder) & NULL) | STOLEN)
+        return state
+
+    def apply_summary(self, call: Call, summary: Dict[str, Any], state: int, report: bool) -> int:
+        """
+        Apply a callee's ownership summary to a call.
+
+        Args:
+            call: The call operation
+            summary: Semantic information of the callee
+            state: Facts before the call
+            report: Whether to record issues
+
+        Returns:
+            Facts after the call
+        """
+        for index, steals in (summary.get("arg_ref_steal") or {}).items():
+            index = int(index)
+            if steals and index < len(call.args):
+                arg = strip_casts(call.args[index])
+                if isinstance(arg, Variable) and arg.name in self.slot:
+                    state = self.steal(state, arg.name, call.function_name, call.coord, report)
+
+        dest = call.dest_var
+        if dest not in self.slot:
+            return state
+        ref_type = summary.get("return_ref_type")
+        if ref_type == "new_ref":
+            self._overwrite(state, dest, call.coord, report)
+            state = self.with_facts(state, dest, OWNED | UNSHARED)
+        elif ref_type == "borrowed_ref":
+            self._overwrite(state, dest, call.coord, report)
+            state = self.with_facts(state, dest, BORROWED)
+        if summary.get("error_return") == "NULL" and self.facts(state, dest):
+            state = self.with_facts(state, dest, self.facts(state, dest) | NULL)
+        return state
+
+    def transfer(self, block: BasicBlock, state: int, report: bool = False) -> int:
+        """
+        Apply a block's operations (and, when reporting, check its return).
+
+        Args:
+            block: The basic block
+            state: Facts on entry to the block
+            report: Whether to record issues
+
+        Returns:
+            Facts at the end of the block
+        """
+        for op in block.operations:
+            state = self.transfer_operation(op, state, report)
+
+        if report and isinstance(block.terminator, Return):
+            self.check_return(block.terminator, state)
+        return state
+
+    def check_return(self, ret: Return, state: int) -> None:
+        """Report owned references that are neither released nor returned."""
+        returned = strip_casts(ret.value)
+        returned_root = self._find(returned.name) if isinstance(returned, Variable) and returned.name in self.slot else None
+
+        if returned_root is not None:
+            facts = self.facts(state, returned.name)
+            self.return_facts |= facts
+            self.returns_null |= bool(facts & NULL)
+        elif is_null_constant(returned):
+            self.returns_null = True
+        elif isinstance(returned, Constant):
+            self.return_constants.add(str(returned.value))
+        elif isinstance(returned, UnaryOp) and returned.op == '-' and isinstance(returned.operand, Constant):
+            self.return_constants.add(f"-{returned.operand.value}")
+
+        for name in self.variables:
+            if not self.facts(state, name) & OWNED:
+                continue
+            if returned_root is not None and self._find(name) == returned_root:
+                continue
+            self.report("leak", name, ret.coord, f"'{name}' may still own a reference when the function returns")
+
+    def refine(self, condition, state: int, taken: bool) -> Optional[int]:
+        """
+        Narrow a state by the outcome of a branch condition.
+
+        Args:
+            condition: The branch condition expression
+            state: Facts before the branch
+            taken: Whether the condition is true on this edge
+
+        Returns:
+            The narrowed facts, or None if the edge cannot be taken in this state
+        """
+        condition = strip_casts(condition)
+        if isinstance(condition, UnaryOp) and condition.op == '!':
+            return self.refine(condition.operand, state, not taken)
+
+        name = None
+        is_null = None
+        if isinstance(condition, Variable):
+            name, is_null = condition.name, not taken
+        elif isinstance(condition, BinaryOp) and condition.op in ('==', '!='):
+            left, right = strip_casts(condition.left), strip_casts(condition.right)
+            if is_null_constant(right) and isinstance(left, Variable):
+                name = left.name
+            elif is_null_constant(left) and isinstance(right, Variable):
+                name = right.name
+            is_null = taken if condition.op == '==' else not taken
+
+        if name not in self.slot or not self.facts(state, name):
+            return state
+        for holder in self.sharing(state, name):
+            facts = self.facts(state, holder)
+            narrowed = facts & NULL if is_null else facts & ~NULL
+            if not narrowed:
+                return None
+            state = self.with_facts(state, holder, narrowed)
+        return state
+
+    def edge_state(self, block_id: int, succ_id: int, state: int) -> Optional[int]:
+        """Facts flowing along one CFG edge (None if the edge is infeasible)."""
+        terminator = self.cfg.blocks[block_id].terminator
+        if isinstance(terminator, BranchIf) and terminator.true_target != terminator.false_target:
+            taken = self.cfg.names[succ_id] == terminator.true_target
+            state = self.refine(terminator.condition, state, taken)
+        if state is not None and self.live_masks is not None:
+            state &= self.live_masks[succ_id]
+        return state
+
+    def solve(self) -> List[Optional[int]]:
+        """
+        Compute the facts on entry to every block.
+
+        Returns:
+            Entry state per block ID (None for blocks never reached)
+        """
+        in_states: List[Optional[int]] = [None] * len(self.cfg)
+        if not len(self.cfg):
+            return in_states
+
+        entry = self.cfg.entry
+        in_states[entry] = self.entry_state()
+        worklist = [self.cfg.rpo_index[entry]]
+        queued = {entry}
+
+        while worklist:
+            block_id = self.cfg.rpo[heapq.heappop(worklist)]
+            queued.discard(block_id)
+            self.visits += 1
+            if block_id in self.loop_deltas:
+                self.header_visits[block_id] = self.header_visits.get(block_id, 0) + 1
+            out_state = self.transfer(self.cfg.blocks[block_id], in_states[block_id])
+
+            for succ in self.cfg.succs[block_id]:
+                edge = self.edge_state(block_id, succ, out_state)
+                if edge is None:
+                    continue
+                old = in_states[succ]
+                new = edge if old is None else old | edge
+                if old is not None and new != old and self.widening_due(succ):
+                    new = self.widen(succ, old, new)
+                if new != old:
+                    in_states[succ] = new
+                    if succ not in queued:
+                        queued.add(succ)
+                        heapq.heappush(worklist, self.cfg.rpo_index[succ])
+
+        return in_states
+
+    def solve_paths(self) -> Optional[List[Dict[int, int]]]:
+        """
+        Compute the path states on entry to every block.
+
+        States are keyed by their ownership bits (or by the whole state
+        when merging is off); a state arriving under an existing key is
+        joined into it.
+
+        Returns:
+            Entry states per block ID keyed by merge key, or None if the state budget ran out
+        """
+        in_states: List[Dict[int, int]] = [{} for _ in range(len(self.cfg))]
+        if not len(self.cfg):
+            return in_states
+
+        mask = self.ownership_mask if self.merge_states else -1
+        pending: List[set] = [set() for _ in range(len(self.cfg))]
+        entry = self.cfg.entry
+        entry_state = self.entry_state()
+        in_states[entry][entry_state & mask] = entry_state
+        pending[entry].add(entry_state & mask)
+        worklist = [self.cfg.rpo_index[entry]]
+        queued = {entry}
+        self.states = 1
+
+        while worklist:
+            block_id = self.cfg.rpo[heapq.heappop(worklist)]
+            queued.discard(block_id)
+            keys, pending[block_id] = pending[block_id], set()
+
+            for key in keys:
+                self.visits += 1
+                if block_id in self.loop_deltas:
+                    self.header_visits[block_id] = self.header_visits.get(block_id, 0) + 1
+                out_state = self.transfer(self.cfg.blocks[block_id], in_states[block_id][key])
+
+                for succ in self.cfg.succs[block_id]:
+                    edge = self.edge_state(block_id, succ, out_state)
+                    if edge is None:
+                        continue
+                    succ_key = edge & mask
+                    widening = self.widening_due(succ)
+                    if widening:
+                        succ_key = -1  # a widened header keeps a single joined state
+                    old = in_states[succ].get(succ_key)
+                    new = edge if old is None else old | edge
+                    if widening and old is not None and new != old:
+                        new = self.widen(succ, old, new)
+                    if new == old:
+                        continue
+                    self.states += 1
+                    if self.states > self.state_budget:
+                        return None
+                    in_states[succ][succ_key] = new
+                    pending[succ].add(succ_key)
+                    if succ not in queued:
+                        queued.add(succ)
+                        heapq.heappush(worklist, self.cfg.rpo_index[succ])
+
+        return in_states
+
+    def check(self) -> List[RefcountIssue]:
+        """
+        Run the analysis and collect the issues.
+
+        Returns:
+            Issues in block order
+        """
+        if self.path_sensitive:
+            path_states = self.solve_paths()
+            if path_states is not None:
+                for block_id in self.cfg.rpo:
+                    for state in path_states[block_id].values():
+                        self.transfer(self.cfg.blocks[block_id], state, report=True)
+                return list(self.issues.values())
+            self.budget_exhausted = True
+
+        in_states = self.solve()
+        for block_id in self.cfg.rpo:
+            if in_states[block_id] is not None:
+                self.transfer(self.cfg.blocks[block_id], in_states[block_id], report=True)
+        return list(self.issues.values())
+
+    def summary(self) -> Optional[Dict[str, Any]]:
+        """
+        Infer the function's ownership summary from the last check().
+
+        Returns:
+            Semantic information in the semantic database format, or None if nothing was inferred
+        """
+        info: Dict[str, Any] = {}
+        if is_object_type(self.func.return_type):
+            if self.return_facts & OWNED:
+                info["return_ref_type"] = "new_ref"
+            elif self.return_facts & BORROWED:
+                info["return_ref_type"] = "borrowed_ref"
+            if self.returns_null:
+                info["error_return"] = "NULL"
+        elif self.func.return_type == "int" and "-1" in self.return_constants:
+            info["error_return"] = "-1"
+        if self.stolen_params:
+            info["arg_ref_steal"] = {str(index): True for index in sorted(self.stolen_params)}
+        return info or None
+
+
+def check_function(func: FuncDef, **options) -> List[RefcountIssue]:
+    """
+    Check one lifted function for reference counting bugs.
+
+    Args:
+        func: The lifted function
+        **options: RefcountChecker options (path_sensitive, state_budget, ...)
+
+    Returns:
+        List of issues found
+    """
+    return RefcountChecker(func, **options).check()
+
+
+def check_module(module: Module, **options) -> List[RefcountIssue]:
+    """
+    Check every function of a lifted module for reference counting bugs.
+
+    Args:
+        module: The lifted module
+        **options: RefcountChecker options (path_sensitive, state_budget, ...)
+
+    Returns:
+        List of issues found, grouped by function in module order
+    """
+    issues: List[RefcountIssue] = []
+    for func in module.functions.values():
+        issues.extend(check_function(func, **options))
+    return issues
@@ -0,0 +1,214 @@
+"""
+Refcount Result Cache for LISA-IR
+
+Checking a function that did not change against semantics that did not
+change gives the same answer, so the interprocedural driver can look up
+the results of each call graph component instead of recomputing them.
+
+A component's key is a hash of:
+
+- the IR of its functions (their ``repr``, which includes coordinates, so
+  a function that moved is checked again and reports the new lines)
+- everything the component consults about the functions it calls: the
+  summaries inferred for module functions and the semantic database
+  entries of all other callees (without their ``_version`` counter, so
+  rewriting an entry with the same semantics keeps the key)
+- the checker options and a version number bumped whenever the checker's
+  results change
+
+Changing the entry of one API therefore only changes the keys of the
+components that call it (and of their callers, whose summaries may
+change in turn). Stale entries are never invalidated explicitly; they
+stop being looked up and are evicted least recently used first.
+
+The cache lives next to the LLM response cache in ``.lisa_cache`` (or
+wherever the caller puts it) and is shared between processes the same
+way: saves merge with the file under a lock and replace it atomically.
+Hits refresh recency in memory; the file is only rewritten for them when
+a hit entry's stored recency is older than the refresh interval, so a
+warm run usually leaves the file alone while eviction still follows use.
+"""
+
+import hashlib
+import json
+import time
+from pathlib import Path
+from typing import Any, Dict, Iterable, List, Optional, Tuple
+
+from lisa_ir.analysis.refcount import RefcountIssue
+from lisa_ir.ir.ir_nodes import FuncDef, Call
+from lisa_ir.utils.file_lock import FileLock, atomic_write_json
+
+
+# Bump whenever the checker's results change so cached results are not reused
+RESULT_CACHE_VERSION = 2
+
+# Default configuration for the refcount result cache
+DEFAULT_RESULT_CACHE_PATH = Path(".lisa_cache") / "refcount_cache.json"
+DEFAULT_RESULT_CACHE_MAX_ENTRIES = 50000
+DEFAULT_RESULT_CACHE_REFRESH = 24 * 3600  # seconds before a hit's recency is written back
+
+# Per-entry version counter of semantic database entries (ignored in keys)
+VERSION_KEY = "_version"
+
+
+def function_fingerprint(func: FuncDef) -> str:
+    """Return a hex digest of a function's IR."""
+    return hashlib.sha256(repr(func).encode('utf-8')).hexdigest()
+
+
+def consulted_semantics(functions: List[FuncDef], summaries: Dict[str, Dict[str, Any]], semantic_db=None,
+                        local: Iterable[str] = ()) -> Dict[str, Any]:
+    """
+    Collect what checking a component can depend on about its callees.
+
+    Args:
+        functions: The component's functions
+        summaries: Summaries of the module functions it calls outside the component
+        semantic_db: The semantic database (None to leave API entries out)
+        local: Names of all module functions (described by summaries only)
+
+    Returns:
+        Summary or database entry (None if unknown) per callee name
+    """
+    own = {func.name for func in functions}
+    local = set(local)
+    consulted: Dict[str, Any] = {}
+    for func in functions:
+        for block in func.blocks.values():
+            for op in block.operations:
+                name = op.function_name if isinstance(op, Call) else None
+                if name is None or name in own or name in consulted:
+                    continue
+                if name in local or name in summaries:
+                    consulted[name] = summaries.get(name)
+                elif semantic_db is not None:
+                    info = semantic_db.get_function_info(name)
+                    consulted[name] = {key: value for key, value in info.items()
+                                       if key != VERSION_KEY} if isinstance(info, dict) else info
+                else:
+                    consulted[name] = None
+    return consulted
+
+
+def component_key(functions: List[FuncDef], summaries: Dict[str, Dict[str, Any]], recursive: bool,
+                  options: Optional[Dict[str, Any]] = None, semantic_db=None, local: Iterable[str] = ()) -> str:
+    """
+    Build the cache key of one call graph component.
+
+    Args:
+        functions: The component's functions
+        summaries: Summaries of the module functions it calls outside the component
+        recursive: Whether the component calls itself
+        options: RefcountChecker options
+        semantic_db: The semantic database consulted for API callees
+        local: Names of all module functions
+
+    Returns:
+        Hex digest identifying the analysis
+    """
+    material = json.dumps([
+        RESULT_CACHE_VERSION,
+        [function_fingerprint(func) for func in functions],
+        recursive,
+        consulted_semantics(functions, summaries, semantic_db, local),
+        options or {},
+    ], sort_keys=True, default=str)
+    return hashlib.sha256(material.encode('utf-8')).hexdigest()
+
+
+class RefcountResultCache:
+    """
+    Persistent cache of component results of the interprocedural refcount analysis.
+
+    Entries hold what ``analyze_component`` returns: the inferred summary
+    per function, the issues found and the functions that exhausted their
+    path state budget.
+    """
+
+    def __init__(self, cache_path: Path = DEFAULT_RESULT_CACHE_PATH,
+                 max_entries: int = DEFAULT_RESULT_CACHE_MAX_ENTRIES,
+                 refresh_interval: float = DEFAULT_RESULT_CACHE_REFRESH):
+        """
+        Initialize the cache.
+
+        Args:
+            cache_path: Path to the cache file
+            max_entries: Maximum number of entries kept (least recently used are evicted)
+            refresh_interval: Seconds after which a hit's stored recency is stale enough to save
+        """
+        self.cache_path = Path(cache_path)
+        self.max_entries = max_entries
+        self.refresh_interval = refresh_interval
+        self.entries = self._load()
+        self.dirty = False
+        self.hits = 0
+        self.misses = 0
+
+    def _load(self) -> Dict[str, Dict[str, Any]]:
+        """Load cache entries from disk, ignoring a missing or corrupt file."""
+        try:
+            with open(self.cache_path, 'r', encoding='utf-8') as f:
+                entries = json.load(f)
+            return entries if isinstance(entries, dict) else {}
+        except (IOError, json.JSONDecodeError):
+            return {}
+
+    def get(self, key: str) -> Optional[Tuple[Dict[str, Optional[Dict[str, Any]]], List[RefcountIssue], List[str]]]:
+        """
+        Look up the results of a component.
+
+        Args:
+            key: Cache key from component_key()
+
+        Returns:
+            Tuple (summary per function, issues, budget-exhausted functions), or None on a miss
+        """
+        entry = self.entries.get(key)
+        if entry is None:
+            self.misses += 1
+            return None
+        now = time.time()
+        if now - entry.get("accessed", 0) > self.refresh_interval:
+            self.dirty = True
+        entry["accessed"] = now
+        self.hits += 1
+        return (dict(entry["inferred"]), [RefcountIssue(**issue) for issue in entry["issues"]],
+                list(entry["exhausted"]))
+
+    def put(self, key: str, result: Tuple[Dict[str, Optional[Dict[str, Any]]], List[RefcountIssue], List[str]]) -> None:
+        """
+        Store the results of a component.
+
+        Args:
+            key: Cache key from component_key()
+            result: What analyze_component returned
+        """
+        inferred, issues, exhausted = result
+        now = time.time()
+        self.entries[key] = {"inferred": inferred, "issues": [issue.to_dict() for issue in issues],
+                             "exhausted": list(exhausted), "created": now, "accessed": now}
+        self.dirty = True
+
+    def save(self) -> None:
+        """Merge with the on-disk cache, apply the size limit and write it back if anything changed."""
+        if not self.dirty:
+            return
+
+        with FileLock(self.cache_path):
+            merged = self._load()
+            for key, entry in self.entries.items():
+                current = merged.get(key)
+                if current is None:
+                    merged[key] = entry
+                else:
+                    current["accessed"] = max(current.get("accessed", 0), entry.get("accessed", 0))
+
+            if len(merged) > self.max_entries:
+                newest = sorted(merged.items(), key=lambda kv: kv[1].get("accessed", 0), reverse=True)
+                merged = dict(newest[:self.max_entries])
+
+            atomic_write_json(self.cache_path, merged, indent=None)
+
+        self.entries = merged
+        self.dirty = False
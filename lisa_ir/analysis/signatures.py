@@ -0,0 +1,150 @@
+"""
+Method Signature Checker for LISA-IR
+
+This module compares the C functions registered in a module's
+``PyMethodDef`` tables (from ``Module.metadata``) with the signature their
+``METH_*`` calling convention requires. CPython casts every method to
+``PyCFunction`` and calls it with the convention's arguments, so a
+function registered with the wrong flags reads garbage instead of its
+parameters, which the compiler cannot catch through the cast.
+"""
+
+from dataclasses import dataclass, asdict
+from typing import Dict, List, Optional, Any, Tuple
+
+from lisa_ir.ir.ir_nodes import FuncDef, Module
+from lisa_ir.parsers.method_tables import METH_FLAGS, flag_names
+
+
+# Flags that select the calling convention (the rest only modify binding)
+_CONVENTION_MASK = (METH_FLAGS['METH_VARARGS'] | METH_FLAGS['METH_KEYWORDS'] | METH_FLAGS['METH_NOARGS']
+                    | METH_FLAGS['METH_O'] | METH_FLAGS['METH_FASTCALL'] | METH_FLAGS['METH_METHOD'])
+
+
+def _flags(*names: str) -> int:
+    result = 0
+    for name in names:
+        result |= METH_FLAGS[name]
+    return result
+
+
+# Parameter kinds each calling convention passes, after self
+CALLING_CONVENTIONS: Dict[int, List[str]] = {
+    _flags('METH_VARARGS'): ['object'],
+    _flags('METH_VARARGS', 'METH_KEYWORDS'): ['object', 'object'],
+    _flags('METH_NOARGS'): ['object'],
+    _flags('METH_O'): ['object'],
+    _flags('METH_FASTCALL'): ['object_array', 'size'],
+    _flags('METH_FASTCALL', 'METH_KEYWORDS'): ['object_array', 'size', 'object'],
+    _flags('METH_METHOD', 'METH_FASTCALL', 'METH_KEYWORDS'): ['type', 'object_array', 'size', 'object'],
+}
+
+_KIND_DESCRIPTIONS = {
+    'self': 'an object pointer (self)',
+    'object': 'PyObject *',
+    'object_array': 'PyObject *const *',
+    'size': 'Py_ssize_t',
+    'type': 'PyTypeObject *',
+}
+
+
+# Base types that can never hold an object pointer
+_SCALAR_WORDS = {'void', 'char', 'short', 'int', 'long', 'float', 'double', 'signed', 'unsigned', '_Bool'}
+
+
+def matches_kind(param_type: str, kind: str) -> bool:
+    """
+    Return whether a parameter type can receive an argument of a convention kind.
+
+    Object pointers of any struct type are accepted, since extensions
+    commonly declare ``self`` or arguments with their own object types;
+    array parameters count as pointers.
+    """
+    pointers = param_type.count('*') + param_type.count('[')
+    base_words = set(param_type.replace('*', ' ').replace('[', ' ').replace(']', ' ').split()) - {'const', 'volatile'}
+    is_scalar = bool(base_words & _SCALAR_WORDS)
+    if kind in ('self', 'object', 'type'):
+        return pointers == 1 and not is_scalar
+    if kind == 'object_array':
+        return pointers == 2 and not is_scalar
+    return pointers == 0
+
+
+@dataclass
+class SignatureIssue:
+    """A method registered with flags its C signature does not match."""
+    kind: str
+    function: str
+    python_name: str
+    coord: Optional[str]
+    message: str
+
+    def to_dict(self) -> Dict[str, Any]:
+        return asdict(self)
+
+    def __str__(self) -> str:
+        return f"{self.coord or self.function}: {self.kind}: {self.message}"
+
+
+def check_signature(func: FuncDef, flags: int) -> Optional[str]:
+    """
+    Check one function against a METH_* flag word.
+
+    Args:
+        func: The registered function
+        flags: Its ml_flags
+
+    Returns:
+        Description of the mismatch, or None if the signature fits
+    """
+    convention = flags & _CONVENTION_MASK
+    spelled = '|'.join(flag_names(convention)) or '0'
+    if convention not in CALLING_CONVENTIONS:
+        return f"{spelled} is not a valid calling convention"
+
+    kinds = ['self'] + CALLING_CONVENTIONS[convention]
+    params = [p.param_type for p in func.params]
+    if convention == METH_FLAGS['METH_NOARGS'] and len(params) == 1:
+        kinds = kinds[:1]  # the ignored argument is often left out
+
+    if len(params) != len(kinds):
+        expected = ', '.join(_KIND_DESCRIPTIONS[k] for k in kinds)
+        return (f"{func.name} takes {len(params)} parameter(s) but {spelled} passes {len(kinds)} "
+                f"({expected})")
+    for position, (param_type, kind) in enumerate(zip(params, kinds)):
+        if not matches_kind(param_type, kind):
+            return (f"parameter {position} of {func.name} is '{param_type}' but {spelled} passes "
+                    f"{_KIND_DESCRIPTIONS[kind]}")
+    if func.return_type is not None and not matches_kind(func.return_type, 'object'):
+        return f"{func.name} returns '{func.return_type}' but methods must return PyObject *"
+    return None
+
+
+def check_method_signatures(module: Module) -> List[SignatureIssue]:
+    """
+    Check every method table entry of a module whose function is defined in it.
+
+    Args:
+        module: The lifted module (with method table metadata)
+
+    Returns:
+        List of mismatches, in table order
+    """
+    issues: List[SignatureIssue] = []
+    seen = set()
+    for table, entries in module.metadata.get("method_tables", {}).items():
+        for entry in entries:
+            func = module.functions.get(entry.get("c_function"))
+            flags = entry.get("flags")
+            if func is None or flags is None:
+                continue
+            key: Tuple[str, int] = (func.name, flags)
+            if key in seen:
+                continue
+            seen.add(key)
+            problem = check_signature(func, flags)
+            if problem:
+                issues.append(SignatureIssue(kind="signature-mismatch", function=func.name,
+                                             python_name=entry["python_name"], coord=func.coord,
+                                             message=f"{table}[\"{entry['python_name']}\"]: {problem}"))
+    return issues
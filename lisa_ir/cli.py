@@ -4,6 +4,7 @@ Command Line Interface for LISA-IR
 """
 
 import argparse
+import copy
 import json
 import sys
 from pathlib import Path
@@ -18,7 +19,8 @@ def main():
     )
     parser.add_argument(
         "input_file",
-        help="Input C source file to lift"
+        nargs="?",
+        help="Input C source file to lift (not needed with --query-callers or --recheck)"
     )
     parser.add_argument(
         "-o", "--output",
@@ -36,6 +38,107 @@ def main():
         help="Path to semantic database file",
         default=None
     )
+    parser.add_argument(
+        "--ai-hints",
+        action="store_true",
+        help="Extract semantic hints from comments with the LLM auxiliary layer and commit them to the semantic database"
+    )
+    parser.add_argument(
+        "--llm-endpoint",
+        help="LLM API endpoint for --ai-hints (default: the auxiliary layer's)",
+        default=None
+    )
+    parser.add_argument(
+        "--llm-batch-size",
+        type=int,
+        help="Maximum functions per LLM request for --ai-hints",
+        default=None
+    )
+    parser.add_argument(
+        "--llm-cache",
+        metavar="PATH",
+        help="LLM response cache file for --ai-hints (default: .lisa_cache/llm_cache.json)",
+        default=None
+    )
+    parser.add_argument(
+        "--no-llm-cache",
+        action="store_true",
+        help="Ignore and do not update the LLM response cache in --ai-hints"
+    )
+    parser.add_argument(
+        "--check-refcounts",
+        action="store_true",
+        help="Check the lifted functions for reference counting bugs and report them to stderr; "
+             "inferred ownership summaries of the module's functions are stored in the semantic database"
+    )
+    parser.add_argument(
+        "--path-sensitive",
+        action="store_true",
+        help="Keep separate refcount states per error path in --check-refcounts"
+    )
+    parser.add_argument(
+        "--state-budget",
+        type=int,
+        help="Path states per function before --path-sensitive falls back to the path-insensitive result",
+        default=None
+    )
+    parser.add_argument(
+        "--reachable-only",
+        action="store_true",
+        help="Skip static functions no method table entry or module initializer can reach in --check-refcounts"
+    )
+    parser.add_argument(
+        "--no-result-cache",
+        action="store_true",
+        help="Do not reuse or store --check-refcounts and --recheck results in the result cache"
+    )
+    parser.add_argument(
+        "--result-cache",
+        metavar="PATH",
+        help="Result cache file for --check-refcounts and --recheck (default: .lisa_cache/refcount_cache.json "
+             "next to the --output file, or in the current directory)",
+        default=None
+    )
+    parser.add_argument(
+        "--check-signatures",
+        action="store_true",
+        help="Report PyMethodDef entries whose METH_* flags do not match the C signature to stderr"
+    )
+    parser.add_argument(
+        "--call-index",
+        help="Path to the call site index; every lifted file's calls are recorded in it",
+        default=None
+    )
+    parser.add_argument(
+        "--query-callers",
+        metavar="FUNCTION",
+        help="Print the indexed call sites of a function and exit (requires --call-index)",
+        default=None
+    )
+    parser.add_argument(
+        "--recheck",
+        metavar="API[,API...]",
+        help="Re-lift only the indexed files calling these APIs and check the calling functions' "
+             "reference counts, e.g. after their semantic entries changed (requires --call-index)",
+        default=None
+    )
+    parser.add_argument(
+        "--passes",
+        help="Comma-separated IR passes to run on every function before output, e.g. 'ssa' "
+             "(per-pass timing is printed with --verbose; the checkers still see the untransformed IR)",
+        default=None
+    )
+    parser.add_argument(
+        "-j", "--jobs",
+        type=int,
+        help="Worker processes for --check-refcounts and --passes (default: CPU count)",
+        default=None
+    )
+    parser.add_argument(
+        "--stats",
+        action="store_true",
+        help="Print lifting statistics to stderr"
+    )
     parser.add_argument(
         "-v", "--verbose",
         action="store_true",
@@ -43,14 +146,65 @@ def main():
     )
     
     args = parser.parse_args()
+    if (args.query_callers or args.recheck) and not args.call_index:
+        parser.error("--query-callers and --recheck require --call-index")
+    if not (args.input_file or args.query_callers or args.recheck):
+        parser.error("an input file is required")
     
     try:
+        if args.query_callers:
+            from lisa_ir.database.call_index import CallSiteIndex
+            for site in CallSiteIndex(args.call_index).callers(args.query_callers):
+                print(site)
+            return
+        
+
         # Initialize the lifter
-        lifter = Lifter(semantic_db_path=args.semantic_db, verbose=args.verbose)
+        ai_options = {}
+        if args.llm_endpoint:
+            ai_options["llm_endpoint"] = args.llm_endpoint
+        if args.llm_batch_size:
+            ai_options["batch_size"] = args.llm_batch_size
+        if args.no_llm_cache:
+            ai_options["use_cache"] = False
+        elif args.llm_cache:
+            from lisa_ir.core.auxiliary_layer import LLMResponseCache
+            ai_options["cache"] = LLMResponseCache(args.llm_cache)
+        lifter = Lifter(semantic_db_path=args.semantic_db, verbose=args.verbose,
+                        ai_hints=args.ai_hints, ai_options=ai_options, call_index_path=args.call_index)
+        
+        result_cache = None
+        if (args.check_refcounts or args.recheck) and not args.no_result_cache:
+            from lisa_ir.analysis.result_cache import DEFAULT_RESULT_CACHE_PATH, RefcountResultCache
+            cache_path = args.result_cache
+            if cache_path is None and args.output:
+                cache_path = Path(args.output).parent / DEFAULT_RESULT_CACHE_PATH
+            result_cache = RefcountResultCache(cache_path or DEFAULT_RESULT_CACHE_PATH)
+        
+        if args.recheck:
+            from lisa_ir.database.call_index import recheck_callers
+            apis = [name.strip() for name in args.recheck.split(",") if name.strip()]
+            results = recheck_callers(lifter.call_index, apis, lifter, max_workers=args.jobs, cache=result_cache,
+                                      path_sensitive=args.path_sensitive,
+                                      **({"state_budget": args.state_budget} if args.state_budget else {}))
+            for file_path, result in results.items():
+                for issue in result.issues:
+                    print(issue, file=sys.stderr)
+            print(f"Re-checked {len(results)} file(s) calling {', '.join(apis)}", file=sys.stderr)
+            return
         
         # Lift the input file
         ir_module = lifter.lift_file(args.input_file)
         
+        # The checkers expect the IR as lifted (no phis), so the passes transform a copy for the output
+        checked_module = ir_module
+        if args.passes:
+            from lisa_ir.transforms.pass_manager import PassManager
+            passes = [name.strip() for name in args.passes.split(",") if name.strip()]
+            if args.check_refcounts or args.check_signatures:
+                ir_module = copy.deepcopy(ir_module)
+            PassManager(passes, max_workers=args.jobs, verbose=args.verbose).run(ir_module)
+        
         # Serialize the IR
         if args.format == "json":
             output = ir_module.to_dict()
@@ -59,6 +213,24 @@ def main():
             from lisa_ir.ir.ir_nodes import serialize_to_sexp
             output_str = serialize_to_sexp(ir_module)
         
+        if args.stats:
+            print(json.dumps(lifter.get_stats(), indent=2), file=sys.stderr)
+        
+        if args.check_refcounts:
+            from lisa_ir.analysis.interprocedural import analyze_module
+            options = {"path_sensitive": args.path_sensitive}
+            if args.state_budget:
+                options["state_budget"] = args.state_budget
+            result = analyze_module(checked_module, lifter.semantic_db, max_workers=args.jobs,
+                                    reachable_only=args.reachable_only, cache=result_cache, **options)
+            for issue in result.issues:
+                print(issue, file=sys.stderr)
+        
+        if args.check_signatures:
+            from lisa_ir.analysis.signatures import check_method_signatures
+            for issue in check_method_signatures(checked_module):
+                print(issue, file=sys.stderr)
+        
         # Output the result
         if args.output:
             with open(args.output, 'w', encoding='utf-8') as f:
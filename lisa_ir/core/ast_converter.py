@@ -2,328 +2,904 @@
 AST to LISA IR Converter
 
 This module converts pycparser AST nodes to LISA IR nodes with semantic preservation.
+
+Function bodies are lowered to a control flow graph: ``if``/``for``/``while``/
+``do``/``switch`` statements, labels and short-circuit conditions become basic
+blocks (a ``switch`` ends in a ``Switch`` terminator, ``goto`` in a jump), every call
+result is held in a ``call_result_N`` temporary, and calls with known semantics
+are followed by semantic operations:
+
+    new-ref      {target}                   the call returned a new reference
+    borrow-ref   {dest, source, func}       the call returned a borrowed reference
+    steal-ref    {target, func, arg_index}  the call stole a reference to an argument
+    incr-ref     {target}                   Py_INCREF / Py_XINCREF
+    decr-ref     {target, nullable}         Py_DECREF / Py_XDECREF
+    error-check  {source, value}            the call signals failure by returning value
+
+Calls taking a format string (``PyArg_ParseTuple`` and friends,
+``Py_BuildValue``) additionally get one operation per variadic argument
+the format describes. Parse outputs are emitted on the success path only;
+``N`` arguments are stolen whether or not the call succeeds:
+
+    borrow-ref     {dest, source, func, type, format}  an object output pointer (O, O!, S, U, Y)
+    parse-convert  {target, converter, func}           an O& target filled in by a converter
+    parse-assign   {target, c_type, format, func}      a C value output pointer
+    steal-ref      {target, func, arg_index}           an N argument of Py_BuildValue
+
+A call that can fail ends its block with a branch on the error value to
+``{Api}_fail_N`` and ``{Api}_success_N``. The failure block only records the
+error edge and jumps on; what happens next is decided by the source's own checks.
 """
 
 import logging
-from typing import Dict, List, Optional, Any, Union
-from pycparser import c_ast
+from typing import Callable, Dict, List, Optional, Any, Set, Union
+from pycparser import c_ast, c_generator
 
 from lisa_ir.ir.ir_nodes import (
     Module, FuncDef, BasicBlock, Operation, Expression,
     Param, Assign, Call, Return, Variable, Constant,
     BinaryOp, UnaryOp, FunctionCall, Cast, ArrayRef, StructRef,
-    Load, Store, BranchIf, Jump, Switch, Unreachable,
+    Load, Store, BranchIf, Jump, Switch, Unreachable, Dereference, AddressOf,
     make_coord, make_constant_int, make_constant_string, make_variable,
-    make_binary_op, make_assign, make_call, make_return, make_jump, make_branch_if
+    make_binary_op, make_assign, make_call, make_return, make_jump, make_branch_if,
+    make_semantic_op
 )
+from lisa_ir.core.lookup_cache import SemanticLookupCache
+from lisa_ir.database.semantic_db import INFERRED_SOURCE
+from lisa_ir.parsers.format_strings import FORMAT_FUNCTIONS, decode_format, literal_format
+from lisa_ir.parsers.method_tables import extract_method_tables, extract_module_defs
+
+
+# Reference counting macros lowered to incr-ref / decr-ref operations
+REFCOUNT_MACROS = {
+    "Py_INCREF": ("incr-ref", False),
+    "Py_XINCREF": ("incr-ref", True),
+    "Py_DECREF": ("decr-ref", False),
+    "Py_XDECREF": ("decr-ref", True),
+}
+
+# Prefixes of the temporaries the converter introduces
+CALL_RESULT_PREFIX = "call_result_"
+TEMP_PREFIX = "temp_"
+
+
+def is_temporary(name: str) -> bool:
+    """Return whether a variable name is a converter-generated temporary."""
+    return name.startswith(CALL_RESULT_PREFIX) or name.startswith(TEMP_PREFIX)
+
+
+class _CallCollector(c_ast.NodeVisitor):
+    """Collects the names of directly called functions."""
+
+    def __init__(self):
+        self.names: Set[str] = set()
+
+    def visit_FuncCall(self, node: c_ast.FuncCall):
+        if isinstance(node.name, c_ast.ID):
+            self.names.add(node.name.name)
+        self.generic_visit(node)
+
+
+def contains_label(node: c_ast.Node) -> bool:
+    """Return whether a statement is or contains a label, i.e. can be entered by a goto."""
+    if isinstance(node, c_ast.Label):
+        return True
+    return any(contains_label(child) for _, child in node.children())
+
+
+def called_functions(node: c_ast.Node) -> Set[str]:
+    """
+    Return the names of the functions called directly within an AST node.
+
+    Args:
+        node: Any pycparser node, typically a FuncDef
+
+    Returns:
+        Set of callee names
+    """
+    collector = _CallCollector()
+    collector.visit(node)
+    return collector.names
 
 
 class ASTConverter:
     """
     Converts pycparser AST to LISA IR with semantic preservation.
-    
+
     This class handles the complex mapping from C AST nodes to LISA IR nodes,
     including variable scoping, control flow, and semantic information integration.
     """
-    
+
     def __init__(self, semantic_db):
         """
         Initialize the converter.
-        
+
         Args:
             semantic_db: Semantic database for reference counting and API semantics
         """
         self.semantic_db = semantic_db
+        self.lookup_cache = SemanticLookupCache(semantic_db)
         self.logger = logging.getLogger(__name__)
+        self.generator = c_generator.CGenerator()
         self.current_scope = {}
         self.temp_var_counter = 0
-        
-    def convert_ast(self, ast: c_ast.FileAST, source_path: str) -> Module:
+        self.block_counter = 0
+        self.return_types: Dict[str, str] = {}
+        self.defined_functions: Set[str] = set()
+        self.current_function: Optional[FuncDef] = None
+        self.current_block: Optional[BasicBlock] = None
+        self.loop_stack: List[tuple] = []  # (continue_target, break_target)
+        self.labels: Dict[str, BasicBlock] = {}
+
+    def convert_ast(self, ast: c_ast.FileAST, source_path: str,
+                    defer: Optional[Set[str]] = None,
+                    before_deferred: Optional[Callable[[], None]] = None) -> Module:
         """
         Convert a pycparser FileAST to a LISA IR Module.
-        
+
+        Functions calling any name in ``defer`` are converted last, after
+        ``before_deferred`` has run, so semantic information that is still
+        being produced (e.g. by the AI hints stage) can be committed to the
+        database first. Functions still appear in source order.
+
         Args:
             ast: The pycparser FileAST
             source_path: Source file path for coordinate tracking
-            
+            defer: Callee names whose semantics are not available yet
+            before_deferred: Called once before the deferred functions are converted
+
         Returns:
             Module: The converted LISA IR module
         """
         self.logger.info("Converting AST to LISA IR")
-        
+        self.lookup_cache.reset()
+        self.return_types = self.collect_return_types(ast)
+
         # Create the module
         module_name = source_path.replace('/', '_').replace('\\', '_').replace('.', '_')
         module = Module(name=module_name, coord=make_coord(source_path, 1, 1))
-        
+
+        func_defs = [ext_decl for ext_decl in ast.ext if isinstance(ext_decl, c_ast.FuncDef)]
+        self.defined_functions = {func_def.decl.name for func_def in func_defs}
+        deferred = [f for f in func_defs if defer and called_functions(f) & defer]
+        deferred_ids = {id(f) for f in deferred}
+        converted = {}
+
+        for func_def in func_defs:
+            if id(func_def) not in deferred_ids:
+                converted[id(func_def)] = self.convert_function(func_def, source_path)
+
+        if before_deferred is not None:
+            before_deferred()
+        if deferred:
+            self.logger.debug(f"Converting {len(deferred)} functions that waited for semantic information")
+            self.lookup_cache.refresh()
+            for func_def in deferred:
+                converted[id(func_def)] = self.convert_function(func_def, source_path)
+
         # Process all top-level declarations
         for ext_decl in ast.ext:
             if isinstance(ext_decl, c_ast.FuncDef):
-                func_def = self.convert_function(ext_decl, source_path)
-                module.add_function(func_def)
+                module.add_function(converted[id(ext_decl)])
             elif isinstance(ext_decl, c_ast.Decl) and isinstance(ext_decl.type, c_ast.FuncDecl):
                 # Function declaration
                 pass  # For now, we only handle function definitions
             elif isinstance(ext_decl, c_ast.Decl):
                 # Global variable declaration
                 pass  # For now, we don't handle global variables
-        
+
+        self.collect_entry_points(ast, module, func_defs)
+
+        stats = self.lookup_cache.get_stats()
+        self.logger.debug(f"Semantic lookups: {stats['lookups']} total, {stats['memo_hits']} memoized, "
+                          f"{stats['bloom_negatives']} filtered, {stats['db_hits']} DB hits, "
+                          f"{stats['db_misses']} DB misses")
         return module
-    
+
+    def collect_entry_points(self, ast: c_ast.FileAST, module: Module, func_defs: List[c_ast.FuncDef]) -> None:
+        """
+        Record the module's method tables, module definitions and entry points in its metadata.
+
+        Entry points are the C functions registered in a PyMethodDef table
+        plus the PyInit_* module initializers; static functions are listed
+        so analyses can tell helpers nothing outside the file can call.
+
+        Args:
+            ast: The pycparser FileAST
+            module: The module being built
+            func_defs: The function definitions of the file
+        """
+        method_tables = extract_method_tables(ast)
+        entry_points = [name for entries in method_tables.values() for entry in entries
+                        for name in [entry["c_function"]] if name]
+        entry_points += [f.decl.name for f in func_defs if f.decl.name.startswith("PyInit_")]
+
+        module.metadata["method_tables"] = method_tables
+        module.metadata["module_defs"] = extract_module_defs(ast)
+        module.metadata["entry_points"] = list(dict.fromkeys(entry_points))
+        module.metadata["static_functions"] = [f.decl.name for f in func_defs if 'static' in (f.decl.storage or [])]
+
+    def collect_return_types(self, ast: c_ast.FileAST) -> Dict[str, str]:
+        """
+        Map every declared or defined function to its return type.
+
+        Args:
+            ast: The pycparser FileAST (headers included)
+
+        Returns:
+            Dictionary mapping function names to C return type strings
+        """
+        return_types = {}
+        for ext_decl in ast.ext:
+            decl = ext_decl.decl if isinstance(ext_decl, c_ast.FuncDef) else ext_decl
+            if isinstance(decl, c_ast.Decl) and isinstance(decl.type, c_ast.FuncDecl) and decl.name:
+                return_types[decl.name] = self.type_string(decl.type.type)
+        return return_types
+
+    def type_string(self, type_node: c_ast.Node) -> str:
+        """
+        Render a declaration type as C source, without the declared name.
+
+        Args:
+            type_node: A pycparser type node (TypeDecl, PtrDecl, ArrayDecl, ...)
+
+        Returns:
+            str: The type, e.g. ``PyObject *``
+        """
+        return self.generator._generate_type(type_node, emit_declname=False).strip()
+
+    def make_node_coord(self, node: Optional[c_ast.Node], source_path: str) -> Optional[str]:
+        """Build an IR coordinate for an AST node, or None if it has no position."""
+        if node is None or not node.coord:
+            return None
+        return make_coord(source_path, node.coord.line or 1, node.coord.column or 1)
+
+    def new_block(self, kind: str, coord: Optional[str] = None) -> BasicBlock:
+        """
+        Create and register a basic block named ``{kind}_{N}`` in the current function.
+
+        Args:
+            kind: Block role, e.g. ``if_then`` or ``PyList_New_success``
+            coord: Source coordinate of the construct that created the block
+
+        Returns:
+            BasicBlock: The new, empty block
+        """
+        block = BasicBlock(name=f"{kind}_{self.block_counter}", coord=coord)
+        self.block_counter += 1
+        self.current_function.add_block(block)
+        return block
+
+    def new_temp(self, prefix: str, var_type: Optional[str] = None) -> str:
+        """Create a fresh temporary variable and declare it in the current function."""
+        name = f"{prefix}{self.temp_var_counter}"
+        self.temp_var_counter += 1
+        if var_type:
+            self.current_function.add_local_var(name, var_type)
+        return name
+
+    def emit(self, operation: Operation) -> None:
+        """Append an operation to the current block."""
+        self.current_block.add_operation(operation)
+
+    def terminate(self, terminator) -> None:
+        """Terminate the current block unless control already left it."""
+        if self.current_block.terminator is None:
+            self.current_block.set_terminator(terminator)
+
     def convert_function(self, func_def: c_ast.FuncDef, source_path: str) -> FuncDef:
         """
         Convert a pycparser FuncDef to a LISA IR FuncDef.
-        
+
         Args:
             func_def: The pycparser function definition
             source_path: Source file path for coordinate tracking
-            
+
         Returns:
             FuncDef: The converted LISA IR function definition
         """
         # Extract function name
         func_name = func_def.decl.name
-        
+
         # Extract parameters
         params = []
         if func_def.decl.type.args:
             for param in func_def.decl.type.args.params:
                 if hasattr(param, 'name') and param.name:
-                    param_name = param.name
-                    param_type = str(param.type)
-                    coord = make_coord(source_path, param.coord.line if param.coord else 1, 
-                                      param.coord.column if param.coord else 1) if param.coord else None
-                    params.append(Param(name=param_name, param_type=param_type, coord=coord))
-        
+                    params.append(Param(name=param.name, param_type=self.type_string(param.type),
+                                        coord=self.make_node_coord(param, source_path)))
+
         # Create the function definition
         lisa_func = FuncDef(
             name=func_name,
             params=params,
-            coord=make_coord(source_path, func_def.coord.line if func_def.coord else 1, 
-                           func_def.coord.column if func_def.coord else 1) if func_def.coord else None
+            entry_point="entry_0",
+            return_type=self.return_types.get(func_name),
+            coord=self.make_node_coord(func_def, source_path)
         )
-        
+
         # Initialize scope with parameters
         self.current_scope = {p.name: p.param_type for p in params}
-        
+        self.current_function = lisa_func
+        self.temp_var_counter = 0
+        self.block_counter = 0
+        self.loop_stack = []
+        self.labels = {}
+
         # Create entry block
-        entry_block = BasicBlock(name="entry", coord=make_coord(source_path, func_def.coord.line if func_def.coord else 1, 1) if func_def.coord else None)
-        
+        coord = make_coord(source_path, func_def.coord.line, 1) if func_def.coord else None
+        self.current_block = self.new_block("entry", coord)
+
         # Convert the function body
         if hasattr(func_def, 'body') and func_def.body:
-            self.convert_block(func_def.body, entry_block, source_path)
-        
-        lisa_func.add_block(entry_block)
-        
+            self.convert_block(func_def.body, self.current_block, source_path)
+
+        # Falling off the end returns nothing
+        self.terminate(make_return(None, self.make_node_coord(func_def, source_path)))
+        for label, block in self.labels.items():
+            if block.terminator is None:
+                self.logger.warning(f"{func_name}: goto to undefined label {label}")
+                block.set_terminator(Unreachable(coord=block.coord))
+
+        self.current_function = None
+        self.current_block = None
         return lisa_func
-    
-    def convert_block(self, block: c_ast.Compound, lisa_block: BasicBlock, source_path: str):
+
+    def convert_block(self, block: c_ast.Compound, lisa_block: BasicBlock, source_path: str) -> BasicBlock:
         """
-        Convert a C compound statement (block) to LISA IR operations in the given basic block.
-        
+        Convert a C compound statement (block) starting in the given basic block.
+
         Args:
             block: The pycparser compound statement (equivalent to a block)
-            lisa_block: The target LISA IR basic block
+            lisa_block: The LISA IR basic block control enters the statement in
             source_path: Source file path for coordinate tracking
+
+        Returns:
+            BasicBlock: The block control leaves the statement from
         """
+        self.current_block = lisa_block
         if not hasattr(block, 'block_items') or not block.block_items:
-            return
-            
-        for stmt in block.block_items:
-            if isinstance(stmt, c_ast.Decl):
-                # Handle variable declarations
-                if stmt.init:  # If the declaration has an initializer
+            return self.current_block
+
+        self.convert_statements(block.block_items, source_path)
+        return self.current_block
+
+    def convert_statements(self, statements: List[c_ast.Node], source_path: str) -> None:
+        """
+        Convert a statement list in the current block.
+
+        After control left (return/break/continue/goto) the statements are
+        unreachable and skipped, except those a goto can enter through a label.
+
+        Args:
+            statements: The pycparser statements
+            source_path: Source file path for coordinate tracking
+        """
+        for stmt in statements:
+            if self.current_block.terminator is not None:
+                if not contains_label(stmt):
+                    self.logger.debug(f"Skipping unreachable statement at {stmt.coord}")
+                    continue
+                if not isinstance(stmt, c_ast.Label):
+                    self.current_block = self.new_block("unreachable", self.make_node_coord(stmt, source_path))
+            self.convert_statement(stmt, source_path)
+
+    def convert_statement(self, stmt: c_ast.Node, source_path: str) -> None:
+        """
+        Lower one statement into the current block, creating blocks as needed.
+
+        Args:
+            stmt: The pycparser statement
+            source_path: Source file path for coordinate tracking
+        """
+        coord = self.make_node_coord(stmt, source_path)
+
+        if isinstance(stmt, c_ast.Decl):
+            # Handle variable declarations
+            if not isinstance(stmt.type, c_ast.FuncDecl) and stmt.name:
+                var_type = self.type_string(stmt.type)
+                self.current_function.add_local_var(stmt.name, var_type)
+                self.current_scope[stmt.name] = var_type
+                if stmt.init is not None and not isinstance(stmt.init, c_ast.InitList):
                     # Create assignment: var = initializer
-                    coord = make_coord(source_path, stmt.coord.line if stmt.coord else 1,
-                                     stmt.coord.column if stmt.coord else 1) if stmt.coord else None
-                    target_var = make_variable(stmt.name)
                     value_expr = self.convert_expr(stmt.init, source_path)
-                    assign_op = make_assign(stmt.name, value_expr, coord)
-                    lisa_block.add_operation(assign_op)
-                    
-                    # Add to scope
-                    self.current_scope[stmt.name] = str(stmt.type)
-            elif isinstance(stmt, c_ast.Assignment):
-                # Handle assignment statements
-                coord = make_coord(source_path, stmt.coord.line if stmt.coord else 1,
-                                 stmt.coord.column if stmt.coord else 1) if stmt.coord else None
-                target = self.convert_expr(stmt.lvalue, source_path)
-                value = self.convert_expr(stmt.rvalue, source_path)
-                
-                # For now, we assume simple variable assignments
-                if isinstance(target, Variable):
-                    assign_op = make_assign(target.name, value, coord)
-                    lisa_block.add_operation(assign_op)
-            elif isinstance(stmt, c_ast.FuncCall):
-                # Handle function calls
-                coord = make_coord(source_path, stmt.coord.line if stmt.coord else 1,
-                                 stmt.coord.column if stmt.coord else 1) if stmt.coord else None
-                func_name = self.extract_func_name(stmt.name)
-                
-                # Convert arguments
-                args = []
-                if stmt.args:
-                    for arg in stmt.args.exprs:
-                        args.append(self.convert_expr(arg, source_path))
-                
-                # Check if this is a Python/C API function that needs special handling
-                semantic_info = self.semantic_db.get_function_info(func_name)
-                
-                call_op = make_call(None, func_name, args, coord)
-                lisa_block.add_operation(call_op)
-            elif isinstance(stmt, c_ast.Return):
-                # Handle return statements
-                coord = make_coord(source_path, stmt.coord.line if stmt.coord else 1,
-                                 stmt.coord.column if stmt.coord else 1) if stmt.coord else None
-                if stmt.expr:
-                    value = self.convert_expr(stmt.expr, source_path)
-                else:
-                    value = None
-                return_op = make_return(value, coord)
-                lisa_block.set_terminator(return_op)
-            elif isinstance(stmt, c_ast.If):
-                # Handle if statements - this creates multiple basic blocks
-                # For now, just add a placeholder to avoid terminator conflicts
-                self.logger.warning("If statements require complex control flow handling, adding placeholder")
-                # This is a simplified implementation that doesn't create multiple blocks
-                # In a full implementation, we would need to create proper control flow
-                pass
-            elif isinstance(stmt, c_ast.For):
-                # Handle for loops - add placeholder
-                self.logger.warning("For loops require complex control flow handling, adding placeholder")
-                pass
-            elif isinstance(stmt, c_ast.While):
-                # Handle while loops - add placeholder
-                self.logger.warning("While loops require complex control flow handling, adding placeholder")
+                    self.emit(make_assign(stmt.name, value_expr, coord))
+        elif isinstance(stmt, c_ast.DeclList):
+            for decl in stmt.decls:
+                self.convert_statement(decl, source_path)
+        elif isinstance(stmt, c_ast.Assignment):
+            self.convert_assignment(stmt, source_path)
+        elif isinstance(stmt, c_ast.FuncCall):
+            self.convert_call(stmt, source_path)
+        elif isinstance(stmt, c_ast.UnaryOp) and stmt.op in ('p++', 'p--', '++', '--'):
+            target = self.convert_expr(stmt.expr, source_path)
+            value = make_binary_op('+' if '++' in stmt.op else '-', target, make_constant_int(1))
+            self.store(target, value, coord)
+        elif isinstance(stmt, c_ast.ExprList):
+            for expr in stmt.exprs:
+                self.convert_statement(expr, source_path)
+        elif isinstance(stmt, c_ast.Return):
+            value = self.convert_expr(stmt.expr, source_path) if stmt.expr else None
+            self.terminate(make_return(value, coord))
+        elif isinstance(stmt, c_ast.If):
+            self.convert_if_statement(stmt, self.current_block, source_path)
+        elif isinstance(stmt, c_ast.For):
+            self.convert_for_loop(stmt, self.current_block, source_path)
+        elif isinstance(stmt, c_ast.While):
+            self.convert_while_loop(stmt, self.current_block, source_path)
+        elif isinstance(stmt, c_ast.DoWhile):
+            self.convert_do_while_loop(stmt, source_path)
+        elif isinstance(stmt, c_ast.Switch):
+            self.convert_switch(stmt, source_path)
+        elif isinstance(stmt, c_ast.Break):
+            if self.loop_stack:
+                self.terminate(make_jump(self.loop_stack[-1][1], coord))
+        elif isinstance(stmt, c_ast.Continue):
+            # A switch passes continue on to the enclosing loop
+            targets = [target for target, _ in self.loop_stack if target is not None]
+            if targets:
+                self.terminate(make_jump(targets[-1], coord))
+        elif isinstance(stmt, c_ast.Goto):
+            self.terminate(make_jump(self.label_block(stmt.name, coord).name, coord))
+        elif isinstance(stmt, c_ast.Label):
+            block = self.label_block(stmt.name, coord)
+            self.terminate(make_jump(block.name, coord))
+            self.current_block = block
+            if stmt.stmt is not None:
+                self.convert_statement(stmt.stmt, source_path)
+        elif isinstance(stmt, c_ast.Compound):
+            # Handle compound statements (nested blocks)
+            self.convert_block(stmt, self.current_block, source_path)
+        elif isinstance(stmt, c_ast.EmptyStatement):
+            pass
+        elif isinstance(stmt, c_ast.Node) and not isinstance(stmt, (c_ast.Case, c_ast.Default)):
+            # Expression statement evaluated for its side effects (calls)
+            self.convert_expr(stmt, source_path)
+        else:
+            self.logger.warning(f"Unsupported statement {type(stmt).__name__} at {coord}, skipping")
+
+    def label_block(self, label: str, coord: Optional[str]) -> BasicBlock:
+        """Return the block a label starts, creating it on the first goto or definition."""
+        if label not in self.labels:
+            self.labels[label] = self.new_block(f"label_{label}", coord)
+        return self.labels[label]
+
+    def convert_switch(self, switch_stmt: c_ast.Switch, source_path: str) -> None:
+        """
+        Convert a switch statement to a ``Switch`` terminator.
+
+        Every ``case``/``default`` label of the body starts a block, and a
+        case falls through into the next one. ``break`` and a missing
+        ``default`` lead to ``switch_exit``. Case labels nested inside other
+        statements of the body are not supported.
+
+        Args:
+            switch_stmt: The pycparser switch statement
+            source_path: Source file path for coordinate tracking
+        """
+        coord = self.make_node_coord(switch_stmt, source_path)
+        value = self.convert_expr(switch_stmt.cond, source_path)
+        body = switch_stmt.stmt
+        items = (body.block_items or []) if isinstance(body, c_ast.Compound) else [body]
+        labels = [item for item in items if isinstance(item, (c_ast.Case, c_ast.Default))]
+
+        blocks = [self.new_block("switch_default" if isinstance(label, c_ast.Default) else "switch_case",
+                                 self.make_node_coord(label, source_path)) for label in labels]
+        exit_block = self.new_block("switch_exit", coord)
+        cases: Dict[Union[int, str], str] = {}
+        default_target = exit_block.name
+        for label, block in zip(labels, blocks):
+            if isinstance(label, c_ast.Default):
+                default_target = block.name
+            else:
+                cases.setdefault(self.case_value(label.expr), block.name)
+        self.terminate(Switch(expr=value, cases=cases, default_target=default_target, coord=coord))
+
+        # Statements before the first label are unreachable unless labelled themselves
+        first = items.index(labels[0]) if labels else len(items)
+        self.loop_stack.append((None, exit_block.name))
+        self.convert_statements(items[:first], source_path)
+        for index, (label, block) in enumerate(zip(labels, blocks)):
+            self.terminate(make_jump(block.name, coord))
+            self.current_block = block
+            self.convert_statements(label.stmts or [], source_path)
+            # Items between this label and the next one (pycparser normally nests them in the label)
+            following = items.index(labels[index + 1]) if index + 1 < len(labels) else len(items)
+            self.convert_statements(items[items.index(label) + 1:following], source_path)
+        self.loop_stack.pop()
+        self.terminate(make_jump(exit_block.name, coord))
+        self.current_block = exit_block
+
+    def case_value(self, expr: c_ast.Node) -> Union[int, str]:
+        """Return the value of a case label: an int for integer constants, else its source text."""
+        negative = isinstance(expr, c_ast.UnaryOp) and expr.op == '-'
+        constant = expr.expr if negative else expr
+        if isinstance(constant, c_ast.Constant) and constant.type == 'int':
+            digits = constant.value.rstrip('uUlL')
+            try:
+                value = int(digits, 8) if digits[1:2].isdigit() and digits[0] == '0' else int(digits, 0)
+                return -value if negative else value
+            except ValueError:
                 pass
-            elif isinstance(stmt, c_ast.Compound):
-                # Handle compound statements (nested blocks)
-                self.convert_block(stmt, lisa_block, source_path)
-    
+        return self.generator.visit(expr)
+
+    def convert_assignment(self, stmt: c_ast.Assignment, source_path: str) -> None:
+        """
+        Lower an assignment (including compound assignments like ``+=``).
+
+        Args:
+            stmt: The pycparser assignment
+            source_path: Source file path for coordinate tracking
+        """
+        coord = self.make_node_coord(stmt, source_path)
+        value = self.convert_expr(stmt.rvalue, source_path)
+        target = self.convert_expr(stmt.lvalue, source_path)
+        if stmt.op != '=':
+            value = make_binary_op(stmt.op[:-1], target, value)
+        self.store(target, value, coord)
+
+    def store(self, target: Expression, value: Expression, coord: Optional[str]) -> None:
+        """Assign to a variable, or store through any other lvalue."""
+        if isinstance(target, Variable):
+            self.emit(make_assign(target.name, value, coord))
+        else:
+            self.emit(Store(address=target, value=value, coord=coord))
+
+    def convert_call(self, call: c_ast.FuncCall, source_path: str) -> Optional[Variable]:
+        """
+        Lower a function call into a Call operation plus its semantic operations.
+
+        Args:
+            call: The pycparser function call
+            source_path: Source file path for coordinate tracking
+
+        Returns:
+            Variable holding the call result, or None for reference counting macros
+        """
+        coord = self.make_node_coord(call, source_path)
+        func_name = self.extract_func_name(call.name)
+        args = [self.convert_expr(arg, source_path) for arg in call.args.exprs] if call.args else []
+
+        if func_name in REFCOUNT_MACROS:
+            op_type, nullable = REFCOUNT_MACROS[func_name]
+            self.emit(make_call(None, func_name, args, coord))
+            target = args[0] if args else None
+            while isinstance(target, Cast):
+                target = target.expr
+            if isinstance(target, Variable):
+                attributes = {"target": target.name}
+                if op_type == "decr-ref":
+                    attributes["nullable"] = nullable
+                self.emit(make_semantic_op(op_type, attributes, coord))
+            return None
+
+        result = self.new_temp(CALL_RESULT_PREFIX, self.return_types.get(func_name))
+        self.emit(make_call(result, func_name, args, coord))
+
+        # Check if this is a Python/C API function that needs special handling
+        semantic_info = self.lookup_cache.get_function_info(func_name)
+        if (semantic_info and func_name in self.defined_functions
+                and semantic_info.get("source") == INFERRED_SOURCE):
+            # The analysis infers this file's own functions again; a stored summary may predate an edit
+            semantic_info = None
+        on_success = None
+        if func_name in FORMAT_FUNCTIONS:
+            if FORMAT_FUNCTIONS[func_name][0] == "build":
+                # Py_BuildValue consumes its N arguments even when it fails
+                self.emit_format_semantics(func_name, args, coord)
+            else:
+                on_success = lambda: self.emit_format_semantics(func_name, args, coord)
+        if semantic_info:
+            self.emit_call_semantics(func_name, result, args, semantic_info, coord, on_success)
+        elif on_success is not None:
+            on_success()
+        return make_variable(result)
+
+    def emit_call_semantics(self, func_name: str, result: str, args: List[Expression],
+                            semantic_info: Dict[str, Any], coord: Optional[str],
+                            on_success: Optional[Callable[[], None]] = None) -> None:
+        """
+        Emit the semantic operations of a call described by the semantic database.
+
+        A call with an error return value branches to a ``{func}_fail``
+        block, and both outcomes rejoin in ``{func}_success``.
+
+        Args:
+            func_name: Name of the called function
+            result: Temporary holding the call result
+            args: Converted call arguments
+            semantic_info: The function's semantic information
+            coord: Source coordinate of the call
+            on_success: Emits operations that only hold when the call succeeded; with an
+                error return they go into a ``{func}_ok`` block on the success edge only
+        """
+        ref_type = semantic_info.get("return_ref_type")
+        if ref_type == "new_ref":
+            self.emit(make_semantic_op("new-ref", {"target": result}, coord))
+        elif ref_type == "borrowed_ref":
+            source = args[0].name if args and isinstance(args[0], Variable) else None
+            self.emit(make_semantic_op("borrow-ref", {"dest": result, "source": source, "func": func_name}, coord))
+
+        for index, steals in sorted((semantic_info.get("arg_ref_steal") or {}).items(), key=lambda kv: int(kv[0])):
+            index = int(index)
+            if steals and index < len(args):
+                target = args[index].name if isinstance(args[index], Variable) else None
+                self.emit(make_semantic_op("steal-ref", {"target": target, "func": func_name, "arg_index": index},
+                                           coord))
+
+        error_value = semantic_info.get("error_return")
+        if error_value is not None:
+            self.emit(make_semantic_op("error-check", {"source": result, "value": error_value}, coord))
+            condition = make_binary_op("==", make_variable(result), self.error_constant(error_value))
+            condition.coord = coord
+            fail_block = self.new_block(f"{func_name}_fail", coord)
+            ok_block = self.new_block(f"{func_name}_ok", coord) if on_success is not None else None
+            success_block = self.new_block(f"{func_name}_success", coord)
+            self.terminate(make_branch_if(condition, fail_block.name, (ok_block or success_block).name, coord))
+            fail_block.set_terminator(make_jump(success_block.name, coord))
+            if ok_block is not None:
+                self.current_block = ok_block
+                on_success()
+                self.terminate(make_jump(success_block.name, coord))
+            self.current_block = success_block
+        elif on_success is not None:
+            on_success()
+
+    def emit_format_semantics(self, func_name: str, args: List[Expression], coord: Optional[str]) -> None:
+        """
+        Emit the semantic operations a format string implies for a call's variadic arguments.
+
+        Parse calls store a typed ``borrow-ref`` for every object output
+        pointer, ``parse-convert`` for ``O&`` targets and ``parse-assign``
+        for C value outputs; ``Py_BuildValue`` steals every ``N``
+        argument, whether or not it succeeds. Objects passed with ``O``/``S`` are increfed by the
+        call itself, so the caller's reference is unaffected.
+
+        Args:
+            func_name: A key of FORMAT_FUNCTIONS
+            args: Converted call arguments
+            coord: Source coordinate of the call
+        """
+        kind, format_index, first_vararg = FORMAT_FUNCTIONS[func_name]
+        literal = args[format_index] if len(args) > format_index else None
+        fmt = literal_format(literal.value) if isinstance(literal, Constant) and isinstance(literal.value, str) else None
+        if fmt is None:
+            return
+        spec = decode_format(kind, fmt)
+        if spec.error:
+            self.logger.warning(f"{coord}: {func_name} format \"{fmt}\": {spec.error}")
+            return
+        varargs = args[first_vararg:]
+        if len(varargs) != len(spec.args):
+            self.logger.warning(f"{coord}: {func_name} format \"{fmt}\" takes {len(spec.args)} arguments, "
+                                f"got {len(varargs)}")
+
+        def variable_name(expr, address_of):
+            while isinstance(expr, Cast):
+                expr = expr.expr
+            if address_of:
+                if not isinstance(expr, AddressOf):
+                    return None
+                expr = expr.expr
+            return expr.name if isinstance(expr, Variable) else None
+
+        source = args[0].name if kind == "parse" and args and isinstance(args[0], Variable) else None
+        type_object = converter = None
+        for index, (arg_spec, arg) in enumerate(zip(spec.args, varargs), start=first_vararg):
+            role = arg_spec.role
+            if role == "type":
+                type_object = variable_name(arg, True) or variable_name(arg, False)
+            elif role == "converter":
+                converter = variable_name(arg, False)
+            elif kind == "build":
+                target = variable_name(arg, False)
+                if role == "steal" and target:
+                    self.emit(make_semantic_op("steal-ref", {"target": target, "func": func_name,
+                                                             "arg_index": index}, coord))
+            else:
+                target = variable_name(arg, True)
+                if target is None:
+                    continue
+                if role == "object":
+                    self.emit(make_semantic_op("borrow-ref", {
+                        "dest": target, "source": source, "func": func_name, "format": arg_spec.unit,
+                        "type": type_object if arg_spec.unit.endswith('!') else arg_spec.type_object
+                    }, coord))
+                elif role == "convert-target":
+                    self.emit(make_semantic_op("parse-convert", {"target": target, "converter": converter,
+                                                                 "func": func_name}, coord))
+                else:
+                    self.emit(make_semantic_op("parse-assign", {"target": target, "c_type": arg_spec.c_type,
+                                                                "format": arg_spec.unit, "func": func_name}, coord))
+
+    @staticmethod
+    def error_constant(value: Any) -> Constant:
+        """Build the constant an error-returning call is compared against."""
+        if value in (None, "NULL"):
+            return Constant(const_type="void*", value="NULL")
+        try:
+            return make_constant_int(int(str(value)))
+        except ValueError:
+            pass
+        try:
+            return Constant(const_type="double", value=float(str(value)))
+        except ValueError:
+            return make_constant_string(str(value))
+
+    def convert_condition(self, cond: c_ast.Node, true_target: str, false_target: str, source_path: str) -> None:
+        """
+        Lower a branch condition, turning ``&&``, ``||`` and ``!`` into control flow.
+
+        Args:
+            cond: The pycparser condition expression
+            true_target: Block to continue in when the condition holds
+            false_target: Block to continue in otherwise
+            source_path: Source file path for coordinate tracking
+        """
+        coord = self.make_node_coord(cond, source_path)
+        if isinstance(cond, c_ast.BinaryOp) and cond.op in ('&&', '||'):
+            rhs_block = self.new_block("and_rhs" if cond.op == '&&' else "or_rhs", coord)
+            if cond.op == '&&':
+                self.convert_condition(cond.left, rhs_block.name, false_target, source_path)
+            else:
+                self.convert_condition(cond.left, true_target, rhs_block.name, source_path)
+            self.current_block = rhs_block
+            self.convert_condition(cond.right, true_target, false_target, source_path)
+            return
+
+        condition = self.convert_expr(cond, source_path)
+        self.terminate(make_branch_if(condition, true_target, false_target, coord))
+
     def convert_if_statement(self, if_stmt: c_ast.If, current_block: BasicBlock, source_path: str):
         """
         Convert an if statement to LISA IR with proper control flow.
-        
+
         Args:
             if_stmt: The pycparser if statement
             current_block: The current LISA IR basic block
             source_path: Source file path for coordinate tracking
         """
-        # Generate unique block names
-        next_block_id = len(current_block.parent.blocks) if hasattr(current_block, 'parent') else 0
-        then_block_name = f"then_{next_block_id}"
-        else_block_name = f"else_{next_block_id+1}" 
-        merge_block_name = f"merge_{next_block_id+2}"
-        
-        # Convert the condition
-        coord = make_coord(source_path, if_stmt.coord.line if if_stmt.coord else 1,
-                         if_stmt.coord.column if if_stmt.coord else 1) if if_stmt.coord else None
-        condition = self.convert_expr(if_stmt.cond, source_path)
-        
-        # Create branch operation to then and else blocks
-        branch_op = make_branch_if(condition, then_block_name, else_block_name if if_stmt.iftrue and if_stmt.iffalse else merge_block_name, coord)
-        current_block.set_terminator(branch_op)
-        
-        # Create then block
-        then_block = BasicBlock(name=then_block_name, coord=coord)
-        if if_stmt.iftrue:
-            self.convert_block(if_stmt.iftrue, then_block, source_path)
-        # If then block doesn't have a terminator, add a jump to merge
-        if then_block.terminator is None:
-            then_block.set_terminator(make_jump(merge_block_name, coord))
-        
-        # Create else block if exists
-        if if_stmt.iffalse:
-            else_block = BasicBlock(name=else_block_name, coord=coord)
-            self.convert_block(if_stmt.iffalse, else_block, source_path)
-            # If else block doesn't have a terminator, add a jump to merge
-            if else_block.terminator is None:
-                else_block.set_terminator(make_jump(merge_block_name, coord))
-        else:
-            # If no else block, create an empty one that jumps to merge
-            else_block = BasicBlock(name=else_block_name, coord=coord)
-            else_block.set_terminator(make_jump(merge_block_name, coord))
-        
-        # Create merge block
-        merge_block = BasicBlock(name=merge_block_name, coord=coord)
-        # Note: We need to properly link these blocks in the function, 
-        # but this is a simplified representation
-        
+        coord = self.make_node_coord(if_stmt, source_path)
+        self.current_block = current_block
+
+        then_block = self.new_block("if_then", coord)
+        else_block = self.new_block("if_else", coord) if if_stmt.iffalse else None
+        merge_block = self.new_block("if_merge", coord)
+
+        self.convert_condition(if_stmt.cond, then_block.name,
+                               else_block.name if else_block else merge_block.name, source_path)
+
+        self.convert_branch_body(if_stmt.iftrue, then_block, source_path)
+        self.terminate(make_jump(merge_block.name, coord))
+
+        if else_block is not None:
+            self.convert_branch_body(if_stmt.iffalse, else_block, source_path)
+            self.terminate(make_jump(merge_block.name, coord))
+
+        self.current_block = merge_block
+
+    def convert_branch_body(self, body: Optional[c_ast.Node], block: BasicBlock, source_path: str) -> None:
+        """Convert a statement or compound statement starting in the given block."""
+        self.current_block = block
+        if isinstance(body, c_ast.Compound):
+            self.convert_block(body, block, source_path)
+        elif body is not None:
+            self.convert_statement(body, source_path)
+
     def convert_for_loop(self, for_stmt: c_ast.For, current_block: BasicBlock, source_path: str):
         """
         Convert a for loop to LISA IR with proper control flow.
-        
+
+        The loop becomes ``for_header`` (condition), ``for_body``,
+        ``for_update`` (the increment, target of ``continue``) and
+        ``for_exit`` (target of ``break``).
+
         Args:
             for_stmt: The pycparser for statement
             current_block: The current LISA IR basic block
             source_path: Source file path for coordinate tracking
         """
-        # For now, just convert the components without full loop structure
-        # This is a simplified implementation
-        if for_stmt.init:  # Initialization
-            if isinstance(for_stmt.init, c_ast.DeclList):
-                for decl in for_stmt.init.decls:
-                    if decl.init:  # If the declaration has an initializer
-                        coord = make_coord(source_path, decl.coord.line if decl.coord else 1,
-                                         decl.coord.column if decl.coord else 1) if decl.coord else None
-                        target_var = make_variable(decl.name)
-                        value_expr = self.convert_expr(decl.init, source_path)
-                        assign_op = make_assign(decl.name, value_expr, coord)
-                        current_block.add_operation(assign_op)
-                        
-                        # Add to scope
-                        self.current_scope[decl.name] = str(decl.type)
-            elif isinstance(for_stmt.init, c_ast.Assignment):
-                coord = make_coord(source_path, for_stmt.init.coord.line if for_stmt.init.coord else 1,
-                                 for_stmt.init.coord.column if for_stmt.init.coord else 1) if for_stmt.init.coord else None
-                target = self.convert_expr(for_stmt.init.lvalue, source_path)
-                value = self.convert_expr(for_stmt.init.rvalue, source_path)
-                
-                # For now, we assume simple variable assignments
-                if isinstance(target, Variable):
-                    assign_op = make_assign(target.name, value, coord)
-                    current_block.add_operation(assign_op)
-        
-        # The condition and increment parts would be handled in a full implementation
-        # along with the loop body
-        
-        if for_stmt.stmt:  # Loop body
-            # For a complete implementation, we'd need to create proper basic blocks for the loop
-            # This is a simplified version
-            self.convert_block(for_stmt.stmt, current_block, source_path)
-    
+        coord = self.make_node_coord(for_stmt, source_path)
+        self.current_block = current_block
+        if for_stmt.init is not None:
+            self.convert_statement(for_stmt.init, source_path)
+
+        header = self.new_block("for_header", coord)
+        body = self.new_block("for_body", coord)
+        update = self.new_block("for_update", coord)
+        exit_block = self.new_block("for_exit", coord)
+        self.terminate(make_jump(header.name, coord))
+
+        self.current_block = header
+        if for_stmt.cond is not None:
+            self.convert_condition(for_stmt.cond, body.name, exit_block.name, source_path)
+        else:
+            self.terminate(make_jump(body.name, coord))
+
+        self.loop_stack.append((update.name, exit_block.name))
+        self.convert_branch_body(for_stmt.stmt, body, source_path)
+        self.loop_stack.pop()
+        self.terminate(make_jump(update.name, coord))
+
+        self.current_block = update
+        if for_stmt.next is not None:
+            self.convert_statement(for_stmt.next, source_path)
+        self.terminate(make_jump(header.name, coord))
+
+        self.current_block = exit_block
+
     def convert_while_loop(self, while_stmt: c_ast.While, current_block: BasicBlock, source_path: str):
         """
         Convert a while loop to LISA IR with proper control flow.
-        
+
         Args:
             while_stmt: The pycparser while statement
             current_block: The current LISA IR basic block
             source_path: Source file path for coordinate tracking
         """
-        # Similar to for loop, this is a simplified implementation
-        if while_stmt.stmt:  # Loop body
-            self.convert_block(while_stmt.stmt, current_block, source_path)
-    
+        coord = self.make_node_coord(while_stmt, source_path)
+        self.current_block = current_block
+
+        header = self.new_block("while_header", coord)
+        body = self.new_block("while_body", coord)
+        exit_block = self.new_block("while_exit", coord)
+        self.terminate(make_jump(header.name, coord))
+
+        self.current_block = header
+        self.convert_condition(while_stmt.cond, body.name, exit_block.name, source_path)
+
+        self.loop_stack.append((header.name, exit_block.name))
+        self.convert_branch_body(while_stmt.stmt, body, source_path)
+        self.loop_stack.pop()
+        self.terminate(make_jump(header.name, coord))
+
+        self.current_block = exit_block
+
+    def convert_do_while_loop(self, do_stmt: c_ast.DoWhile, source_path: str):
+        """
+        Convert a do/while loop: the body runs before the condition is tested.
+
+        Args:
+            do_stmt: The pycparser do/while statement
+            source_path: Source file path for coordinate tracking
+        """
+        coord = self.make_node_coord(do_stmt, source_path)
+        body = self.new_block("do_body", coord)
+        cond_block = self.new_block("do_cond", coord)
+        exit_block = self.new_block("do_exit", coord)
+        self.terminate(make_jump(body.name, coord))
+
+        self.loop_stack.append((cond_block.name, exit_block.name))
+        self.convert_branch_body(do_stmt.stmt, body, source_path)
+        self.loop_stack.pop()
+        self.terminate(make_jump(cond_block.name, coord))
+
+        self.current_block = cond_block
+        self.convert_condition(do_stmt.cond, body.name, exit_block.name, source_path)
+        self.current_block = exit_block
+
     def convert_expr(self, expr: c_ast.Node, source_path: str) -> Expression:
         """
         Convert a pycparser expression to a LISA IR expression.
-        
+
+        Calls inside the expression are lowered into the current block
+        first and replaced by their result temporaries.
+
         Args:
             expr: The pycparser expression node
             source_path: Source file path for coordinate tracking
-            
+
         Returns:
             Expression: The converted LISA IR expression
         """
-        coord = make_coord(source_path, expr.coord.line if expr.coord else 1,
-                         expr.coord.column if expr.coord else 1) if expr.coord else None
-        
+        coord = self.make_node_coord(expr, source_path)
+
         if isinstance(expr, c_ast.Constant):
             # Handle constants
             if expr.type == 'int':
                 try:
-                    value = int(expr.value)
-                    return make_constant_int(value)
+                    value = int(expr.value.rstrip('uUlL'), 0)
+                    return Constant(const_type="int", value=value, coord=coord)
                 except ValueError:
                     # If conversion fails, return as string
                     return make_constant_string(expr.value)
@@ -336,22 +912,23 @@ class ASTConverter:
             # Handle binary operations
             left = self.convert_expr(expr.left, source_path)
             right = self.convert_expr(expr.right, source_path)
-            return make_binary_op(expr.op, left, right)
+            return BinaryOp(op=expr.op, left=left, right=right, coord=coord)
         elif isinstance(expr, c_ast.UnaryOp):
-            # Handle unary operations
+            if expr.op == 'sizeof':
+                return make_constant_string(self.generator.visit(expr))
             operand = self.convert_expr(expr.expr, source_path)
-            # For now, return as a more general expression - we'd need to extend IR for full support
-            return make_variable(f"unary_{expr.op}_{operand.name if hasattr(operand, 'name') else 'expr'}")
+            if expr.op == '&':
+                return AddressOf(expr=operand, coord=coord)
+            if expr.op == '*':
+                return Dereference(expr=operand, coord=coord)
+            return UnaryOp(op=expr.op, operand=operand, coord=coord)
+        elif isinstance(expr, c_ast.Cast):
+            return Cast(target_type=self.type_string(expr.to_type.type),
+                        expr=self.convert_expr(expr.expr, source_path), coord=coord)
         elif isinstance(expr, c_ast.FuncCall):
-            # Handle function calls in expressions
-            func_name = self.extract_func_name(expr.name)
-            
-            args = []
-            if expr.args:
-                for arg in expr.args.exprs:
-                    args.append(self.convert_expr(arg, source_path))
-            
-            return FunctionCall(function_name=func_name, args=args, coord=coord)
+            # Calls are lowered to operations; the expression is their result
+            result = self.convert_call(expr, source_path)
+            return result if result is not None else make_constant_int(0)
         elif isinstance(expr, c_ast.ArrayRef):
             # Handle array references
             array = self.convert_expr(expr.name, source_path)
@@ -363,18 +940,52 @@ class ASTConverter:
             field = expr.field.name
             is_arrow = expr.type == '->'
             return StructRef(struct=struct, field=field, is_arrow=is_arrow, coord=coord)
+        elif isinstance(expr, c_ast.TernaryOp):
+            return self.convert_ternary(expr, source_path)
+        elif isinstance(expr, c_ast.Assignment):
+            self.convert_assignment(expr, source_path)
+            return self.convert_expr(expr.lvalue, source_path)
+        elif isinstance(expr, c_ast.ExprList):
+            values = [self.convert_expr(e, source_path) for e in expr.exprs]
+            return values[-1] if values else make_constant_int(0)
         else:
             # For unsupported expressions, return a placeholder
             self.logger.warning(f"Unsupported expression type: {type(expr)}, using placeholder")
             return make_variable(f"placeholder_{type(expr).__name__}")
-    
+
+    def convert_ternary(self, expr: c_ast.TernaryOp, source_path: str) -> Variable:
+        """
+        Lower ``cond ? a : b`` into branches assigning a ``temp_N`` variable.
+
+        Args:
+            expr: The pycparser ternary expression
+            source_path: Source file path for coordinate tracking
+
+        Returns:
+            Variable holding the selected value
+        """
+        coord = self.make_node_coord(expr, source_path)
+        temp = self.new_temp(TEMP_PREFIX)
+        then_block = self.new_block("cond_true", coord)
+        else_block = self.new_block("cond_false", coord)
+        merge_block = self.new_block("cond_merge", coord)
+
+        self.convert_condition(expr.cond, then_block.name, else_block.name, source_path)
+        for block, value in ((then_block, expr.iftrue), (else_block, expr.iffalse)):
+            self.current_block = block
+            self.emit(make_assign(temp, self.convert_expr(value, source_path), coord))
+            self.terminate(make_jump(merge_block.name, coord))
+
+        self.current_block = merge_block
+        return make_variable(temp)
+
     def extract_func_name(self, func_node: Union[c_ast.ID, c_ast.Node]) -> str:
         """
         Extract function name from a function call node.
-        
+
         Args:
             func_node: The function name node
-            
+
         Returns:
             str: The function name
         """
@@ -384,4 +995,4 @@ class ASTConverter:
             return self.extract_func_name(func_node.name)
         else:
             # For more complex expressions, we'd need more sophisticated handling
-            return "unknown_func"
\ No newline at end of file
+            return "unknown_func"
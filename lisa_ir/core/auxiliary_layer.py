@@ -0,0 +1,1805 @@
+#!/usr/bin/env python3
+"""
+AI Auxiliary Layer for Semantic Extraction
+
+Generated by PROMPT-06 (Complete Version)
+This module implements the AI auxiliary layer that interacts with local LLMs
+to extract semantic hints from C code comments and documentation.
+
+The auxiliary layer enhances the static analysis by leveraging AI models to
+understand developer intent and extract precise API semantics from natural
+language descriptions in comments.
+"""
+
+import hashlib
+import heapq
+import json
+import logging
+import re
+import requests
+import threading
+from collections import deque
+from concurrent.futures import ThreadPoolExecutor, wait, FIRST_COMPLETED
+from pathlib import Path
+from typing import Dict, Any, List, Tuple, Optional
+import time
+
+from pycparser import c_ast, c_generator
+
+from lisa_ir.utils.file_lock import FileLock, atomic_write_json
+
+
+# Default configuration for local LLM endpoint
+DEFAULT_LLM_ENDPOINT = "http://192.168.137.1:6006/v1/chat/completions"
+DEFAULT_TIMEOUT = 60  # seconds
+DEFAULT_MAX_RETRIES = 3
+DEFAULT_MAX_WORKERS = 4
+DEFAULT_RATE_LIMIT = None  # requests per second, None for unlimited
+DEFAULT_LLM_MODEL = "qwen3-32b-awq"
+DEFAULT_STREAM = True  # stream completions and stop reading once the JSON answer is complete
+
+# Default configuration for adaptive timeouts and the circuit breaker
+LATENCY_WINDOW = 100  # most recent successful requests kept per endpoint
+MIN_LATENCY_SAMPLES = 10  # samples needed before timeouts adapt
+ADAPTIVE_TIMEOUT_PERCENTILE = 95
+ADAPTIVE_TIMEOUT_FACTOR = 3.0  # timeout = factor * latency percentile
+MIN_ADAPTIVE_TIMEOUT = 1.0  # seconds
+DEFAULT_BREAKER_THRESHOLD = 5  # consecutive failures that open the circuit, 0 disables
+DEFAULT_BREAKER_RESET = 60.0  # seconds before a probe request is allowed through
+
+# Default configuration for multi-function batched prompts
+DEFAULT_BATCH_SIZE = 1  # functions per request, 1 disables batching
+DEFAULT_BATCH_TOKEN_BUDGET = 4096  # estimated prompt + answer tokens per request
+OUTPUT_TOKENS_PER_FUNCTION = 64  # estimated answer tokens for one function
+
+# A comment documents a function when it ends at most this many lines above it
+MAX_COMMENT_GAP_LINES = 3
+
+# Bump whenever the few-shot prompt changes so cached answers are not reused
+FEW_SHOT_TEMPLATE_VERSION = 1
+
+# Default configuration for the LLM response cache
+DEFAULT_CACHE_PATH = Path(".lisa_cache") / "llm_cache.json"
+DEFAULT_CACHE_TTL = 30 * 24 * 3600  # seconds
+DEFAULT_CACHE_MAX_ENTRIES = 10000
+DEFAULT_CACHE_REFRESH = 24 * 3600  # seconds before a hit's recency is written back
+
+
+class RateLimiter:
+    """
+    Thread-safe token bucket limiting the request rate to one endpoint.
+    """
+
+    def __init__(self, rate: float, burst: Optional[int] = None):
+        """
+        Initialize the rate limiter.
+
+        Args:
+            rate: Sustained requests per second
+            burst: Maximum number of requests issued back to back (default: ceil(rate))
+        """
+        self.rate = rate
+        self.capacity = burst if burst is not None else max(1, int(rate + 0.999))
+        self.tokens = float(self.capacity)
+        self.last_refill = time.monotonic()
+        self.lock = threading.Lock()
+
+    def acquire(self) -> None:
+        """Block until a request may be issued."""
+        while True:
+            with self.lock:
+                now = time.monotonic()
+                self.tokens = min(self.capacity, self.tokens + (now - self.last_refill) * self.rate)
+                self.last_refill = now
+                if self.tokens >= 1:
+                    self.tokens -= 1
+                    return
+                wait_time = (1 - self.tokens) / self.rate
+            time.sleep(wait_time)
+
+
+# Rate limiters shared by every AuxiliaryLayer talking to the same endpoint
+_rate_limiters: Dict[str, RateLimiter] = {}
+_rate_limiters_lock = threading.Lock()
+
+
+def get_rate_limiter(endpoint: str, rate: Optional[float]) -> Optional[RateLimiter]:
+    """
+    Get the shared rate limiter for an endpoint.
+
+    Args:
+        endpoint: LLM API endpoint
+        rate: Requests per second, or None for no limit
+
+    Returns:
+        The endpoint's RateLimiter, or None if unlimited
+    """
+    if not rate:
+        return None
+    with _rate_limiters_lock:
+        limiter = _rate_limiters.get(endpoint)
+        if limiter is None or limiter.rate != rate:
+            limiter = RateLimiter(rate)
+            _rate_limiters[endpoint] = limiter
+        return limiter
+
+
+class LatencyTracker:
+    """
+    Thread-safe window of recent request latencies to one endpoint.
+    """
+
+    def __init__(self, window: int = LATENCY_WINDOW):
+        """
+        Initialize the tracker.
+
+        Args:
+            window: Number of most recent samples kept
+        """
+        self.samples: deque = deque(maxlen=window)
+        self.lock = threading.Lock()
+
+    def record(self, seconds: float) -> None:
+        """Record the latency of a successful request, or how long a timed-out one ran."""
+        with self.lock:
+            self.samples.append(seconds)
+
+    def percentile(self, percent: float) -> Optional[float]:
+        """Return the given latency percentile (nearest rank), or None without samples."""
+        with self.lock:
+            ordered = sorted(self.samples)
+        if not ordered:
+            return None
+        rank = max(0, min(len(ordered) - 1, int(len(ordered) * percent / 100.0 + 0.5) - 1))
+        return ordered[rank]
+
+    def timeout(self, ceiling: float) -> float:
+        """
+        Derive a request timeout from the observed latencies.
+
+        Args:
+            ceiling: Configured timeout, used until enough samples exist and never exceeded
+
+        Returns:
+            Timeout in seconds
+        """
+        with self.lock:
+            enough = len(self.samples) >= MIN_LATENCY_SAMPLES
+        if not enough:
+            return ceiling
+        adaptive = ADAPTIVE_TIMEOUT_FACTOR * self.percentile(ADAPTIVE_TIMEOUT_PERCENTILE)
+        return min(ceiling, max(MIN_ADAPTIVE_TIMEOUT, adaptive))
+
+
+class CircuitBreaker:
+    """
+    Thread-safe circuit breaker for one endpoint.
+
+    After ``failure_threshold`` consecutive failures the circuit opens and
+    requests are refused. Once ``reset_timeout`` seconds have passed a
+    single probe request is let through (half-open); its success closes
+    the circuit again, its failure reopens it.
+    """
+
+    CLOSED = "closed"
+    OPEN = "open"
+    HALF_OPEN = "half-open"
+
+    def __init__(self, failure_threshold: int = DEFAULT_BREAKER_THRESHOLD,
+                 reset_timeout: float = DEFAULT_BREAKER_RESET):
+        """
+        Initialize the circuit breaker.
+
+        Args:
+            failure_threshold: Consecutive failures that open the circuit
+            reset_timeout: Seconds the circuit stays open before a probe
+        """
+        self.failure_threshold = failure_threshold
+        self.reset_timeout = reset_timeout
+        self.state = self.CLOSED
+        self.failures = 0
+        self.opened_at = 0.0
+        self.probe_in_flight = False
+        self.lock = threading.Lock()
+
+    def allow(self) -> bool:
+        """Return whether a request may be issued now."""
+        with self.lock:
+            if self.state == self.CLOSED:
+                return True
+            if self.state == self.OPEN:
+                if time.monotonic() - self.opened_at < self.reset_timeout:
+                    return False
+                self.state = self.HALF_OPEN
+            if self.probe_in_flight:
+                return False
+            self.probe_in_flight = True
+            return True
+
+    def is_open(self) -> bool:
+        """Return whether requests are currently refused outright (no probe is due)."""
+        with self.lock:
+            return self.state == self.OPEN and time.monotonic() - self.opened_at < self.reset_timeout
+
+    def record_success(self) -> None:
+        """Record a successful request."""
+        with self.lock:
+            self.state = self.CLOSED
+            self.failures = 0
+            self.probe_in_flight = False
+
+    def record_failure(self) -> bool:
+        """
+        Record a failed request, opening the circuit if needed.
+
+        Returns:
+            True if this failure opened the circuit
+        """
+        with self.lock:
+            self.failures += 1
+            self.probe_in_flight = False
+            if self.state != self.OPEN and (self.state == self.HALF_OPEN
+                                            or self.failures >= self.failure_threshold):
+                self.state = self.OPEN
+                self.opened_at = time.monotonic()
+                return True
+            return False
+
+
+# Latency trackers and circuit breakers shared by every AuxiliaryLayer talking to the same endpoint
+_latency_trackers: Dict[str, LatencyTracker] = {}
+_circuit_breakers: Dict[str, CircuitBreaker] = {}
+
+
+def get_latency_tracker(endpoint: str) -> LatencyTracker:
+    """Get the shared latency tracker for an endpoint."""
+    with _rate_limiters_lock:
+        return _latency_trackers.setdefault(endpoint, LatencyTracker())
+
+
+def get_circuit_breaker(endpoint: str, failure_threshold: int,
+                        reset_timeout: float) -> Optional[CircuitBreaker]:
+    """
+    Get the shared circuit breaker for an endpoint.
+
+    Args:
+        endpoint: LLM API endpoint
+        failure_threshold: Consecutive failures that open the circuit, 0 disables it
+        reset_timeout: Seconds the circuit stays open before a probe
+
+    Returns:
+        The endpoint's CircuitBreaker, or None if disabled
+    """
+    if failure_threshold <= 0:
+        return None
+    with _rate_limiters_lock:
+        breaker = _circuit_breakers.get(endpoint)
+        if breaker is None or (breaker.failure_threshold, breaker.reset_timeout) != (failure_threshold, reset_timeout):
+            breaker = CircuitBreaker(failure_threshold, reset_timeout)
+            _circuit_breakers[endpoint] = breaker
+        return breaker
+
+
+def scan_comments(c_code: str) -> List[Tuple[int, int, str]]:
+    """
+    Collect the comments of a C source in one pass.
+
+    String and character literals are skipped so comment markers inside
+    them are ignored. Runs of ``//`` comments on consecutive lines are
+    merged into a single comment.
+
+    Args:
+        c_code: C source code string
+
+    Returns:
+        List of (start_line, end_line, text) tuples in source order, 1-based lines
+    """
+    comments: List[Tuple[int, int, str]] = []
+    i, n, line = 0, len(c_code), 1
+
+    while i < n:
+        ch = c_code[i]
+        if ch == '\n':
+            line += 1
+            i += 1
+        elif ch == '"' or ch == "'":
+            # Skip the literal, honouring escapes; literals never span lines
+            i += 1
+            while i < n and c_code[i] != ch and c_code[i] != '\n':
+                i += 2 if c_code[i] == '\\' else 1
+            i += 1
+        elif c_code.startswith('/*', i):
+            end = c_code.find('*/', i + 2)
+            end = n if end == -1 else end
+            text = c_code[i + 2:end]
+            end_line = line + text.count('\n')
+            comments.append((line, end_line, text.strip()))
+            line = end_line
+            i = end + 2
+        elif c_code.startswith('//', i):
+            end = c_code.find('\n', i)
+            end = n if end == -1 else end
+            text = c_code[i + 2:end].strip()
+            if comments and comments[-1][1] == line - 1 and comments[-1][2].startswith('//'):
+                start_line, _, previous = comments[-1]
+                comments[-1] = (start_line, line, f"{previous}\n// {text}")
+            else:
+                comments.append((line, line, f"// {text}"))
+            i = end
+        else:
+            i += 1
+
+    # Drop the markers that were kept only to recognise line-comment runs
+    return [(start, end, text[3:].replace('\n// ', '\n') if text.startswith('// ') else text)
+            for start, end, text in comments]
+
+
+# Comment phrases that decide ownership with high confidence
+_NEW_REF_PATTERN = re.compile(r'\bnew\s+(?:strong\s+)?ref(?:erence)?s?\b', re.IGNORECASE)
+_BORROWED_REF_PATTERN = re.compile(r'\bborrow(?:ed|s)?\s+(?:a\s+)?ref(?:erence)?s?\b', re.IGNORECASE)
+_NO_STEAL_PATTERN = re.compile(r'\b(?:without\s+stealing|does\s+not\s+steal|doesn\'t\s+steal|not\s+steal(?:ing)?|no\s+steal)',
+                               re.IGNORECASE)
+_STEAL_PATTERN = re.compile(r'\bsteal(?:s|ing)?\b(?:\s+(?:a|the))?(?:\s+reference)?(?:\s+(?:to|of|from))?(?:\s+(\w+))?',
+                            re.IGNORECASE)
+_ERROR_RETURN_PATTERN = re.compile(r'(NULL|-1|0)\s+(?:on|if|upon|for)\s+(?:failure|error)', re.IGNORECASE)
+
+
+def _split_signature(signature: str) -> Tuple[str, List[Tuple[str, str]]]:
+    """
+    Split a C signature into its return type and (type, name) parameters.
+
+    Args:
+        signature: Function signature such as "PyObject* f(PyObject* a, int b)"
+
+    Returns:
+        Tuple (return type, list of (parameter type, parameter name))
+    """
+    open_paren = signature.find('(')
+    head = signature[:open_paren] if open_paren != -1 else signature
+    name_match = re.search(r'([A-Za-z_][A-Za-z0-9_]*)\s*$', head)
+    return_type = head[:name_match.start()].strip() if name_match else head.strip()
+
+    params = []
+    if open_paren != -1:
+        inner = signature[open_paren + 1:signature.rfind(')')]
+        for param in inner.split(','):
+            param = param.strip()
+            if not param or param == 'void' or param == '...':
+                continue
+            pname = re.search(r'([A-Za-z_][A-Za-z0-9_]*)\s*(?:\[\s*\])?\s*$', param)
+            params.append((param, pname.group(1) if pname else ''))
+    return return_type, params
+
+
+# Return types made only of these tokens certainly carry no object reference
+_SCALAR_TYPE_TOKENS = {
+    'void', 'int', 'long', 'short', 'char', 'unsigned', 'signed', 'float', 'double',
+    'size_t', 'Py_ssize_t', 'Py_hash_t', 'bool', '_Bool', 'const', 'static', 'inline', 'extern'
+}
+
+
+def _is_scalar_type(c_type: str) -> bool:
+    """Check whether a C type is built only from scalar types (macros like PyMODINIT_FUNC are not)."""
+    tokens = re.findall(r'[A-Za-z_][A-Za-z0-9_]*', c_type)
+    return bool(tokens) and all(token in _SCALAR_TYPE_TOKENS for token in tokens)
+
+
+def _is_object_pointer(c_type: str) -> bool:
+    """Check whether a C type spells a PyObject pointer (or array of them)."""
+    return 'PyObject' in c_type and ('*' in c_type or '[' in c_type)
+
+
+def classify_by_signature(signature: str) -> Optional[Dict[str, Any]]:
+    """
+    Resolve a function whose signature alone fixes its reference semantics.
+
+    A function that returns a plain scalar and takes no ``PyObject*``
+    parameters can neither return nor steal a reference.
+
+    Args:
+        signature: Function signature
+
+    Returns:
+        Semantic information dictionary, or None if the signature involves objects
+    """
+    return_type, params = _split_signature(signature)
+    if not _is_scalar_type(return_type):
+        return None
+    if any(_is_object_pointer(ptype) for ptype, _ in params):
+        return None
+    return {"return_ref_type": "none", "arg_ref_steal": {}}
+
+
+def classify_by_heuristics(signature: str, comment: str) -> Optional[Dict[str, Any]]:
+    """
+    Resolve a function's semantics without the LLM when the evidence is unambiguous.
+
+    The comment phrasing used by the few-shot examples ("Returns a new
+    reference", "Returns borrowed reference", "stealing the reference to
+    item", "-1 on failure") is matched with fixed patterns and checked
+    against the signature: a function returning a plain scalar type
+    returns no reference, and a stolen argument must be a named
+    ``PyObject*`` parameter. A scalar-returning function that takes
+    ``PyObject*`` parameters is only resolved when its comment says
+    whether it steals them; otherwise it is left to the LLM.
+
+    Args:
+        signature: Function signature
+        comment: Associated comment
+
+    Returns:
+        Semantic information dictionary, or None if the function is ambiguous
+    """
+    return_type, params = _split_signature(signature)
+    text = ' '.join(comment.split())
+
+    says_new = bool(_NEW_REF_PATTERN.search(text))
+    says_borrowed = bool(_BORROWED_REF_PATTERN.search(text))
+
+    if _is_object_pointer(return_type):
+        if says_new == says_borrowed:
+            return None
+        info: Dict[str, Any] = {"return_ref_type": "new_ref" if says_new else "borrowed_ref"}
+    elif _is_scalar_type(return_type):
+        info = {"return_ref_type": "none"}
+    else:
+        return None
+
+    info["arg_ref_steal"] = {}
+    says_no_steal = bool(_NO_STEAL_PATTERN.search(text))
+    if not says_no_steal:
+        for match in _STEAL_PATTERN.finditer(text):
+            target = match.group(1)
+            indices = [i for i, (ptype, pname) in enumerate(params)
+                       if _is_object_pointer(ptype) and target and pname == target]
+            if not indices:
+                object_params = [i for i, (ptype, _) in enumerate(params) if _is_object_pointer(ptype)]
+                if len(object_params) != 1:
+                    return None
+                indices = object_params
+            info["arg_ref_steal"][str(indices[0])] = True
+
+    # Only the stealing of arguments is in question here, so silence is no evidence
+    if (info["return_ref_type"] == "none" and not says_no_steal and not info["arg_ref_steal"]
+            and any(_is_object_pointer(ptype) for ptype, _ in params)):
+        return None
+
+    error_match = _ERROR_RETURN_PATTERN.search(text)
+    if error_match:
+        info["error_return"] = error_match.group(1).upper()
+    elif _is_object_pointer(return_type):
+        info["error_return"] = "NULL"
+
+    return info
+
+
+class JSONStreamScanner:
+    """
+    Incremental scanner finding the first complete top-level JSON object in streamed text.
+
+    Braces are counted outside string literals only. When the outermost
+    object closes it is decoded; a balanced but invalid candidate (for
+    example braces in thinking text) is discarded and scanning resumes.
+    """
+
+    def __init__(self):
+        self.text: List[str] = []
+        self.length = 0
+        self.depth = 0
+        self.start = -1
+        self.in_string = False
+        self.escaped = False
+        self.result: Optional[str] = None
+
+    @property
+    def complete(self) -> bool:
+        return self.result is not None
+
+    def feed(self, chunk: str) -> bool:
+        """
+        Consume the next piece of streamed text.
+
+        Args:
+            chunk: Text received since the previous call
+
+        Returns:
+            True once a complete, valid JSON object has been seen
+        """
+        if self.complete:
+            return True
+
+        base = self.length
+        self.text.append(chunk)
+        self.length += len(chunk)
+
+        for offset, char in enumerate(chunk):
+            if self.in_string:
+                if self.escaped:
+                    self.escaped = False
+                elif char == '\\':
+                    self.escaped = True
+                elif char == '"':
+                    self.in_string = False
+            elif char == '"':
+                if self.depth:
+                    self.in_string = True
+            elif char == '{':
+                if self.depth == 0:
+                    self.start = base + offset
+                self.depth += 1
+            elif char == '}' and self.depth:
+                self.depth -= 1
+                if self.depth == 0:
+                    candidate = ''.join(self.text)[self.start:base + offset + 1]
+                    try:
+                        if isinstance(json.loads(candidate), dict):
+                            self.result = candidate
+                            return True
+                    except json.JSONDecodeError:
+                        pass
+        return False
+
+
+class LLMResponseCache:
+    """
+    Persistent cache of parsed LLM answers.
+
+    Entries are keyed by a hash of everything that determines the answer
+    (model, prompt template version, signature and comment) and hold the
+    parsed semantic information rather than the raw response text. The
+    file is shared safely between processes: saves merge with the file
+    under a lock and replace it atomically.
+
+    Reads refresh an entry's recency in memory. The file is rewritten
+    after new answers were stored, or when a read entry's stored recency
+    is older than the refresh interval, and that write carries the
+    recency of everything read in the meantime. A run answered entirely
+    from recently used entries therefore leaves the file untouched, while
+    eviction still follows use.
+    """
+
+    def __init__(self,
+                 cache_path: Path = DEFAULT_CACHE_PATH,
+                 ttl: Optional[float] = DEFAULT_CACHE_TTL,
+                 max_entries: int = DEFAULT_CACHE_MAX_ENTRIES,
+                 refresh_interval: float = DEFAULT_CACHE_REFRESH):
+        """
+        Initialize the cache.
+
+        Args:
+            cache_path: Path to the cache file
+            ttl: Seconds after which an entry expires, or None to never expire
+            max_entries: Maximum number of entries kept (least recently used are evicted)
+            refresh_interval: Seconds after which a hit's stored recency is stale enough to save
+        """
+        self.cache_path = Path(cache_path)
+        self.ttl = ttl
+        self.max_entries = max_entries
+        self.refresh_interval = refresh_interval
+        self.entries = self._load()
+        self.dirty = False
+        self.hits = 0
+        self.misses = 0
+
+    @staticmethod
+    def make_key(model: str, signature: str, comment: str) -> str:
+        """
+        Build the cache key for one function.
+
+        Args:
+            model: LLM model name
+            signature: Function signature
+            comment: Associated comment
+
+        Returns:
+            Hex digest identifying the query
+        """
+        material = json.dumps([model, FEW_SHOT_TEMPLATE_VERSION, signature, comment])
+        return hashlib.sha256(material.encode('utf-8')).hexdigest()
+
+    def _load(self) -> Dict[str, Dict[str, Any]]:
+        """Load cache entries from disk, ignoring a missing or corrupt file."""
+        try:
+            with open(self.cache_path, 'r', encoding='utf-8') as f:
+                entries = json.load(f)
+            return entries if isinstance(entries, dict) else {}
+        except (IOError, json.JSONDecodeError):
+            return {}
+
+    def _expired(self, entry: Dict[str, Any], now: float) -> bool:
+        return self.ttl is not None and now - entry.get("created", 0) > self.ttl
+
+    def get(self, key: str) -> Optional[Dict[str, Any]]:
+        """
+        Look up a cached answer.
+
+        Args:
+            key: Cache key from make_key()
+
+        Returns:
+            Cached semantic information (possibly empty), or None on a miss
+        """
+        now = time.time()
+        entry = self.entries.get(key)
+        if entry is None or self._expired(entry, now):
+            self.misses += 1
+            return None
+        if now - entry.get("accessed", 0) > self.refresh_interval:
+            self.dirty = True
+        entry["accessed"] = now
+        self.hits += 1
+        return entry["info"]
+
+    def put(self, key: str, info: Dict[str, Any]) -> None:
+        """
+        Store a parsed answer.
+
+        Args:
+            key: Cache key from make_key()
+            info: Parsed semantic information (empty if the answer carried none)
+        """
+        now = time.time()
+        self.entries[key] = {"info": info, "created": now, "accessed": now}
+        self.dirty = True
+
+    def save(self) -> None:
+        """Merge with the on-disk cache, apply TTL and size limits and write it back if anything changed."""
+        if not self.dirty:
+            return
+
+        with FileLock(self.cache_path):
+            merged = self._load()
+            for key, entry in self.entries.items():
+                current = merged.get(key)
+                if current is None or current.get("created", 0) <= entry.get("created", 0):
+                    merged[key] = entry
+                else:
+                    current["accessed"] = max(current.get("accessed", 0), entry.get("accessed", 0))
+
+            now = time.time()
+            merged = {k: v for k, v in merged.items() if not self._expired(v, now)}
+            if len(merged) > self.max_entries:
+                newest = sorted(merged.items(), key=lambda kv: kv[1].get("accessed", 0), reverse=True)
+                merged = dict(newest[:self.max_entries])
+
+            atomic_write_json(self.cache_path, merged, indent=None)
+
+        self.entries = merged
+        self.dirty = False
+
+
+class AuxiliaryLayer:
+    """
+    AI auxiliary layer for extracting semantic hints from C code comments.
+
+    This class manages communication with local LLMs to extract precise semantic
+    information about Python/C API functions from their comments and documentation.
+    """
+
+    def __init__(self,
+                 llm_endpoint: str = DEFAULT_LLM_ENDPOINT,
+                 timeout: int = DEFAULT_TIMEOUT,
+                 max_retries: int = DEFAULT_MAX_RETRIES,
+                 max_workers: int = DEFAULT_MAX_WORKERS,
+                 rate_limit: Optional[float] = DEFAULT_RATE_LIMIT,
+                 adaptive_timeout: bool = True,
+                 breaker_threshold: int = DEFAULT_BREAKER_THRESHOLD,
+                 breaker_reset: float = DEFAULT_BREAKER_RESET,
+                 model: str = DEFAULT_LLM_MODEL,
+                 stream: bool = DEFAULT_STREAM,
+                 cache: Optional[LLMResponseCache] = None,
+                 use_cache: bool = True,
+                 batch_size: int = DEFAULT_BATCH_SIZE,
+                 batch_token_budget: int = DEFAULT_BATCH_TOKEN_BUDGET,
+                 use_heuristics: bool = True,
+                 semantic_db=None,
+                 verbose: bool = False):
+        """
+        Initialize the auxiliary layer.
+
+        Args:
+            llm_endpoint: API endpoint for the local LLM
+            timeout: Request timeout in seconds (the ceiling when timeouts adapt)
+            max_retries: Maximum number of retry attempts
+            max_workers: Maximum number of concurrent LLM requests
+            rate_limit: Maximum requests per second to the endpoint, or None
+            adaptive_timeout: Derive timeouts from the endpoint's observed latency percentiles
+            breaker_threshold: Consecutive failures that stop further requests, 0 disables the breaker
+            breaker_reset: Seconds before a stopped endpoint is probed again
+            model: LLM model name
+            stream: Stream completions and close the connection once the JSON answer is complete
+            cache: Response cache to use (default: one at DEFAULT_CACHE_PATH)
+            use_cache: Whether to consult and fill the response cache
+            batch_size: Maximum functions packed into one request (1 disables batching)
+            batch_token_budget: Estimated token budget of one batched request
+            use_heuristics: Resolve unambiguous comments without calling the LLM
+            semantic_db: SemanticDatabase whose known functions are not queried
+            verbose: Enable verbose logging
+        """
+        self.llm_endpoint = llm_endpoint
+        self.model = model
+        self.stream = stream
+        self.timeout = timeout
+        self.max_retries = max_retries
+        self.max_workers = max(1, max_workers)
+        self.rate_limiter = get_rate_limiter(llm_endpoint, rate_limit)
+        self.latency = get_latency_tracker(llm_endpoint) if adaptive_timeout else None
+        self.breaker = get_circuit_breaker(llm_endpoint, breaker_threshold, breaker_reset)
+        self.cache = (cache or LLMResponseCache()) if use_cache else None
+        self.batch_size = max(1, batch_size)
+        self.batch_token_budget = batch_token_budget
+        self.use_heuristics = use_heuristics
+        self.semantic_db = semantic_db
+        self.report: Dict[str, int] = {}
+        self.skipped_requests: List[int] = []
+        self._parser = None
+        self.verbose = verbose
+        self.logger = self._setup_logger(verbose)
+
+        self.logger.info(f"Initialized auxiliary layer with LLM endpoint: {llm_endpoint}")
+
+    def _setup_logger(self, verbose: bool) -> logging.Logger:
+        """Set up logging configuration."""
+        logger = logging.getLogger(__name__)
+        if not logger.handlers:
+            handler = logging.StreamHandler()
+            formatter = logging.Formatter(
+                '%(asctime)s - %(name)s - %(levelname)s - %(message)s'
+            )
+            handler.setFormatter(formatter)
+            logger.addHandler(handler)
+
+        logger.setLevel(logging.DEBUG if verbose else logging.INFO)
+        return logger
+
+    def _create_few_shot_prompt(self, batch: bool = False) -> str:
+        """
+        Create a few-shot learning prompt with examples.
+
+        Args:
+            batch: Build the variant that asks about several functions at once
+
+        Returns:
+            Few-shot prompt string
+        """
+        examples = [
+            {
+                "input": """
+/*
+ * Creates a new Python list object.
+ * Returns a new reference or NULL on failure.
+ */
+PyObject* my_create_list(int size)""",
+                "output": """
+{{
+    "my_create_list": {{
+        "return_ref_type": "new_ref",
+        "arg_ref_steal": {{}},
+        "error_return": "NULL"
+    }}
+}}"""
+            },
+            {
+                "input": """
+/*
+ * Appends an item to the list, stealing the reference.
+ * Returns 0 on success, -1 on failure.
+ */
+int list_append_steal(PyObject* list, PyObject* item)""",
+                "output": """
+{{
+    "list_append_steal": {{
+        "return_ref_type": "none",
+        "arg_ref_steal": {{
+            "1": true
+        }},
+        "error_return": "-1"
+    }}
+}}"""
+            },
+            {
+                "input": """
+/*
+ * Gets an item from the dictionary without changing reference count.
+ * Returns borrowed reference, NULL if key not found.
+ */
+PyObject* dict_get_borrowed(PyObject* dict, const char* key)""",
+                "output": """
+{{
+    "dict_get_borrowed": {{
+        "return_ref_type": "borrowed_ref",
+        "arg_ref_steal": {{}},
+        "error_return": "NULL"
+    }}
+}}"""
+            }
+        ]
+
+        prompt_parts = [
+            "You are an expert in the Python/C API. Your task is to analyze C function signatures and their associated comments to extract semantic information about reference counting and error handling.",
+            "",
+            "You must respond ONLY with a valid JSON object containing the semantic information.",
+            "",
+            "The semantic information should include:",
+            "- return_ref_type: \"new_ref\", \"borrowed_ref\", or \"none\"",
+            "- arg_ref_steal: object mapping argument indices to true if they steal references",
+            "- error_return: the value indicating failure (\"NULL\", \"-1\", etc.) or null",
+            "",
+            "Here are some examples:"
+        ]
+
+        for i, example in enumerate(examples, 1):
+            prompt_parts.extend([
+                f"Example {i}:",
+                "Input:",
+                "```c",
+                example["input"].strip(),
+                "```",
+                "",
+                "Output:",
+                "```json",
+                example["output"].strip(),
+                "```",
+                ""
+            ])
+
+        if batch:
+            prompt_parts.extend([
+                "Now analyze each of the following functions. Respond with a single JSON object "
+                "with one entry per function, keyed by function name:",
+                "",
+                "{function_input}",
+                "",
+                "Output:",
+                "```json"
+            ])
+            return "\n".join(prompt_parts)
+
+        prompt_parts.extend([
+            "Now analyze the following function and provide the semantic information:",
+            "",
+            "Input:",
+            "```c",
+            "{function_input}",
+            "```",
+            "",
+            "Output:",
+            "```json"
+        ])
+
+        return "\n".join(prompt_parts)
+
+    def _extract_function_signatures_and_comments(self, c_code: str) -> List[Tuple[str, str, str]]:
+        """
+        Extract function signatures and their associated comments from C code.
+
+        Args:
+            c_code: C source code string
+
+        Returns:
+            List of tuples (function_name, signature, comment)
+        """
+        ast = self._parse_source(c_code)
+        return self.extract_functions_from_ast(ast, c_code) if ast is not None else []
+
+    def _parse_source(self, c_code: str) -> Optional[c_ast.FileAST]:
+        """
+        Parse C code with the LISA-IR parser.
+
+        Args:
+            c_code: C source code string
+
+        Returns:
+            Parsed translation unit, or None if parsing failed
+        """
+        if self._parser is None:
+            from lisa_ir.parsers.c_parser import CCodeParser
+            self._parser = CCodeParser(verbose=self.verbose)
+
+        try:
+            return self._parser.parse(c_code)
+        except RuntimeError as e:
+            self.logger.warning(f"Could not parse C code for function extraction: {e}")
+            return None
+
+    def _plan_work(self, functions: List[Tuple[str, str, str]],
+                   entry_points: List[str]) -> Tuple[List[Tuple[str, str, str]], Dict[str, Dict[str, Any]]]:
+        """
+        Decide which functions need classifying and in what order.
+
+        Functions the semantic database already describes are dropped, and
+        functions whose signature fixes their semantics are resolved on the
+        spot. The rest are ordered with exported PyMethodDef entry points
+        first, keeping source order within each group.
+
+        Args:
+            functions: List of (func_name, signature, comment) tuples
+            entry_points: C functions registered in PyMethodDef tables
+
+        Returns:
+            Tuple (functions still to classify, semantic info resolved from signatures)
+        """
+        planned = []
+        resolved: Dict[str, Dict[str, Any]] = {}
+
+        for func_name, signature, comment in functions:
+            if self.semantic_db is not None and self.semantic_db.has_function(func_name):
+                self.logger.debug(f"Skipping {func_name}: already in the semantic database")
+                self.report["known"] += 1
+                continue
+
+            info = classify_by_signature(signature)
+            if info is not None:
+                self.logger.debug(f"Resolved {func_name} from its signature")
+                resolved[func_name] = {func_name: info}
+                self.report["signature"] += 1
+                continue
+
+            planned.append((func_name, signature, comment))
+
+        exported = set(entry_points)
+        planned.sort(key=lambda item: item[0] not in exported)
+        self.report["entry_points"] = sum(1 for item in planned if item[0] in exported)
+        return planned, resolved
+
+    def extract_functions_from_ast(self, ast: c_ast.FileAST, c_code: str) -> List[Tuple[str, str, str]]:
+        """
+        Pair the function definitions of a parsed file with their comments.
+
+        Signatures are rendered from the pycparser ``FuncDef`` declarations;
+        comments come from a single scan of the source. Both lists are in
+        line order, so each function picks up the last comment ending just
+        above it in one merged walk, linear in functions plus comments.
+
+        Args:
+            ast: Parsed translation unit
+            c_code: The source the AST was parsed from (for comments)
+
+        Returns:
+            List of tuples (function_name, signature, comment)
+        """
+        generator = c_generator.CGenerator()
+        definitions = []
+        for ext_decl in ast.ext:
+            if not isinstance(ext_decl, c_ast.FuncDef):
+                continue
+            coord = ext_decl.decl.coord
+            if coord is not None and coord.file and coord.file.endswith('.h'):
+                continue  # Inline definitions pulled in from headers
+            definitions.append((coord.line if coord else 0, ext_decl))
+        definitions.sort(key=lambda item: item[0])
+
+        comments = scan_comments(c_code)
+        functions = []
+        next_comment = 0
+        previous_line = 0
+
+        for func_line, func_def in definitions:
+            associated_comment = ""
+            while next_comment < len(comments) and comments[next_comment][1] < func_line:
+                _, comment_end, comment_text = comments[next_comment]
+                if comment_end > previous_line and func_line - comment_end <= MAX_COMMENT_GAP_LINES:
+                    associated_comment = comment_text
+                next_comment += 1
+
+            signature = generator.visit(func_def.decl)
+            functions.append((func_def.decl.name, signature, associated_comment))
+            previous_line = func_line
+
+        return functions
+
+    def _create_function_prompt(self, signature: str, comment: str, few_shot_template: str) -> str:
+        """
+        Create a prompt for analyzing a specific function.
+
+        Args:
+            signature: Function signature
+            comment: Associated comment
+            few_shot_template: Few-shot learning template
+
+        Returns:
+            Complete prompt string
+        """
+        return few_shot_template.format(function_input=self._format_function_input(signature, comment))
+
+    @staticmethod
+    def _format_function_input(signature: str, comment: str) -> str:
+        """Render a signature and its comment the way the few-shot examples do."""
+        return f"/*\n * {comment}\n */\n{signature}" if comment else signature
+
+    @staticmethod
+    def _estimate_tokens(text: str) -> int:
+        """Cheap token estimate (about four characters per token)."""
+        return len(text) // 4 + 1
+
+    def _create_batch_prompt(self, items: List[Tuple[str, str]], batch_template: str) -> str:
+        """
+        Create a prompt asking about several functions at once.
+
+        Args:
+            items: List of (signature, comment) tuples
+            batch_template: Batch variant of the few-shot template
+
+        Returns:
+            Complete prompt string
+        """
+        inputs = "\n\n".join(
+            f"Input {i}:\n```c\n{self._format_function_input(signature, comment)}\n```"
+            for i, (signature, comment) in enumerate(items, 1)
+        )
+        return batch_template.format(function_input=inputs)
+
+    def _plan_batches(self, items: List[Tuple[str, str, str]], batch_template: str) -> List[List[int]]:
+        """
+        Pack functions into batches that fit the token budget.
+
+        Batches are filled greedily in source order: a function joins the
+        current batch while the template, the packed inputs and the
+        expected answers stay within ``batch_token_budget`` and the batch
+        holds fewer than ``batch_size`` functions.
+
+        Args:
+            items: List of (func_name, signature, comment) tuples
+            batch_template: Batch variant of the few-shot template
+
+        Returns:
+            List of batches, each a list of indices into items
+        """
+        overhead = self._estimate_tokens(batch_template)
+        batches: List[List[int]] = []
+        current: List[int] = []
+        used = overhead
+
+        for index, (_, signature, comment) in enumerate(items):
+            cost = self._estimate_tokens(self._format_function_input(signature, comment)) + OUTPUT_TOKENS_PER_FUNCTION
+            if current and (len(current) >= self.batch_size or used + cost > self.batch_token_budget):
+                batches.append(current)
+                current, used = [], overhead
+            current.append(index)
+            used += cost
+
+        if current:
+            batches.append(current)
+        return batches
+
+    def _query_functions(self, items: List[Tuple[str, str, str]],
+                         few_shot_template: str) -> List[Optional[Dict[str, Any]]]:
+        """
+        Ask the LLM about a list of functions.
+
+        With batching enabled, functions are packed into multi-function
+        prompts first. Any function whose batched answer is missing or
+        malformed is retried with its own single-function prompt.
+
+        Args:
+            items: List of (func_name, signature, comment) tuples
+            few_shot_template: Single-function few-shot template
+
+        Returns:
+            Parsed semantic info per item (None if there was no answer or it could not be parsed)
+        """
+        results: List[Optional[Dict[str, Any]]] = [None] * len(items)
+        single: List[int] = list(range(len(items)))
+
+        if self.batch_size > 1 and len(items) > 1:
+            batch_template = self._create_few_shot_prompt(batch=True)
+            batches = [b for b in self._plan_batches(items, batch_template) if len(b) > 1]
+            batched = {i for batch in batches for i in batch}
+            single = [i for i in single if i not in batched]
+
+            prompts = [self._create_batch_prompt([items[i][1:] for i in batch], batch_template)
+                       for batch in batches]
+            self.logger.info(f"Sending {len(batched)} functions in {len(batches)} batched requests")
+
+            for batch, response in zip(batches, self._execute_requests(prompts)):
+                answer = self._parse_llm_response(response) if response else None
+                for index in batch:
+                    func_name = items[index][0]
+                    if answer and func_name in answer:
+                        results[index] = {func_name: answer[func_name]}
+                    else:
+                        single.append(index)
+
+            if single:
+                self.logger.info(f"Falling back to single-function prompts for {len(single)} functions")
+            single.sort()
+
+        prompts = [self._create_function_prompt(items[i][1], items[i][2], few_shot_template) for i in single]
+        responses = self._execute_requests(prompts)
+        self.report["circuit_skipped"] = self.report.get("circuit_skipped", 0) + len(self.skipped_requests)
+        for index, response in zip(single, responses):
+            func_name = items[index][0]
+            if not response:
+                self.logger.warning(f"Failed to get LLM response for {func_name}")
+                continue
+            semantic_info = self._parse_llm_response(response)
+            if not semantic_info:
+                # Not cached either, so the next run asks again
+                self.logger.warning(f"Failed to parse semantic info for {func_name}")
+                continue
+            results[index] = semantic_info
+
+        return results
+
+    def _call_llm_api(self, prompt: str) -> Optional[str]:
+        """
+        Call the local LLM API to extract semantic information.
+
+        Args:
+            prompt: The prompt to send to the LLM
+
+        Returns:
+            LLM response as string, or None if failed
+        """
+        return self._execute_requests([prompt])[0]
+
+    def _request_once(self, prompt: str) -> Tuple[Optional[str], bool]:
+        """
+        Send a single request to the LLM API.
+
+        Args:
+            prompt: The prompt to send to the LLM
+
+        Returns:
+            Tuple (response content or None, whether a failure is worth retrying)
+        """
+        payload = {
+            "model": self.model,
+            "messages": [
+                {
+                    "role": "user",
+                    "content": f"思{prompt}思"  # Add thinking chain markers
+                }
+            ],
+            "temperature": 0.1,  # Low temperature for more deterministic output
+            "stream": self.stream
+        }
+
+        if self.rate_limiter is not None:
+            self.rate_limiter.acquire()
+
+        timeout = self.latency.timeout(self.timeout) if self.latency is not None else self.timeout
+        started = time.monotonic()
+
+        try:
+            response = requests.post(
+                self.llm_endpoint,
+                json=payload,
+                timeout=timeout,
+                headers={"Content-Type": "application/json"},
+                stream=self.stream
+            )
+
+            if response.status_code == 200 and self.stream and \
+                    response.headers.get("Content-Type", "").startswith("text/event-stream"):
+                content = self._read_stream(response, started + timeout)
+                if content is not None:
+                    self._record_latency(started)
+                    return content, False
+                self.logger.warning("LLM API stream ended without a JSON answer")
+
+            elif response.status_code == 200:
+                response_data = response.json()
+
+                # Handle different API response formats
+                if "choices" in response_data and len(response_data["choices"]) > 0:
+                    content = response_data["choices"][0]["message"]["content"]
+                    self.logger.debug(f"LLM response received: {len(content)} characters")
+                    self._record_latency(started)
+                    return content, False
+                else:
+                    self.logger.warning(f"Unexpected LLM API response format: {response_data}")
+
+            else:
+                self.logger.warning(f"LLM API request failed with status {response.status_code}: {response.text}")
+
+        except requests.exceptions.Timeout:
+            # The request ran at least this long, which adaptive timeouts must not undercut
+            self._record_latency(started)
+            self.logger.warning(f"LLM API request timed out after {timeout:.1f}s")
+        except requests.exceptions.ConnectionError:
+            self.logger.warning(f"Failed to connect to LLM API at {self.llm_endpoint}")
+            return None, False  # Don't retry connection errors
+        except requests.exceptions.RequestException as e:
+            self.logger.warning(f"LLM API request error: {e}")
+        except json.JSONDecodeError as e:
+            self.logger.warning(f"Failed to decode LLM API response: {e}")
+        except Exception as e:
+            self.logger.warning(f"Unexpected error calling LLM API: {e}")
+
+        return None, True
+
+    def _record_latency(self, started: float) -> None:
+        """Record the latency of a request started at the given monotonic time."""
+        if self.latency is not None:
+            self.latency.record(time.monotonic() - started)
+
+    def _read_stream(self, response: requests.Response, deadline: float) -> Optional[str]:
+        """
+        Read a server-sent-events completion until its JSON answer is complete.
+
+        The connection is closed as soon as the first top-level JSON object
+        in the streamed content is balanced and valid, so trailing
+        commentary is never generated or transferred. The request timeout
+        only bounds each read, so a server trickling out chunks could keep
+        the stream open indefinitely; the whole answer must therefore
+        arrive before the deadline.
+
+        Args:
+            response: Streaming response of the chat completions endpoint
+            deadline: Monotonic time by which the answer must be complete
+
+        Returns:
+            The JSON object text, or None if the stream ended without one
+
+        Raises:
+            requests.exceptions.ReadTimeout: If the deadline passes first
+        """
+        scanner = JSONStreamScanner()
+        try:
+            for line in response.iter_lines(decode_unicode=True):
+                if time.monotonic() > deadline:
+                    raise requests.exceptions.ReadTimeout(
+                        f"LLM answer incomplete after {scanner.length} streamed characters")
+                if not line or not line.startswith("data:"):
+                    continue
+                data = line[len("data:"):].strip()
+                if data == "[DONE]":
+                    break
+                choices = json.loads(data).get("choices") or [{}]
+                chunk = (choices[0].get("delta") or {}).get("content")
+                if chunk and scanner.feed(chunk):
+                    self.logger.debug(f"LLM answer complete after {scanner.length} streamed characters, "
+                                      f"closing connection")
+                    return scanner.result
+        finally:
+            response.close()
+
+        return None
+
+    def _execute_requests(self, prompts: List[str]) -> List[Optional[str]]:
+        """
+        Send prompts to the LLM with bounded concurrency.
+
+        At most ``max_workers`` requests are in flight. A failed request is
+        rescheduled after an exponential backoff without occupying a worker,
+        so the remaining prompts keep flowing while it waits. While the
+        endpoint's circuit breaker is open, pending prompts are not sent;
+        their indices are left in ``self.skipped_requests``.
+
+        Args:
+            prompts: Prompts to send
+
+        Returns:
+            Responses in the same order as the prompts (None where all attempts failed)
+        """
+        self.skipped_requests = []
+        results: List[Optional[str]] = [None] * len(prompts)
+        attempts = [0] * len(prompts)
+        ready = deque(range(len(prompts)))
+        backoff: List[Tuple[float, int]] = []  # heap of (ready_time, index)
+        in_flight = {}
+
+        with ThreadPoolExecutor(max_workers=self.max_workers) as pool:
+            while ready or backoff or in_flight:
+                now = time.monotonic()
+                while backoff and backoff[0][0] <= now:
+                    ready.append(heapq.heappop(backoff)[1])
+
+                if self.breaker is not None and self.breaker.is_open() and (ready or backoff):
+                    self.skipped_requests.extend(ready)
+                    self.skipped_requests.extend(index for _, index in backoff)
+                    ready.clear()
+                    backoff.clear()
+
+                while ready and len(in_flight) < self.max_workers:
+                    if self.breaker is not None and not self.breaker.allow():
+                        break  # a half-open probe is in flight
+                    index = ready.popleft()
+                    attempts[index] += 1
+                    self.logger.debug(f"Calling LLM API for request {index} "
+                                      f"(attempt {attempts[index]}/{self.max_retries})")
+                    in_flight[pool.submit(self._request_once, prompts[index])] = index
+
+                next_retry = max(0.0, backoff[0][0] - time.monotonic()) if backoff else None
+                if not in_flight:
+                    time.sleep(next_retry if next_retry is not None else 0.05)
+                    continue
+
+                done, _ = wait(in_flight, timeout=next_retry, return_when=FIRST_COMPLETED)
+                for future in done:
+                    index = in_flight.pop(future)
+                    content, retryable = future.result()
+                    if self.breaker is not None:
+                        if content is not None:
+                            self.breaker.record_success()
+                        elif self.breaker.record_failure():
+                            self.logger.warning(f"Circuit breaker open for {self.llm_endpoint} after "
+                                                f"{self.breaker.failures} consecutive failures")
+                    if content is not None:
+                        results[index] = content
+                    elif retryable and attempts[index] < self.max_retries:
+                        delay = 2 ** (attempts[index] - 1)  # Exponential backoff
+                        heapq.heappush(backoff, (time.monotonic() + delay, index))
+
+        self.skipped_requests.sort()
+        return results
+
+    def _parse_llm_response(self, response: str) -> Optional[Dict[str, Any]]:
+        """
+        Parse the LLM response to extract semantic information.
+
+        Args:
+            response: Raw LLM response string
+
+        Returns:
+            Parsed semantic information dictionary, or None if parsing failed
+        """
+        if not response:
+            return None
+
+        try:
+            # Remove thinking chain markers if present
+            if response.startswith("思") and response.endswith("思"):
+                response = response[1:-1].strip()
+
+            # Try to extract JSON from the response
+            # Look for JSON code blocks
+            json_match = re.search(r'```json\s*(.*?)\s*```', response, re.DOTALL)
+            if json_match:
+                json_str = json_match.group(1).strip()
+            else:
+                # Look for JSON object in the response
+                json_start = response.find('{')
+                if json_start != -1:
+                    # Find the matching closing brace
+                    brace_count = 0
+                    for i in range(json_start, len(response)):
+                        if response[i] == '{':
+                            brace_count += 1
+                        elif response[i] == '}':
+                            brace_count -= 1
+                            if brace_count == 0:
+                                json_str = response[json_start:i+1]
+                                break
+                    else:
+                        # If we didn't find a matching brace, take everything from first {
+                        json_str = response[json_start:].strip()
+                else:
+                    # If no JSON object found, try to parse the whole response
+                    json_str = response.strip()
+
+            # Clean up common issues
+            json_str = json_str.replace('\n', ' ').replace('\r', '')
+            json_str = re.sub(r'\s+', ' ', json_str).strip()
+
+            # Parse the JSON
+            semantic_info = json.loads(json_str)
+
+            # Validate the semantic information structure
+            if not isinstance(semantic_info, dict):
+                self.logger.warning("LLM response is not a dictionary")
+                return None
+
+            # Validate each function's semantic info
+            validated_info = {}
+            for func_name, info in semantic_info.items():
+                if not isinstance(info, dict):
+                    continue
+
+                validated_func_info = {}
+
+                # Validate return_ref_type
+                if "return_ref_type" in info:
+                    if info["return_ref_type"] in ["new_ref", "borrowed_ref", "none"]:
+                        validated_func_info["return_ref_type"] = info["return_ref_type"]
+                    else:
+                        self.logger.warning(f"Invalid return_ref_type for {func_name}: {info['return_ref_type']}")
+
+                # Validate arg_ref_steal
+                if "arg_ref_steal" in info:
+                    if isinstance(info["arg_ref_steal"], dict):
+                        validated_func_info["arg_ref_steal"] = info["arg_ref_steal"]
+                    else:
+                        self.logger.warning(f"Invalid arg_ref_steal for {func_name}: must be a dictionary")
+
+                # Validate error_return
+                if "error_return" in info:
+                    validated_func_info["error_return"] = info["error_return"]
+
+                if validated_func_info:
+                    validated_info[func_name] = validated_func_info
+
+            return validated_info if validated_info else None
+
+        except json.JSONDecodeError as e:
+            self.logger.warning(f"Failed to parse LLM JSON response: {e}")
+            self.logger.debug(f"Response content: {response}")
+            return None
+        except Exception as e:
+            self.logger.warning(f"Error parsing LLM response: {e}")
+            return None
+
+    def extract_semantic_hints(self, c_code: str) -> Dict[str, Dict[str, Any]]:
+        """
+        Extract semantic hints from C code using AI assistance.
+
+        Args:
+            c_code: C source code string
+
+        Returns:
+            Dictionary mapping function names to their semantic information
+        """
+        self.logger.info("Starting AI-assisted semantic extraction")
+
+        ast = self._parse_source(c_code)
+        if ast is None:
+            return {}
+        return self.extract_semantic_hints_from_ast(ast, c_code)
+
+    def extract_semantic_hints_from_ast(self, ast: c_ast.FileAST, c_code: str) -> Dict[str, Dict[str, Any]]:
+        """
+        Extract semantic hints for the functions of an already parsed file.
+
+        Args:
+            ast: Parsed translation unit
+            c_code: The source the AST was parsed from (for comments)
+
+        Returns:
+            Dictionary mapping function names to their semantic information
+        """
+        from lisa_ir.parsers.method_tables import exported_functions
+
+        # Extract functions and their comments
+        functions = self.extract_functions_from_ast(ast, c_code)
+        self.logger.info(f"Found {len(functions)} functions")
+
+        if not functions:
+            self.logger.info("No functions found")
+            return {}
+
+        # Create few-shot learning template
+        few_shot_template = self._create_few_shot_prompt()
+
+        self.report = {"functions": len(functions), "known": 0, "signature": 0, "entry_points": 0,
+                       "skipped": 0, "heuristic": 0, "cached": 0, "llm": 0, "circuit_skipped": 0}
+        planned, cached_info = self._plan_work(functions, exported_functions(ast))
+
+        # Answer from heuristics or the cache where possible, build prompts for the rest
+        work_items = []
+        for func_name, signature, comment in planned:
+            # Skip if comment is empty or too short
+            if not comment or len(comment.strip()) < 10:
+                self.logger.debug(f"Skipping {func_name}: no meaningful comment")
+                self.report["skipped"] += 1
+                continue
+
+            if self.use_heuristics:
+                info = classify_by_heuristics(signature, comment)
+                if info is not None:
+                    self.logger.debug(f"Resolved {func_name} from comment heuristics")
+                    cached_info[func_name] = {func_name: info}
+                    self.report["heuristic"] += 1
+                    continue
+
+            cache_key = LLMResponseCache.make_key(self.model, signature, comment)
+            if self.cache is not None:
+                info = self.cache.get(cache_key)
+                if info is not None:
+                    self.logger.debug(f"Using cached semantic info for {func_name}")
+                    cached_info[func_name] = info
+                    self.report["cached"] += 1
+                    continue
+
+            work_items.append((func_name, cache_key, signature, comment))
+
+        self.report["llm"] = len(work_items)
+        self.logger.info(f"Plan: {self.report['functions']} functions, {self.report['known']} known to the "
+                         f"semantic database, {self.report['signature']} determined by signature, "
+                         f"{self.report['skipped']} without a usable comment, {self.report['heuristic']} "
+                         f"resolved by heuristics, {self.report['cached']} from cache")
+        self.logger.info(f"Plan: querying LLM for {len(work_items)} functions "
+                         f"({self.report['entry_points']} exported entry points first) "
+                         f"with up to {self.max_workers} concurrent requests")
+        answers = self._query_functions([(name, sig, comment) for name, _, sig, comment in work_items],
+                                        few_shot_template)
+        if self.report["circuit_skipped"]:
+            self.logger.warning(f"Circuit breaker skipped {self.report['circuit_skipped']} functions; "
+                                f"they keep database-only semantics")
+
+        fresh_info: Dict[str, Dict[str, Any]] = {}
+        for (func_name, cache_key, _, _), semantic_info in zip(work_items, answers):
+            if semantic_info is None:
+                continue
+            self.logger.info(f"Successfully extracted semantic info for {func_name}")
+            fresh_info[func_name] = semantic_info
+            if self.cache is not None:
+                self.cache.put(cache_key, semantic_info)
+
+        if self.cache is not None:
+            self.cache.save()
+
+        # Merge results in source order so the output is deterministic
+        all_semantic_info = {}
+        for func_name, _, _ in functions:
+            info = cached_info.get(func_name) or fresh_info.get(func_name)
+            if info:
+                all_semantic_info.update(info)
+
+        self.logger.info(f"AI extraction completed: semantic info for {len(all_semantic_info)} functions")
+        return all_semantic_info
+
+
+def extract_semantic_hints(c_code: str,
+                          llm_endpoint: str = DEFAULT_LLM_ENDPOINT,
+                          timeout: int = DEFAULT_TIMEOUT,
+                          max_retries: int = DEFAULT_MAX_RETRIES,
+                          max_workers: int = DEFAULT_MAX_WORKERS,
+                          rate_limit: Optional[float] = DEFAULT_RATE_LIMIT,
+                          adaptive_timeout: bool = True,
+                          breaker_threshold: int = DEFAULT_BREAKER_THRESHOLD,
+                          breaker_reset: float = DEFAULT_BREAKER_RESET,
+                          stream: bool = DEFAULT_STREAM,
+                          use_cache: bool = True,
+                          batch_size: int = DEFAULT_BATCH_SIZE,
+                          batch_token_budget: int = DEFAULT_BATCH_TOKEN_BUDGET,
+                          use_heuristics: bool = True,
+                          verbose: bool = False) -> Dict[str, Dict[str, Any]]:
+    """
+    Convenience function to extract semantic hints from C code.
+
+    Args:
+        c_code: C source code string
+        llm_endpoint: API endpoint for the local LLM
+        timeout: Request timeout in seconds
+        max_retries: Maximum number of retry attempts
+        max_workers: Maximum number of concurrent LLM requests
+        rate_limit: Maximum requests per second to the endpoint, or None
+        adaptive_timeout: Derive timeouts from the endpoint's observed latency percentiles
+        breaker_threshold: Consecutive failures that stop further requests, 0 disables the breaker
+        breaker_reset: Seconds before a stopped endpoint is probed again
+        stream: Stream completions and close the connection once the JSON answer is complete
+        use_cache: Whether to use the on-disk LLM response cache
+        batch_size: Maximum functions packed into one request (1 disables batching)
+        batch_token_budget: Estimated token budget of one batched request
+        use_heuristics: Resolve unambiguous comments without calling the LLM
+        verbose: Enable verbose logging
+
+    Returns:
+        Dictionary mapping function names to their semantic information
+    """
+    auxiliary = AuxiliaryLayer(
+        llm_endpoint=llm_endpoint,
+        timeout=timeout,
+        max_retries=max_retries,
+        max_workers=max_workers,
+        rate_limit=rate_limit,
+        adaptive_timeout=adaptive_timeout,
+        breaker_threshold=breaker_threshold,
+        breaker_reset=breaker_reset,
+        stream=stream,
+        use_cache=use_cache,
+        batch_size=batch_size,
+        batch_token_budget=batch_token_budget,
+        use_heuristics=use_heuristics,
+        verbose=verbose
+    )
+    return auxiliary.extract_semantic_hints(c_code)
+
+
+def test_llm_connection(llm_endpoint: str = DEFAULT_LLM_ENDPOINT,
+                       timeout: int = 10) -> bool:
+    """
+    Test connection to the local LLM endpoint.
+
+    Args:
+        llm_endpoint: API endpoint for the local LLM
+        timeout: Request timeout in seconds
+
+    Returns:
+        True if connection is successful, False otherwise
+    """
+    try:
+        payload = {
+            "model": DEFAULT_LLM_MODEL,
+            "messages": [{"role": "user", "content": "思Hello思"}],
+            "temperature": 0.1,
+            "max_tokens": 10
+        }
+
+        response = requests.post(
+            llm_endpoint,
+            json=payload,
+            timeout=timeout,
+            headers={"Content-Type": "application/json"}
+        )
+
+        if response.status_code == 200:
+            print(f"[OK] Successfully connected to LLM at {llm_endpoint}")
+            return True
+        else:
+            print(f"[ERROR] LLM API returned status {response.status_code}: {response.text}")
+            return False
+
+    except requests.exceptions.ConnectionError:
+        print(f"[ERROR] Failed to connect to LLM at {llm_endpoint}")
+        print("  Make sure your local LLM server is running and accessible")
+        return False
+    except Exception as e:
+        print(f"[ERROR] Error testing LLM connection: {e}")
+        return False
+
+
+def main():
+    """Command-line interface for testing the auxiliary layer."""
+    import argparse
+    import sys
+    import os
+
+    parser = argparse.ArgumentParser(
+        description="Test the AI auxiliary layer for semantic extraction"
+    )
+    parser.add_argument(
+        "c_file",
+        nargs="?",
+        help="C source file to analyze"
+    )
+    parser.add_argument(
+        "--endpoint",
+        default=DEFAULT_LLM_ENDPOINT,
+        help=f"LLM API endpoint (default: {DEFAULT_LLM_ENDPOINT})"
+    )
+    parser.add_argument(
+        "--test-connection",
+        action="store_true",
+        help="Test connection to LLM endpoint"
+    )
+    parser.add_argument(
+        "--timeout",
+        type=int,
+        default=DEFAULT_TIMEOUT,
+        help=f"Request timeout in seconds (default: {DEFAULT_TIMEOUT})"
+    )
+    parser.add_argument(
+        "--max-workers",
+        type=int,
+        default=DEFAULT_MAX_WORKERS,
+        help=f"Maximum concurrent LLM requests (default: {DEFAULT_MAX_WORKERS})"
+    )
+    parser.add_argument(
+        "--rate-limit",
+        type=float,
+        default=DEFAULT_RATE_LIMIT,
+        help="Maximum requests per second to the endpoint (default: unlimited)"
+    )
+    parser.add_argument(
+        "--no-adaptive-timeout",
+        action="store_true",
+        help="Always use --timeout instead of deriving timeouts from observed latencies"
+    )
+    parser.add_argument(
+        "--breaker-threshold",
+        type=int,
+        default=DEFAULT_BREAKER_THRESHOLD,
+        help=f"Consecutive failures that stop further LLM requests, 0 disables "
+             f"(default: {DEFAULT_BREAKER_THRESHOLD})"
+    )
+    parser.add_argument(
+        "--breaker-reset",
+        type=float,
+        default=DEFAULT_BREAKER_RESET,
+        help=f"Seconds before a stopped endpoint is probed again (default: {DEFAULT_BREAKER_RESET:g})"
+    )
+    parser.add_argument(
+        "--no-stream",
+        action="store_true",
+        help="Wait for complete LLM responses instead of streaming them"
+    )
+    parser.add_argument(
+        "--batch-size",
+        type=int,
+        default=DEFAULT_BATCH_SIZE,
+        help=f"Maximum functions per LLM request, 1 disables batching (default: {DEFAULT_BATCH_SIZE})"
+    )
+    parser.add_argument(
+        "--batch-token-budget",
+        type=int,
+        default=DEFAULT_BATCH_TOKEN_BUDGET,
+        help=f"Estimated token budget of one batched request (default: {DEFAULT_BATCH_TOKEN_BUDGET})"
+    )
+    parser.add_argument(
+        "--semantic-db",
+        default=None,
+        help="Semantic database whose known functions are not sent to the LLM"
+    )
+    parser.add_argument(
+        "--no-heuristics",
+        action="store_true",
+        help="Send every function to the LLM instead of resolving unambiguous comments locally"
+    )
+    parser.add_argument(
+        "--llm-cache",
+        default=None,
+        help=f"LLM response cache file (default: {DEFAULT_CACHE_PATH})"
+    )
+    parser.add_argument(
+        "--no-llm-cache",
+        action="store_true",
+        help="Ignore and do not update the on-disk LLM response cache"
+    )
+    parser.add_argument(
+        "--verbose",
+        action="store_true",
+        help="Enable verbose logging"
+    )
+
+    args = parser.parse_args()
+
+    if args.test_connection:
+        success = test_llm_connection(args.endpoint, args.timeout)
+        sys.exit(0 if success else 1)
+
+    if not args.c_file:
+        parser.error("C source file is required (unless --test-connection is used)")
+
+    if not os.path.exists(args.c_file):
+        print(f"Error: File not found: {args.c_file}")
+        sys.exit(1)
+
+    try:
+        with open(args.c_file, 'r', encoding='utf-8') as f:
+            c_code = f.read()
+
+        semantic_db = None
+        if args.semantic_db:
+            from lisa_ir.database.semantic_db import SemanticDatabase
+            semantic_db = SemanticDatabase(args.semantic_db)
+
+        print(f"Analyzing C file: {args.c_file}")
+        print(f"Using LLM endpoint: {args.endpoint}")
+
+        auxiliary = AuxiliaryLayer(
+            llm_endpoint=args.endpoint,
+            timeout=args.timeout,
+            max_workers=args.max_workers,
+            rate_limit=args.rate_limit,
+            adaptive_timeout=not args.no_adaptive_timeout,
+            breaker_threshold=args.breaker_threshold,
+            breaker_reset=args.breaker_reset,
+            stream=not args.no_stream,
+            cache=LLMResponseCache(args.llm_cache) if args.llm_cache else None,
+            use_cache=not args.no_llm_cache,
+            batch_size=args.batch_size,
+            batch_token_budget=args.batch_token_budget,
+            use_heuristics=not args.no_heuristics,
+            semantic_db=semantic_db,
+            verbose=args.verbose
+        )
+        semantic_hints = auxiliary.extract_semantic_hints(c_code)
+
+        report = auxiliary.report
+        if report:
+            print(f"\nFunctions: {report['functions']} found, {report['known']} known to the semantic database, "
+                  f"{report['signature']} determined by signature, {report['skipped']} without a usable comment, "
+                  f"{report['heuristic']} resolved by heuristics, {report['cached']} from cache, "
+                  f"{report['llm']} sent to the LLM ({report['entry_points']} exported entry points)")
+            if report['circuit_skipped']:
+                print(f"Circuit breaker: {report['circuit_skipped']} functions skipped, "
+                      f"database-only semantics kept")
+
+        if semantic_hints:
+            print(f"\nExtracted semantic information for {len(semantic_hints)} functions:")
+            print(json.dumps(semantic_hints, indent=2, ensure_ascii=False))
+        else:
+            print("No semantic information extracted")
+
+    except Exception as e:
+        print(f"Error: {e}")
+        if args.verbose:
+            import traceback
+            traceback.print_exc()
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
\ No newline at end of file
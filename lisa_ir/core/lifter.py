@@ -7,6 +7,7 @@ into the LISA intermediate representation with semantic preservation.
 
 import logging
 import os
+from concurrent.futures import ThreadPoolExecutor
 from typing import Dict, List, Optional, Any, Union
 from pathlib import Path
 
@@ -14,6 +15,7 @@ from pycparser import c_ast
 
 from lisa_ir.ir.ir_nodes import Module, FuncDef, BasicBlock, Operation, Expression
 from lisa_ir.core.ast_converter import ASTConverter
+from lisa_ir.database.call_index import CallSiteIndex
 from lisa_ir.database.semantic_db import SemanticDatabase
 from lisa_ir.utils.logger import get_logger
 
@@ -26,22 +28,36 @@ class Lifter:
     - C code parsing
     - AST to IR conversion
     - Semantic information integration
+    - Optional AI hints from comments (auxiliary layer)
+    - Optional call site index maintenance for targeted re-analysis
     - Error handling and reporting
     """
     
     def __init__(self, 
                  semantic_db_path: Optional[str] = None,
-                 verbose: bool = False):
+                 verbose: bool = False,
+                 ai_hints: bool = False,
+                 ai_options: Optional[Dict[str, Any]] = None,
+                 call_index_path: Optional[str] = None):
         """
         Initialize the lifter.
         
         Args:
             semantic_db_path: Path to the semantic database
             verbose: Enable verbose logging
+            ai_hints: Run the auxiliary layer on the parsed source and commit its hints to the database
+            ai_options: Extra AuxiliaryLayer keyword arguments (endpoint, workers, batching, ...)
+            call_index_path: Call site index to record the calls of every lifted file in
+                             (under its absolute path)
         """
         self.logger = get_logger("Lifter", level=logging.DEBUG if verbose else logging.INFO)
+        self.verbose = verbose
         self.semantic_db = SemanticDatabase(semantic_db_path) if semantic_db_path else SemanticDatabase()
         self.ast_converter = ASTConverter(self.semantic_db)
+        self.ai_hints = ai_hints
+        self.ai_options = dict(ai_options or {})
+        self.ai_report: Dict[str, int] = {}
+        self.call_index = CallSiteIndex(call_index_path) if call_index_path else None
         
         self.logger.info("Lifter initialized successfully")
     
@@ -90,9 +106,19 @@ class Lifter:
             else:
                 ast = parser.parse(c_code)
             
+            # Annotations of the headers this file includes fill in APIs the database does not describe
+            self.semantic_db.set_builtin_headers(parser.header_sources)
+            
             # Convert AST to LISA IR
             self.logger.debug("Converting AST to LISA IR")
-            ir_module = self.ast_converter.convert_ast(ast, source_path or "<input>")
+            if self.ai_hints:
+                ir_module = self._convert_with_ai_hints(ast, c_code, source_path or "<input>")
+            else:
+                ir_module = self.ast_converter.convert_ast(ast, source_path or "<input>")
+            
+            if self.call_index is not None and source_path:
+                sites = self.call_index.update_module(ir_module, os.path.abspath(source_path))
+                self.logger.debug(f"Recorded {sites} call sites of {source_path} in the call site index")
             
             self.logger.info("Code lifting completed successfully")
             return ir_module
@@ -101,6 +127,48 @@ class Lifter:
             self.logger.error(f"Error during code lifting: {e}")
             raise
     
+    def _convert_with_ai_hints(self, ast: c_ast.FileAST, c_code: str, source_path: str) -> Module:
+        """
+        Convert an AST while the auxiliary layer extracts hints from the same AST.
+        
+        Functions that do not call a locally defined function missing from
+        the semantic database are converted while the hints are being
+        extracted. The hints are then committed to the database in one
+        batch and the remaining functions are converted with them.
+        
+        Args:
+            ast: The parsed translation unit
+            c_code: The source the AST was parsed from (for comments)
+            source_path: Source file path for coordinate tracking
+            
+        Returns:
+            Module: The converted IR module
+        """
+        from lisa_ir.core.auxiliary_layer import AuxiliaryLayer
+        
+        auxiliary = AuxiliaryLayer(semantic_db=self.semantic_db, verbose=self.verbose, **self.ai_options)
+        pending = {ext.decl.name for ext in ast.ext
+                   if isinstance(ext, c_ast.FuncDef) and not self.semantic_db.has_function(ext.decl.name)}
+        self.ai_report = {}
+        
+        with ThreadPoolExecutor(max_workers=1) as pool:
+            hints_future = pool.submit(auxiliary.extract_semantic_hints_from_ast, ast, c_code)
+            
+            def commit_hints():
+                try:
+                    hints = hints_future.result()
+                except Exception as e:
+                    self.logger.warning(f"AI hints stage failed, continuing with database semantics: {e}")
+                    hints = {}
+                committed = self.semantic_db.bulk_update(
+                    [{"func_name": name, "info": info} for name, info in hints.items()]
+                ) if hints else 0
+                self.ai_report = dict(auxiliary.report, committed=committed)
+                self.logger.info(f"AI hints stage committed {committed} entries to the semantic database")
+            
+            return self.ast_converter.convert_ast(ast, source_path, defer=pending,
+                                                  before_deferred=commit_hints)
+    
     def lift_ast(self, ast: c_ast.Node, source_path: str = "<input>") -> Module:
         """
         Lift a pycparser AST to LISA IR.
@@ -123,6 +191,20 @@ class Lifter:
             self.logger.error(f"Error during AST lifting: {e}")
             raise
     
+    def get_stats(self) -> Dict[str, Any]:
+        """
+        Get statistics about the most recent lift.
+        
+        Returns:
+            Dictionary of statistics, including semantic lookup hit/miss counters
+        """
+        stats = {
+            "semantic_lookups": self.ast_converter.lookup_cache.get_stats()
+        }
+        if self.ai_report:
+            stats["ai_hints"] = self.ai_report
+        return stats
+    
     def update_semantic_db(self, semantic_info: Dict[str, Any]) -> None:
         """
         Update the semantic database with new information.
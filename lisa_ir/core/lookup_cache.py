@@ -0,0 +1,106 @@
+"""
+Semantic lookup cache for the AST converter
+
+Most call statements in an extension module target user functions or
+libc, which are not in the semantic database. This cache answers those
+misses from a Bloom filter and memoizes every resolved lookup for the
+rest of the lift.
+
+The filter is built once and kept across lifts. Names the database
+learns later are added from its append-only name log, so a lift only
+pays for what changed; removed names merely become false positives. The
+filter is rebuilt when it holds twice the names it was sized for.
+"""
+
+from typing import Any, Dict, Optional
+
+from lisa_ir.utils.bloom import BloomFilter
+
+
+class SemanticLookupCache:
+    """
+    Per-lift front end for SemanticDatabase.get_function_info.
+
+    Call reset() at the start of each lift so the Bloom filter catches up
+    with the database and memoized entries are looked up again, and
+    refresh() when the database changes during a lift.
+    """
+
+    def __init__(self, semantic_db, error_rate: float = 0.01):
+        """
+        Initialize the cache.
+
+        Args:
+            semantic_db: Semantic database to front
+            error_rate: False positive rate of the negative-lookup filter
+        """
+        self.semantic_db = semantic_db
+        self.error_rate = error_rate
+        self.bloom: Optional[BloomFilter] = None
+        self.logged = 0  # entries of the database's name log already in the filter
+        self.rebuilds = 0
+        self.memo: Dict[str, Optional[Dict[str, Any]]] = {}
+        self.stats = self._empty_stats()
+
+    @staticmethod
+    def _empty_stats() -> Dict[str, int]:
+        return {
+            "lookups": 0,
+            "memo_hits": 0,
+            "bloom_negatives": 0,
+            "db_hits": 0,
+            "db_misses": 0,
+        }
+
+    def reset(self) -> None:
+        """Bring the filter up to date with the database and clear memoized entries and counters."""
+        self.refresh()
+        self.stats = self._empty_stats()
+
+    def refresh(self) -> None:
+        """
+        Bring the filter up to date with the database and clear memoized entries.
+
+        Unlike reset() the counters keep accumulating, for a database that
+        changed in the middle of a lift.
+        """
+        name_log = getattr(self.semantic_db, "name_log", None)
+        if name_log is None or self.bloom is None or len(self.bloom) + len(name_log) - self.logged > 2 * self.bloom.capacity:
+            self.bloom = BloomFilter.from_items(self.semantic_db.get_all_functions(), self.error_rate)
+            self.logged = len(name_log) if name_log is not None else 0
+            self.rebuilds += 1
+        else:
+            for name in name_log[self.logged:]:
+                self.bloom.add(name)
+            self.logged = len(name_log)
+        self.memo.clear()
+
+    def get_function_info(self, func_name: str) -> Optional[Dict[str, Any]]:
+        """
+        Look up semantic information for a function.
+
+        Args:
+            func_name: Name of the function
+
+        Returns:
+            Semantic information dictionary or None if not found
+        """
+        self.stats["lookups"] += 1
+
+        if func_name in self.memo:
+            self.stats["memo_hits"] += 1
+            return self.memo[func_name]
+
+        if self.bloom is not None and func_name not in self.bloom:
+            self.stats["bloom_negatives"] += 1
+            info = None
+        else:
+            info = self.semantic_db.get_function_info(func_name)
+            self.stats["db_hits" if info is not None else "db_misses"] += 1
+
+        self.memo[func_name] = info
+        return info
+
+    def get_stats(self) -> Dict[str, int]:
+        """Return a copy of the hit/miss counters."""
+        return dict(self.stats)
@@ -3,5 +3,6 @@ Database module for LISA-IR
 """
 
 from .semantic_db import SemanticDatabase
+from .call_index import CallSiteIndex, CallSite
 
-__all__ = ['SemanticDatabase']
\ No newline at end of file
+__all__ = ['SemanticDatabase', 'CallSiteIndex', 'CallSite']
\ No newline at end of file
@@ -0,0 +1,357 @@
+"""
+Call Site Index for LISA-IR
+
+This module maintains an inverted index from every called function name
+to the places it is called from across a corpus, so that changing the
+semantic entry of one API only requires re-checking the functions that
+call it instead of re-lifting everything.
+
+A site is the (file, function, block, coordinate) of a ``Call``. The
+lifter replaces all sites of a file each time it lifts that file. On disk
+the index is one JSON object with the file names and the function and
+block names interned into tables; the sites of each API are a flat list
+of integers, five per site:
+
+    {"version": 1, "files": [...], "strings": [...],
+     "sites": {"PyList_SetItem": [file, function, block, line, column, ...]}}
+
+Several processes may share one index file. Saving takes the same kind of
+exclusive file lock as the semantic database, re-reads the file and
+replaces only the files this instance re-indexed.
+"""
+
+import json
+import logging
+from pathlib import Path
+from typing import Dict, Iterable, List, NamedTuple, Optional, Set, Tuple
+
+from lisa_ir.ir.ir_nodes import Module, Call
+from lisa_ir.utils.file_lock import FileLock, atomic_write_json
+
+
+# On-disk format version; files with another version are ignored and rebuilt
+INDEX_VERSION = 1
+
+# Integers stored per site in the flat on-disk lists
+SITE_FIELDS = 5
+
+
+class CallSite(NamedTuple):
+    """One call of a function."""
+    file: str
+    function: str
+    block: str
+    line: int
+    column: int
+
+    @property
+    def coord(self) -> str:
+        return f"{self.file}:{self.line}:{self.column}"
+
+    def __str__(self) -> str:
+        return f"{self.coord}: {self.function} ({self.block})"
+
+
+def _line_column(coord: Optional[str]) -> Tuple[int, int]:
+    """Return the line and column of an IR coordinate ``path:line:column`` (0 if unknown)."""
+    if not coord:
+        return 0, 0
+    parts = coord.rsplit(":", 2)
+    try:
+        return int(parts[-2]), int(parts[-1])
+    except (IndexError, ValueError):
+        return 0, 0
+
+
+def module_call_sites(module: Module, file_path: str) -> Dict[str, List[CallSite]]:
+    """
+    Collect the call sites of a lifted module.
+
+    Args:
+        module: The lifted module
+        file_path: The source file to record the sites under
+
+    Returns:
+        Sites per called function name, in function and block order
+    """
+    sites: Dict[str, List[CallSite]] = {}
+    for func in module.functions.values():
+        for block in func.blocks.values():
+            for op in block.operations:
+                if isinstance(op, Call):
+                    line, column = _line_column(op.coord)
+                    sites.setdefault(op.function_name, []).append(
+                        CallSite(file_path, func.name, block.name, line, column))
+    return sites
+
+
+class CallSiteIndex:
+    """
+    Inverted index from called function names to their call sites.
+
+    In memory the sites are kept both per called function and per file,
+    so queries and per-file replacement touch only the affected entries.
+    """
+
+    def __init__(self, index_path: str):
+        """
+        Load an index, or start an empty one if the file does not exist.
+
+        Args:
+            index_path: Path to the index file
+        """
+        self.logger = logging.getLogger(__name__)
+        self.index_path = Path(index_path)
+        # Called function -> file -> its sites in that file
+        self._sites: Dict[str, Dict[str, List[CallSite]]] = {}
+        # Indexed file -> the functions it calls
+        self._files: Dict[str, Set[str]] = {}
+        self._dirty: Set[str] = set()
+        try:
+            self._load(self._read())
+        except (ValueError, IOError) as e:
+            self.logger.warning(f"Failed to load call site index from {self.index_path}: {e}")
+
+    def _read(self) -> Dict[str, Dict[str, List[CallSite]]]:
+        """
+        Read the index file.
+
+        Returns:
+            Sites per file and called function ({} if the file does not exist
+            or has another format version)
+
+        Raises:
+            ValueError: If the file is not valid JSON
+            IOError: If the file exists but cannot be read
+        """
+        try:
+            with open(self.index_path, 'r', encoding='utf-8') as f:
+                data = json.load(f)
+        except FileNotFoundError:
+            return {}
+        if not isinstance(data, dict) or data.get("version") != INDEX_VERSION:
+            self.logger.warning(f"Ignoring call site index {self.index_path} with unknown format")
+            return {}
+
+        files, strings = data.get("files", []), data.get("strings", [])
+        by_file: Dict[str, Dict[str, List[CallSite]]] = {name: {} for name in files}
+        for callee, flat in data.get("sites", {}).items():
+            for i in range(0, len(flat) - SITE_FIELDS + 1, SITE_FIELDS):
+                file_id, function_id, block_id, line, column = flat[i:i + SITE_FIELDS]
+                site = CallSite(files[file_id], strings[function_id], strings[block_id], line, column)
+                by_file[site.file].setdefault(callee, []).append(site)
+        return by_file
+
+    def _load(self, by_file: Dict[str, Dict[str, List[CallSite]]]) -> None:
+        """Replace the in-memory index with sites per file."""
+        self._sites = {}
+        self._files = {}
+        for file_path, sites in by_file.items():
+            self._set_file(file_path, sites)
+
+    def _set_file(self, file_path: str, sites: Dict[str, List[CallSite]]) -> None:
+        """Replace the sites recorded for one file in memory."""
+        for callee in self._files.get(file_path, ()):
+            per_file = self._sites.get(callee)
+            if per_file is not None:
+                per_file.pop(file_path, None)
+                if not per_file:
+                    del self._sites[callee]
+        self._files[file_path] = set(sites)
+        for callee, callee_sites in sites.items():
+            self._sites.setdefault(callee, {})[file_path] = list(callee_sites)
+
+    def _file_sites(self, file_path: str) -> Dict[str, List[CallSite]]:
+        """Return the sites recorded for one file per called function."""
+        return {callee: self._sites[callee][file_path] for callee in self._files.get(file_path, ())}
+
+    def update_module(self, module: Module, file_path: str, save: bool = True) -> int:
+        """
+        Replace the sites of a file with those of its freshly lifted module.
+
+        Args:
+            module: The lifted module
+            file_path: The source file it was lifted from
+            save: Write the index back immediately
+
+        Returns:
+            Number of call sites recorded for the file
+        """
+        sites = module_call_sites(module, file_path)
+        self._set_file(file_path, sites)
+        self._dirty.add(file_path)
+        if save:
+            self.save()
+        return sum(len(callee_sites) for callee_sites in sites.values())
+
+    def remove_file(self, file_path: str, save: bool = True) -> bool:
+        """
+        Forget a file, e.g. one deleted from the corpus.
+
+        Args:
+            file_path: The indexed file
+            save: Write the index back immediately
+
+        Returns:
+            True if the file was indexed
+        """
+        if file_path not in self._files:
+            return False
+        self._set_file(file_path, {})
+        del self._files[file_path]
+        self._dirty.add(file_path)
+        if save:
+            self.save()
+        return True
+
+    def callers(self, function_name: str) -> List[CallSite]:
+        """
+        Return the call sites of a function.
+
+        Args:
+            function_name: The called function (an API or a corpus function)
+
+        Returns:
+            Its sites, ordered by file and then as they appear in the file
+        """
+        per_file = self._sites.get(function_name, {})
+        return [site for file_path in sorted(per_file) for site in per_file[file_path]]
+
+    def calling_functions(self, function_names: Iterable[str]) -> Dict[str, List[str]]:
+        """
+        Return the functions that call any of the given functions.
+
+        Args:
+            function_names: The called functions
+
+        Returns:
+            Calling function names per file, files sorted and functions in file order
+        """
+        result: Dict[str, Dict[str, None]] = {}
+        for function_name in function_names:
+            for site in self.callers(function_name):
+                result.setdefault(site.file, {})[site.function] = None
+        return {file_path: list(result[file_path]) for file_path in sorted(result)}
+
+    @property
+    def files(self) -> List[str]:
+        """Indexed files, sorted."""
+        return sorted(self._files)
+
+    @property
+    def called_functions(self) -> List[str]:
+        """Called function names, sorted."""
+        return sorted(self._sites)
+
+    def __len__(self) -> int:
+        """Total number of call sites."""
+        return sum(len(sites) for per_file in self._sites.values() for sites in per_file.values())
+
+    def to_dict(self) -> Dict:
+        """Encode the index in its compact on-disk form."""
+        files = sorted(self._files)
+        file_ids = {name: i for i, name in enumerate(files)}
+        strings: Dict[str, int] = {}
+
+        def intern(value: str) -> int:
+            return strings.setdefault(value, len(strings))
+
+        sites = {}
+        for callee in sorted(self._sites):
+            flat = []
+            for site in self.callers(callee):
+                flat += [file_ids[site.file], intern(site.function), intern(site.block), site.line, site.column]
+            sites[callee] = flat
+        return {"version": INDEX_VERSION, "files": files, "strings": list(strings), "sites": sites}
+
+    def save(self) -> None:
+        """
+        Write the index back to its file.
+
+        The files re-indexed since the last save replace their entries in
+        the current file contents under an exclusive lock; other files are
+        taken from disk, so concurrent lifts of different files all land.
+        An index file that exists but cannot be read is left alone and the
+        re-indexed files stay pending.
+        """
+        if not self._dirty:
+            return
+        try:
+            with FileLock(self.index_path):
+                mine = {file_path: self._file_sites(file_path) for file_path in self._dirty
+                        if file_path in self._files}
+                by_file = self._read()
+                for file_path in self._dirty:
+                    by_file.pop(file_path, None)
+                by_file.update(mine)
+                self._load(by_file)
+                atomic_write_json(self.index_path, self.to_dict(), indent=None)
+            self._dirty.clear()
+            self.logger.debug(f"Saved call site index to {self.index_path}")
+        except ValueError as e:
+            self.logger.error(f"Not saving call site index: {self.index_path} is unreadable ({e})")
+        except (IOError, OSError, TimeoutError) as e:
+            self.logger.error(f"Failed to save call site index to {self.index_path}: {e}")
+
+
+def recheck_callers(index: CallSiteIndex, changed: Iterable[str], lifter, max_workers: Optional[int] = None,
+                    cache=None, **options):
+    """
+    Re-check only the functions that call changed APIs.
+
+    Each file holding a caller is lifted again with the lifter's (updated)
+    semantic database and its sites in the index are refreshed. The
+    refcount checker runs on the calling functions, every module function
+    calling those in turn, and the module functions they call. When that
+    changes the summary inferred for a function, the callers of that
+    function in other files are re-checked the same way, until no stored
+    summary changes; each function's change is followed once, so call
+    cycles across files terminate.
+
+    Args:
+        index: The call site index
+        changed: Names of the APIs whose semantic entries changed
+        lifter: A Lifter sharing the semantic database to check against
+        max_workers: Worker processes for the refcount analysis
+        cache: RefcountResultCache for callers whose results the change did not affect
+        **options: RefcountChecker options (path_sensitive, state_budget, ...)
+
+    Returns:
+        Dictionary mapping each re-checked file to its InterproceduralResult
+        (covering every function checked in that file)
+    """
+    from lisa_ir.analysis.interprocedural import analyze_module, build_call_graph, transitive_callers
+
+    logger = logging.getLogger(__name__)
+    results = {}
+    checked: Dict[str, Set[str]] = {}
+    # Names whose callers are due, with the file defining them (its own callers already saw the change)
+    pending: Dict[str, Optional[str]] = {name: None for name in changed}
+    followed = set(pending)
+    while pending:
+        targets: Dict[str, Dict[str, None]] = {}
+        for name, origin in pending.items():
+            for site in index.callers(name):
+                if site.file != origin:
+                    targets.setdefault(site.file, {})[site.function] = None
+
+        updated: Dict[str, str] = {}
+        for file_path in sorted(targets):
+            if not Path(file_path).exists():
+                logger.warning(f"Indexed file {file_path} no longer exists, dropping it from the index")
+                index.remove_file(file_path)
+                continue
+            module = lifter.lift_file(file_path)
+            if getattr(lifter, "call_index", None) is not index:
+                index.update_module(module, file_path)
+            functions = transitive_callers(build_call_graph(module),
+                                           checked.get(file_path, set()).union(targets[file_path]))
+            checked[file_path] = set(functions)
+            result = analyze_module(module, lifter.semantic_db, max_workers=max_workers,
+                                    functions=functions, cache=cache, **options)
+            results[file_path] = result
+            updated.update((name, file_path) for name in result.updated)
+
+        pending = {name: origin for name, origin in updated.items() if name not in followed}
+        followed.update(pending)
+    return results
@@ -9,9 +9,21 @@ counting semantics, error handling patterns, and API behavior.
 import json
 import logging
 import os
-from typing import Dict, Any, Optional, List
+from typing import Dict, Any, Optional, List, Tuple
 from pathlib import Path
 
+from lisa_ir.utils.file_lock import FileLock, atomic_write_json
+
+
+# Per-entry version counter stored alongside the semantic fields
+VERSION_KEY = "_version"
+
+# Source tag of entries inferred by the interprocedural refcount analysis
+INFERRED_SOURCE = "inferred"
+
+# Policies for resolving an entry that another process changed since we loaded it
+CONFLICT_POLICIES = ('merge', 'ours', 'theirs')
+
 
 class SemanticDatabase:
     """
@@ -23,16 +35,33 @@ class SemanticDatabase:
     - Argument reference stealing behavior
     - Error return values
     - API behavior patterns
+
+    Several processes may share one database file. Every save takes an
+    exclusive file lock, re-reads the file, merges this instance's pending
+    changes entry by entry using the per-entry ``_version`` counter and
+    replaces the file with an atomic rename.
+
+    An update replaces the whole entry. Only when another writer changed
+    the entry since it was loaded are the two versions merged: the fields
+    (and ``arg_ref_steal`` indices) this instance changed or removed are
+    applied to the other writer's entry.
     """
     
-    def __init__(self, db_path: Optional[str] = None):
+    def __init__(self, db_path: Optional[str] = None, conflict_policy: str = 'merge'):
         """
         Initialize the semantic database.
         
         Args:
             db_path: Path to the semantic database file. If None, uses default.
+            conflict_policy: How to resolve an entry changed concurrently by another
+                             writer: 'merge' (our changed fields on top of theirs),
+                             'ours' (overwrite) or 'theirs' (keep the other write)
         """
+        if conflict_policy not in CONFLICT_POLICIES:
+            raise ValueError(f"Invalid conflict_policy: {conflict_policy}. Must be one of {CONFLICT_POLICIES}")
+        
         self.logger = logging.getLogger(__name__)
+        self.conflict_policy = conflict_policy
         
         if db_path is None:
             # Use a default path in the current working directory
@@ -43,6 +72,22 @@ class SemanticDatabase:
         # Initialize the database
         self.db = self._load_database()
         
+        # Entries extracted from annotated headers; consulted after self.db and never saved.
+        # They are kept per header (with its mtime) and self.builtin merges the current set.
+        self.builtin: Dict[str, Any] = {}
+        self.builtin_headers: Dict[str, Tuple[Optional[float], Dict[str, Any]]] = {}
+        
+        # Every function name in the order it first appeared; only ever appended to,
+        # so readers (the converter's Bloom filter) can catch up incrementally
+        self.name_log: List[str] = list(self.db)
+        
+        # Entries and versions as last seen on disk, and the entries replaced since then
+        self._base_entries = dict(self.db)
+        self._base_versions = {name: self._entry_version(info) for name, info in self.db.items()}
+        self._pending: Dict[str, Dict[str, Any]] = {}
+        self._removed = set()
+        self.conflicts_resolved = 0
+        
         self.logger.info(f"Semantic database initialized at: {self.db_path}")
         self.logger.info(f"Database contains {len(self.db)} entries")
     
@@ -55,31 +100,171 @@ class SemanticDatabase:
         """
         if self.db_path.exists():
             try:
-                with open(self.db_path, 'r', encoding='utf-8') as f:
-                    db = json.load(f)
+                db = self._read_database()
                 self.logger.debug(f"Loaded semantic database from {self.db_path}")
                 return db
-            except (json.JSONDecodeError, IOError) as e:
+            except (ValueError, IOError) as e:
                 self.logger.warning(f"Failed to load semantic database from {self.db_path}: {e}")
                 return {}
         else:
             self.logger.debug(f"Semantic database file {self.db_path} does not exist, creating empty database")
             return {}
     
+    def _read_database(self) -> Dict[str, Any]:
+        """
+        Read the database file as it is on disk.
+        
+        Returns:
+            Dict containing the semantic database ({} if the file does not exist)
+            
+        Raises:
+            ValueError: If the file is not a JSON object
+            IOError: If the file exists but cannot be read
+        """
+        try:
+            with open(self.db_path, 'r', encoding='utf-8') as f:
+                db = json.load(f)
+        except FileNotFoundError:
+            return {}
+        if not isinstance(db, dict):
+            raise ValueError(f"expected a JSON object, got {type(db).__name__}")
+        return db
+    
     def _save_database(self) -> None:
         """
         Save the semantic database to file.
+
+        Pending changes are merged with the current file contents under an
+        exclusive lock, then written back with an atomic rename. If the file
+        exists but cannot be read, nothing is written, so the entries in it
+        are not lost; the changes stay pending for the next save.
         """
         try:
-            # Create directory if it doesn't exist
-            self.db_path.parent.mkdir(parents=True, exist_ok=True)
+            with FileLock(self.db_path):
+                disk_db = self._read_database()
+                merged = self._merge_pending(disk_db)
+                atomic_write_json(self.db_path, merged)
             
-            with open(self.db_path, 'w', encoding='utf-8') as f:
-                json.dump(self.db, f, indent=2, ensure_ascii=False)
+            self._log_names(merged)
+            self.db = merged
+            self._base_entries = dict(merged)
+            self._base_versions = {name: self._entry_version(info) for name, info in merged.items()}
+            self._pending.clear()
+            self._removed.clear()
             self.logger.debug(f"Saved semantic database to {self.db_path}")
-        except IOError as e:
+        except ValueError as e:
+            self.logger.error(f"Not saving semantic database: {self.db_path} is unreadable ({e})")
+        except (IOError, OSError, TimeoutError) as e:
             self.logger.error(f"Failed to save semantic database to {self.db_path}: {e}")
     
+    def _log_names(self, names) -> None:
+        """Append the names neither the database nor the builtins know yet to the name log."""
+        for name in names:
+            if name not in self.db and name not in self.builtin:
+                self.name_log.append(name)
+    
+    @staticmethod
+    def _entry_version(info: Any) -> int:
+        """Return the version counter of an entry (0 if unversioned)."""
+        if isinstance(info, dict):
+            version = info.get(VERSION_KEY, 0)
+            if isinstance(version, int):
+                return version
+        return 0
+    
+    def _set_entry(self, func_name: str, info: Dict[str, Any]) -> None:
+        """
+        Record a local replacement of an entry and bump its version.
+
+        Args:
+            func_name: Name of the function
+            info: Validated semantic information dictionary
+        """
+        self._log_names([func_name])
+        entry = {k: v for k, v in info.items() if k != VERSION_KEY}
+        self._pending[func_name] = dict(entry)
+        entry[VERSION_KEY] = self._base_versions.get(func_name, 0) + 1
+        self.db[func_name] = entry
+        self._removed.discard(func_name)
+    
+    def _merge_pending(self, disk_db: Dict[str, Any]) -> Dict[str, Any]:
+        """
+        Merge this instance's pending changes into the on-disk database.
+
+        Entries nobody else touched are taken from disk as-is, and an entry
+        we replaced is written as we left it. It is a conflict when its
+        on-disk version moved past the version we based our change on; the
+        conflict is resolved by ``conflict_policy``, merging with
+        ``_merge_entries`` under 'merge'.
+
+        Args:
+            disk_db: Database contents currently on disk
+
+        Returns:
+            The merged database to write back
+        """
+        merged = dict(disk_db)
+        
+        for func_name, ours in self._pending.items():
+            theirs = disk_db.get(func_name)
+            base_version = self._base_versions.get(func_name, 0)
+            disk_version = self._entry_version(theirs) if theirs is not None else 0
+            
+            entry = dict(ours)
+            if disk_version > base_version:
+                self.conflicts_resolved += 1
+                self.logger.debug(f"Concurrent update of {func_name} (base v{base_version}, "
+                                  f"disk v{disk_version}), resolving with policy '{self.conflict_policy}'")
+                if self.conflict_policy == 'theirs':
+                    continue
+                if self.conflict_policy == 'merge' and isinstance(theirs, dict):
+                    base = self._base_entries.get(func_name)
+                    entry = self._merge_entries(theirs, ours, base if isinstance(base, dict) else {})
+            entry[VERSION_KEY] = max(disk_version, base_version) + 1
+            merged[func_name] = entry
+        
+        for func_name in self._removed:
+            theirs = disk_db.get(func_name)
+            if theirs is None:
+                continue
+            if self._entry_version(theirs) <= self._base_versions.get(func_name, 0) or self.conflict_policy == 'ours':
+                del merged[func_name]
+            else:
+                self.conflicts_resolved += 1
+                self.logger.debug(f"Keeping {func_name}: removed locally but updated concurrently")
+        
+        return merged
+    
+    @staticmethod
+    def _merge_entries(theirs: Dict[str, Any], ours: Dict[str, Any], base: Dict[str, Any]) -> Dict[str, Any]:
+        """
+        Three-way merge of two concurrent versions of one entry.
+
+        Fields we changed or removed relative to the common base are applied
+        to the other writer's version; all other fields are kept as they
+        wrote them. ``arg_ref_steal`` maps are merged per argument index.
+        """
+        entry = SemanticDatabase._apply_changes(theirs, ours, base)
+        steals = [d.get('arg_ref_steal') for d in (theirs, ours)]
+        if 'arg_ref_steal' in entry and all(isinstance(d, dict) for d in steals):
+            base_steals = base.get('arg_ref_steal')
+            entry['arg_ref_steal'] = SemanticDatabase._apply_changes(
+                steals[0], steals[1], base_steals if isinstance(base_steals, dict) else {})
+        return entry
+    
+    @staticmethod
+    def _apply_changes(theirs: Dict[str, Any], ours: Dict[str, Any], base: Dict[str, Any]) -> Dict[str, Any]:
+        """Return theirs with the keys ours set or removed relative to base applied."""
+        merged = dict(theirs)
+        for key in set(ours) | set(base):
+            if key == VERSION_KEY or ours.get(key) == base.get(key):
+                continue
+            if key in ours:
+                merged[key] = ours[key]
+            else:
+                merged.pop(key, None)
+        return merged
+    
     def get_function_info(self, func_name: str) -> Optional[Dict[str, Any]]:
         """
         Retrieve semantic information for a function.
@@ -90,7 +275,79 @@ class SemanticDatabase:
         Returns:
             Dictionary containing semantic information or None if not found
         """
-        return self.db.get(func_name)
+        info = self.db.get(func_name)
+        if info is None:
+            info = self.builtin.get(func_name)
+        return info
+    
+    def register_builtin(self, semantic_info: Dict[str, Any], header: str = "<annotations>",
+                         mtime: Optional[float] = None) -> int:
+        """
+        Register entries extracted from one annotated header.
+        
+        Builtin entries only fill in functions the database file does not
+        describe, and they are kept in memory rather than saved. The
+        entries replace whatever the same header registered before, so an
+        annotation removed from a rescanned header is dropped.
+        
+        Args:
+            semantic_info: Dictionary mapping function names to their semantic info
+            header: Path of the header the entries come from
+            mtime: Modification time of the header when it was scanned
+            
+        Returns:
+            Number of entries registered
+        """
+        headers = dict(self.builtin_headers)
+        headers[header] = (mtime, self._validated_builtins(semantic_info, header))
+        self._set_builtins(headers)
+        return len(headers[header][1])
+    
+    def set_builtin_headers(self, headers: Dict[str, Tuple[Optional[float], Dict[str, Any]]]) -> int:
+        """
+        Make the annotations of exactly these headers the builtin entries.
+        
+        Called on every lift with the headers the translation unit includes,
+        so annotations of headers an earlier, unrelated lift included stop
+        applying. Headers whose path and mtime are unchanged keep their
+        validated entries; the others are (re)registered.
+        
+        Args:
+            headers: Dictionary mapping header paths to their mtime and entries
+            
+        Returns:
+            Number of builtin entries now in effect
+        """
+        kept = {}
+        for header, (mtime, semantic_info) in headers.items():
+            current = self.builtin_headers.get(header)
+            if current is not None and current[0] == mtime:
+                kept[header] = current
+            else:
+                kept[header] = (mtime, self._validated_builtins(semantic_info, header))
+        self._set_builtins(kept)
+        return len(self.builtin)
+    
+    def _validated_builtins(self, semantic_info: Dict[str, Any], header: str) -> Dict[str, Any]:
+        """Return the valid entries of one header, warning about the others."""
+        valid = {}
+        for func_name, info in semantic_info.items():
+            if self._validate_semantic_info(info):
+                valid[func_name] = info
+            else:
+                self.logger.warning(f"Invalid header annotation for function {func_name} in {header}, skipping")
+        return valid
+    
+    def _set_builtins(self, headers: Dict[str, Tuple[Optional[float], Dict[str, Any]]]) -> None:
+        """Replace the builtin headers and rebuild the merged builtin entries."""
+        builtin: Dict[str, Any] = {}
+        for _, entries in headers.values():
+            builtin.update(entries)
+        self._log_names(builtin)
+        self.builtin_headers = headers
+        self.builtin = builtin
+        if builtin:
+            self.logger.debug(f"{len(builtin)} builtin entries from {len(headers)} annotated headers")
     
     def update(self, semantic_info: Dict[str, Any]) -> None:
         """
@@ -102,7 +359,7 @@ class SemanticDatabase:
         updated_count = 0
         for func_name, info in semantic_info.items():
             if self._validate_semantic_info(info):
-                self.db[func_name] = info
+                self._set_entry(func_name, info)
                 updated_count += 1
             else:
                 self.logger.warning(f"Invalid semantic info for function {func_name}, skipping")
@@ -120,7 +377,7 @@ class SemanticDatabase:
             info: Semantic information dictionary
         """
         if self._validate_semantic_info(info):
-            self.db[func_name] = info
+            self._set_entry(func_name, info)
             self._save_database()
             self.logger.info(f"Updated semantic info for function: {func_name}")
         else:
@@ -184,7 +441,7 @@ class SemanticDatabase:
                 info = entry['info']
                 
                 if self._validate_semantic_info(info):
-                    self.db[func_name] = info
+                    self._set_entry(func_name, info)
                     updated_count += 1
                 else:
                     self.logger.warning(f"Invalid semantic info for function {func_name}, skipping")
@@ -204,7 +461,7 @@ class SemanticDatabase:
         Returns:
             List of function names
         """
-        return list(self.db.keys())
+        return list(self.db.keys()) + [name for name in self.builtin if name not in self.db]
     
     def has_function(self, func_name: str) -> bool:
         """
@@ -216,7 +473,7 @@ class SemanticDatabase:
         Returns:
             True if function exists, False otherwise
         """
-        return func_name in self.db
+        return func_name in self.db or func_name in self.builtin
     
     def remove_function(self, func_name: str) -> bool:
         """
@@ -230,6 +487,8 @@ class SemanticDatabase:
         """
         if func_name in self.db:
             del self.db[func_name]
+            self._pending.pop(func_name, None)
+            self._removed.add(func_name)
             self._save_database()
             self.logger.info(f"Removed function {func_name} from semantic database")
             return True
@@ -252,8 +511,8 @@ class SemanticDatabase:
             raise ValueError(f"Invalid ref_type: {ref_type}. Must be one of {valid_types}")
         
         result = []
-        for func_name, info in self.db.items():
-            if info.get('return_ref_type') == ref_type:
+        for func_name in self.get_all_functions():
+            if self.get_function_info(func_name).get('return_ref_type') == ref_type:
                 result.append(func_name)
         
         return result
@@ -267,7 +526,7 @@ class SemanticDatabase:
         """
         for func_name, info in other_db.db.items():
             if self._validate_semantic_info(info):
-                self.db[func_name] = info
+                self._set_entry(func_name, info)
         
         self._save_database()
         self.logger.info(f"Merged with another semantic database, now contains {len(self.db)} entries")
\ No newline at end of file
@@ -157,7 +157,15 @@ class SemanticOp(IRNode):
     coord: Optional[str] = None
 
 
-Operation = Union[Assign, Call, Store, SemanticOp]
+@dataclass
+class Phi(IRNode):
+    """SSA phi: target takes incoming[pred] when control arrives from block pred."""
+    target: Variable
+    incoming: Dict[str, Expression] = field(default_factory=dict)
+    coord: Optional[str] = None
+
+
+Operation = Union[Assign, Call, Store, SemanticOp, Phi]
 
 
 # Terminators
@@ -222,6 +230,7 @@ class FuncDef(IRNode):
     entry_point: str = "entry"
     blocks: Dict[str, BasicBlock] = field(default_factory=dict)
     local_vars: Dict[str, str] = field(default_factory=dict)
+    return_type: Optional[str] = None
     coord: Optional[str] = None
 
     def add_block(self, block: BasicBlock) -> None:
@@ -238,6 +247,7 @@ class Module(IRNode):
     functions: Dict[str, FuncDef] = field(default_factory=dict)
     global_vars: Dict[str, str] = field(default_factory=dict)
     includes: List[str] = field(default_factory=list)
+    metadata: Dict[str, Any] = field(default_factory=dict)
     coord: Optional[str] = None
 
     def add_function(self, func: FuncDef) -> None:
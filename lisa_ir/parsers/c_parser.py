@@ -13,12 +13,14 @@ import sys
 import logging
 import subprocess
 import platform
-from typing import List, Optional, Dict, Any
+from typing import List, Optional, Dict, Any, Tuple
 from pathlib import Path
 
 from pycparser import c_parser, c_ast, parse_file
 from pycparser.c_ast import FileAST
 
+from lisa_ir.parsers.header_annotations import extract_header_sources
+
 
 class CCodeParser:
     """
@@ -40,6 +42,11 @@ class CCodeParser:
         self.fake_libc_path = self._get_fake_libc_path()
         self.system_includes = self._find_system_includes()
 
+        # Semantic entries from ownership annotations in the headers of the last parse,
+        # merged and per header path (with the header's mtime)
+        self.header_annotations: Dict[str, Dict[str, Any]] = {}
+        self.header_sources: Dict[str, Tuple[float, Dict[str, Dict[str, Any]]]] = {}
+
         self.logger.info(f"Initialized C parser with CPP: {self.cpp_path}")
         self.logger.info(f"Fake libc path: {self.fake_libc_path}")
         self.logger.info(f"System includes found: {len(self.system_includes)}")
@@ -141,6 +148,7 @@ class CCodeParser:
             # Try alternative locations
             alt_paths = [
                 os.path.join(os.path.dirname(__file__), "fake_libc_include"),
+                os.path.join(os.path.dirname(__file__), "..", "..", "fake_libc_include"),
                 "fake_libc_include",
                 "./fake_libc_include",
                 os.path.join(pycparser_dir, "fake_libc_include"),
@@ -315,14 +323,18 @@ class CCodeParser:
             return c_code
 
     def parse(self, c_code: str, cpp_args: Optional[List[str]] = None,
-              use_cpp: bool = True) -> FileAST:
+              use_cpp: bool = True, source_dir: Optional[str] = None) -> FileAST:
         """
         Parse C source code into an AST.
 
+        Ownership annotations on the included headers are collected into
+        ``self.header_annotations`` and ``self.header_sources`` as a side effect.
+
         Args:
             c_code: The C source code to parse
             cpp_args: Additional arguments to pass to the preprocessor
             use_cpp: Whether to use external preprocessor
+            source_dir: Directory of the source file, searched for quoted includes
 
         Returns:
             pycparser FileAST object
@@ -333,8 +345,17 @@ class CCodeParser:
         self.logger.info("Starting C code parsing")
 
         try:
-            # Preprocess the code if requested
+            # Collect ownership annotations before the preprocessor strips them
+            self.header_sources = extract_header_sources(c_code, [self.fake_libc_path], source_dir)
+            self.header_annotations = {}
+            for _, entries in self.header_sources.values():
+                self.header_annotations.update(entries)
+            self.logger.debug(f"Collected {len(self.header_annotations)} annotated prototypes from headers")
+
+            # Preprocess the code if requested; quoted includes resolve next to the source
             if use_cpp and self.cpp_path:
+                if source_dir:
+                    cpp_args = ["-iquote", source_dir] + list(cpp_args or [])
                 preprocessed_code = self._preprocess_code(c_code, cpp_args)
                 self.logger.debug("Code preprocessed successfully")
             else:
@@ -386,7 +407,7 @@ class CCodeParser:
                 c_code = f.read()
 
             # Parse the code
-            ast = self.parse(c_code, cpp_args)
+            ast = self.parse(c_code, cpp_args, source_dir=os.path.dirname(file_path))
 
             # Set the file coordinate for all nodes
             self._set_file_coordinates(ast, file_path)
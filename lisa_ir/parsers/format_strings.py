@@ -0,0 +1,206 @@
+"""
+Format String Decoding for LISA-IR
+
+This module decodes the format strings of the ``PyArg_Parse*`` family and
+``Py_BuildValue`` into specs that say, for every variadic argument of the
+call, what the API does with it: which output pointers receive borrowed
+object references (``O``, ``O!``, ``S``, ``U``, ``Y``), which receive
+plain C values, which arguments are converter functions (``O&``), and
+which object arguments ``Py_BuildValue`` increfs (``O``, ``S``) or steals
+(``N``).
+
+Extension modules reuse a handful of format strings at many call sites,
+so each distinct string is decoded once and the immutable spec is cached.
+"""
+
+from dataclasses import dataclass
+from functools import lru_cache
+from typing import Dict, Optional, Tuple
+
+
+# Functions taking a format string: kind, index of the format argument, index of the first variadic argument
+FORMAT_FUNCTIONS: Dict[str, Tuple[str, int, int]] = {
+    "PyArg_ParseTuple": ("parse", 1, 2),
+    "PyArg_ParseTupleAndKeywords": ("parse", 2, 4),
+    "PyArg_Parse": ("parse", 1, 2),
+    "Py_BuildValue": ("build", 0, 1),
+}
+
+# Distinct format strings kept decoded
+FORMAT_CACHE_SIZE = 1024
+
+# Scalar parse units and the C type their output pointer points to
+_PARSE_SCALARS = {
+    'b': 'unsigned char', 'B': 'unsigned char', 'h': 'short', 'H': 'unsigned short',
+    'i': 'int', 'I': 'unsigned int', 'l': 'long', 'k': 'unsigned long',
+    'L': 'long long', 'K': 'unsigned long long', 'n': 'Py_ssize_t', 'c': 'char',
+    'C': 'int', 'f': 'float', 'd': 'double', 'D': 'Py_complex', 'p': 'int',
+}
+
+# Parse units storing a borrowed object reference, with the type they require
+_PARSE_OBJECTS = {'O': None, 'S': 'PyBytes_Type', 'U': 'PyUnicode_Type', 'Y': 'PyByteArray_Type'}
+
+# Parse units storing a buffer pointer (optionally followed by '#' or '*')
+_PARSE_BUFFERS = {'s': 'const char *', 'z': 'const char *', 'y': 'const char *',
+                  'u': 'const Py_UNICODE *', 'Z': 'const Py_UNICODE *', 'w': 'char *'}
+
+# Scalar Py_BuildValue units and the C type of their argument
+_BUILD_SCALARS = {
+    'b': 'char', 'B': 'unsigned char', 'h': 'short', 'H': 'unsigned short',
+    'i': 'int', 'I': 'unsigned int', 'l': 'long', 'k': 'unsigned long',
+    'L': 'long long', 'K': 'unsigned long long', 'n': 'Py_ssize_t', 'c': 'char',
+    'C': 'int', 'f': 'double', 'd': 'double', 'D': 'Py_complex *', 'p': 'int',
+}
+
+# Py_BuildValue units taking a C string (optionally followed by '#')
+_BUILD_STRINGS = {'s': 'const char *', 'z': 'const char *', 'y': 'const char *',
+                  'u': 'const wchar_t *', 'U': 'const char *'}
+
+
+@dataclass(frozen=True)
+class FormatArg:
+    """
+    What a call does with one variadic argument.
+
+    Roles for parse formats: ``object`` (PyObject ** receiving a borrowed
+    reference), ``type`` (type object checked by ``O!``), ``converter``
+    and ``convert-target`` (``O&``), ``value`` (pointer to a C value),
+    ``length`` (``#`` size), ``encoding`` and ``buffer``. For build
+    formats: ``object`` (increfed), ``steal`` (``N``), ``converter``,
+    ``convert-arg``, ``value`` and ``length``.
+    """
+    unit: str
+    role: str
+    c_type: Optional[str] = None
+    type_object: Optional[str] = None
+    optional: bool = False
+
+
+@dataclass(frozen=True)
+class FormatSpec:
+    """Decoded format string."""
+    format: str
+    kind: str
+    args: Tuple[FormatArg, ...] = ()
+    function_name: Optional[str] = None
+    error: Optional[str] = None
+
+
+def _parse_units(fmt: str) -> Tuple[Tuple[FormatArg, ...], Optional[str], Optional[str]]:
+    """Decode a PyArg_Parse* format into (args, function name after ':', error)."""
+    args = []
+    optional = False
+    i = 0
+    while i < len(fmt):
+        ch = fmt[i]
+        following = fmt[i + 1] if i + 1 < len(fmt) else ''
+        if ch == ':':
+            return tuple(args), fmt[i + 1:] or None, None
+        if ch == ';':
+            return tuple(args), None, None
+        if ch == '|':
+            optional = True
+        elif ch in '$()':
+            pass
+        elif ch in _PARSE_OBJECTS:
+            if following == '!':
+                args.append(FormatArg(ch + '!', 'type', 'PyTypeObject *', optional=optional))
+                args.append(FormatArg(ch + '!', 'object', 'PyObject *', optional=optional))
+                i += 1
+            elif following == '&':
+                args.append(FormatArg(ch + '&', 'converter', optional=optional))
+                args.append(FormatArg(ch + '&', 'convert-target', 'void', optional=optional))
+                i += 1
+            else:
+                args.append(FormatArg(ch, 'object', 'PyObject *', _PARSE_OBJECTS[ch], optional=optional))
+        elif ch == 'e' and following in ('s', 't'):
+            unit = ch + following
+            args.append(FormatArg(unit, 'encoding', 'const char *', optional=optional))
+            i += 1
+            if fmt[i + 1:i + 2] == '#':
+                i += 1
+                args.append(FormatArg(unit + '#', 'value', 'char *', optional=optional))
+                args.append(FormatArg(unit + '#', 'length', 'Py_ssize_t', optional=optional))
+            else:
+                args.append(FormatArg(unit, 'value', 'char *', optional=optional))
+        elif ch in _PARSE_BUFFERS:
+            if following == '#':
+                args.append(FormatArg(ch + '#', 'value', _PARSE_BUFFERS[ch], optional=optional))
+                args.append(FormatArg(ch + '#', 'length', 'Py_ssize_t', optional=optional))
+                i += 1
+            elif following == '*':
+                args.append(FormatArg(ch + '*', 'buffer', 'Py_buffer', optional=optional))
+                i += 1
+            else:
+                args.append(FormatArg(ch, 'value', _PARSE_BUFFERS[ch], optional=optional))
+        elif ch in _PARSE_SCALARS:
+            args.append(FormatArg(ch, 'value', _PARSE_SCALARS[ch], optional=optional))
+        else:
+            return tuple(args), None, f"unknown format unit '{ch}' at offset {i}"
+        i += 1
+    return tuple(args), None, None
+
+
+def _build_units(fmt: str) -> Tuple[Tuple[FormatArg, ...], Optional[str], Optional[str]]:
+    """Decode a Py_BuildValue format into (args, None, error)."""
+    args = []
+    i = 0
+    while i < len(fmt):
+        ch = fmt[i]
+        following = fmt[i + 1] if i + 1 < len(fmt) else ''
+        if ch in '()[]{}:, \t':
+            pass
+        elif ch in 'OS':
+            if ch == 'O' and following == '&':
+                args.append(FormatArg('O&', 'converter'))
+                args.append(FormatArg('O&', 'convert-arg', 'void *'))
+                i += 1
+            else:
+                args.append(FormatArg(ch, 'object', 'PyObject *'))
+        elif ch == 'N':
+            args.append(FormatArg(ch, 'steal', 'PyObject *'))
+        elif ch in _BUILD_STRINGS:
+            if following == '#':
+                args.append(FormatArg(ch + '#', 'value', _BUILD_STRINGS[ch]))
+                args.append(FormatArg(ch + '#', 'length', 'Py_ssize_t'))
+                i += 1
+            else:
+                args.append(FormatArg(ch, 'value', _BUILD_STRINGS[ch]))
+        elif ch in _BUILD_SCALARS:
+            args.append(FormatArg(ch, 'value', _BUILD_SCALARS[ch]))
+        else:
+            return tuple(args), None, f"unknown format unit '{ch}' at offset {i}"
+        i += 1
+    return tuple(args), None, None
+
+
+@lru_cache(maxsize=FORMAT_CACHE_SIZE)
+def decode_format(kind: str, fmt: str) -> FormatSpec:
+    """
+    Decode a format string (cached per distinct string).
+
+    Args:
+        kind: 'parse' for the PyArg_Parse* family, 'build' for Py_BuildValue
+        fmt: The format string, without quotes
+
+    Returns:
+        FormatSpec with one FormatArg per variadic argument; ``error`` is set
+        (and ``args`` may be partial) if the string is malformed
+    """
+    args, name, error = _parse_units(fmt) if kind == 'parse' else _build_units(fmt)
+    return FormatSpec(format=fmt, kind=kind, args=args, function_name=name, error=error)
+
+
+def literal_format(value: str) -> Optional[str]:
+    """
+    Return the contents of a C string literal as written in the IR (quotes included).
+
+    Adjacent literals merged by the parser and simple escapes are handled;
+    anything that is not a plain literal yields None.
+    """
+    if len(value) < 2 or value[0] != '"' or value[-1] != '"':
+        return None
+    body = value[1:-1]
+    if '\\' in body:
+        body = body.replace('\\t', '\t').replace('\\n', '\n').replace('\\"', '"').replace('\\\\', '\\')
+    return body
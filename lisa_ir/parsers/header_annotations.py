@@ -0,0 +1,209 @@
+"""
+Header Annotation Extractor for LISA-IR
+
+This module builds semantic database entries from ownership annotations
+on C header prototypes, for example::
+
+    LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *PyList_New(Py_ssize_t len);
+    LISA_STEALS(2) LISA_ERROR_RETURN(-1) int PyList_SetItem(PyObject *, Py_ssize_t, PyObject *);
+
+The annotation macros expand to nothing, so the preprocessor removes them
+before pycparser ever sees the header. They are therefore read from the
+raw header text in a single linear scan per header.
+"""
+
+import logging
+import os
+import re
+from typing import Dict, Any, List, Optional, Iterable, Tuple
+
+
+# Matches comments, preprocessor lines (with continuations) and string literals
+_NOISE_PATTERN = re.compile(
+    r'/\*.*?\*/|//[^\n]*|^[ \t]*#(?:[^\n]*\\\n)*[^\n]*|"(?:\\.|[^"\\])*"',
+    re.DOTALL | re.MULTILINE
+)
+
+_ANNOTATION_PATTERN = re.compile(
+    r'\bLISA_(NEW_REF|BORROWED_REF|NO_ERROR|STEALS|ERROR_RETURN)\b\s*(?:\(([^()]*)\))?'
+)
+
+_FUNCTION_NAME_PATTERN = re.compile(r'([A-Za-z_][A-Za-z0-9_]*)\s*\(')
+
+_INCLUDE_PATTERN = re.compile(r'^[ \t]*#[ \t]*include[ \t]*([<"])([^>"]+)[>"]', re.MULTILINE)
+
+# Parsed headers keyed by (path, mtime) so repeated lifts do not rescan them
+_header_cache: Dict[Tuple[str, float], Dict[str, Dict[str, Any]]] = {}
+
+logger = logging.getLogger(__name__)
+
+
+def extract_annotations(header_text: str) -> Dict[str, Dict[str, Any]]:
+    """
+    Extract semantic entries from annotated prototypes in header text.
+
+    Args:
+        header_text: Raw (unpreprocessed) header source
+
+    Returns:
+        Dictionary mapping function names to semantic information
+    """
+    text = _NOISE_PATTERN.sub(lambda m: '""' if m.group(0).startswith('"') else ' ', header_text)
+
+    entries = {}
+    for declaration in text.split(';'):
+        if 'LISA_' not in declaration:
+            continue
+
+        info: Dict[str, Any] = {"return_ref_type": "none", "arg_ref_steal": {}}
+        for match in _ANNOTATION_PATTERN.finditer(declaration):
+            kind, arg = match.group(1), match.group(2)
+            if kind == 'NEW_REF':
+                info["return_ref_type"] = "new_ref"
+            elif kind == 'BORROWED_REF':
+                info["return_ref_type"] = "borrowed_ref"
+            elif kind == 'NO_ERROR':
+                info["error_return"] = None
+            elif kind == 'STEALS' and arg is not None and arg.strip().isdigit():
+                info["arg_ref_steal"][str(int(arg))] = True
+            elif kind == 'ERROR_RETURN' and arg is not None:
+                info["error_return"] = arg.strip()
+
+        prototype = _ANNOTATION_PATTERN.sub(' ', declaration)
+        name_match = _FUNCTION_NAME_PATTERN.search(prototype)
+        if not name_match:
+            logger.debug(f"Ignoring annotated declaration without a prototype: {prototype.strip()}")
+            continue
+
+        entries[name_match.group(1)] = info
+
+    return entries
+
+
+def extract_header_file(header_path: str) -> Dict[str, Dict[str, Any]]:
+    """
+    Extract semantic entries from an annotated header file.
+
+    Args:
+        header_path: Path to the header
+
+    Returns:
+        Dictionary mapping function names to semantic information
+    """
+    header_path = os.path.abspath(header_path)
+    key = (header_path, os.path.getmtime(header_path))
+    if key not in _header_cache:
+        with open(header_path, 'r', encoding='utf-8', errors='ignore') as f:
+            _header_cache[key] = extract_annotations(f.read())
+        logger.debug(f"Extracted {len(_header_cache[key])} annotated prototypes from {header_path}")
+    return _header_cache[key]
+
+
+def find_included_headers(c_code: str, include_dirs: Iterable[str],
+                          source_dir: Optional[str] = None) -> List[str]:
+    """
+    Resolve the headers a translation unit includes, transitively.
+
+    Only headers found in the given directories are returned; anything
+    else is left to the preprocessor.
+
+    Args:
+        c_code: C source code
+        include_dirs: Directories searched for both include forms
+        source_dir: Directory searched first for quoted includes
+
+    Returns:
+        List of resolved header paths in inclusion order
+    """
+    include_dirs = list(include_dirs)
+    resolved: List[str] = []
+    seen = set()
+    pending = [(c_code, source_dir)]
+
+    while pending:
+        text, current_dir = pending.pop()
+        for match in _INCLUDE_PATTERN.finditer(text):
+            search_dirs = ([current_dir] if match.group(1) == '"' and current_dir else []) + include_dirs
+            for directory in search_dirs:
+                candidate = os.path.abspath(os.path.join(directory, match.group(2)))
+                if os.path.isfile(candidate):
+                    if candidate not in seen:
+                        seen.add(candidate)
+                        resolved.append(candidate)
+                        with open(candidate, 'r', encoding='utf-8', errors='ignore') as f:
+                            pending.append((f.read(), os.path.dirname(candidate)))
+                    break
+
+    return resolved
+
+
+def extract_header_sources(c_code: str, include_dirs: Iterable[str], source_dir: Optional[str] = None
+                           ) -> Dict[str, Tuple[float, Dict[str, Dict[str, Any]]]]:
+    """
+    Collect annotations per header a translation unit includes.
+
+    Args:
+        c_code: C source code
+        include_dirs: Directories searched for headers
+        source_dir: Directory searched first for quoted includes
+
+    Returns:
+        Dictionary mapping each header path to its mtime and its entries, in inclusion order
+    """
+    return {header_path: (os.path.getmtime(header_path), extract_header_file(header_path))
+            for header_path in find_included_headers(c_code, include_dirs, source_dir)}
+
+
+def extract_from_includes(c_code: str, include_dirs: Iterable[str],
+                          source_dir: Optional[str] = None) -> Dict[str, Dict[str, Any]]:
+    """
+    Collect annotations from every header a translation unit includes.
+
+    Args:
+        c_code: C source code
+        include_dirs: Directories searched for headers
+        source_dir: Directory searched first for quoted includes
+
+    Returns:
+        Dictionary mapping function names to semantic information
+    """
+    entries: Dict[str, Dict[str, Any]] = {}
+    for _, header_entries in extract_header_sources(c_code, include_dirs, source_dir).values():
+        entries.update(header_entries)
+    return entries
+
+
+def main():
+    """Generate a semantic catalog from annotated headers."""
+    import argparse
+    import json
+
+    parser = argparse.ArgumentParser(
+        description="Generate semantic database entries from annotated C headers"
+    )
+    parser.add_argument(
+        "headers",
+        nargs="+",
+        help="Annotated header files"
+    )
+    parser.add_argument(
+        "--semantic-db",
+        help="Write the entries into this semantic database instead of stdout",
+        default=None
+    )
+    args = parser.parse_args()
+
+    catalog: Dict[str, Dict[str, Any]] = {}
+    for header in args.headers:
+        catalog.update(extract_header_file(header))
+
+    if args.semantic_db:
+        from lisa_ir.database.semantic_db import SemanticDatabase
+        SemanticDatabase(args.semantic_db).update(catalog)
+        print(f"Wrote {len(catalog)} entries to {args.semantic_db}")
+    else:
+        print(json.dumps(catalog, indent=2))
+
+
+if __name__ == "__main__":
+    main()
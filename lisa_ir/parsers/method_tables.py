@@ -0,0 +1,199 @@
+"""
+Method Table Extraction for LISA-IR
+
+This module reads the static ``PyMethodDef`` arrays and ``PyModuleDef``
+structures of a parsed extension module, which name the C functions
+Python code can call directly and the module that exports them.
+"""
+
+from typing import Any, Dict, List, Optional
+
+from pycparser import c_ast
+
+
+# Field order of a positional PyMethodDef initializer
+METHOD_DEF_FIELDS = ('ml_name', 'ml_meth', 'ml_flags', 'ml_doc')
+
+# Field order of a positional PyModuleDef initializer
+MODULE_DEF_FIELDS = ('m_base', 'm_name', 'm_doc', 'm_size', 'm_methods', 'm_slots',
+                     'm_traverse', 'm_clear', 'm_free')
+
+# PyMethodDef calling convention flags (Include/methodobject.h)
+METH_FLAGS = {
+    'METH_VARARGS': 0x0001,
+    'METH_KEYWORDS': 0x0002,
+    'METH_NOARGS': 0x0004,
+    'METH_O': 0x0008,
+    'METH_CLASS': 0x0010,
+    'METH_STATIC': 0x0020,
+    'METH_COEXIST': 0x0040,
+    'METH_FASTCALL': 0x0080,
+    'METH_METHOD': 0x0200,
+}
+
+
+def _type_name(type_node: c_ast.Node) -> Optional[str]:
+    """Return the base type name of a declaration type, e.g. 'PyMethodDef'."""
+    while isinstance(type_node, (c_ast.ArrayDecl, c_ast.PtrDecl, c_ast.TypeDecl)):
+        type_node = type_node.type
+    if isinstance(type_node, c_ast.IdentifierType):
+        return ' '.join(type_node.names)
+    if isinstance(type_node, c_ast.Struct):
+        return type_node.name
+    return None
+
+
+def string_value(node: c_ast.Node) -> Optional[str]:
+    """Return the value of a string literal node without its quotes."""
+    if isinstance(node, c_ast.Constant) and node.type == 'string':
+        return node.value[1:-1]
+    return None
+
+
+def int_value(node: c_ast.Node) -> Optional[int]:
+    """Evaluate an integer constant expression built from literals, '|', '+', unary '-' and casts."""
+    if isinstance(node, c_ast.Constant) and node.type in ('int', 'unsigned int', 'long int'):
+        try:
+            return int(node.value.rstrip('uUlL'), 0)
+        except ValueError:
+            return None
+    if isinstance(node, c_ast.Cast):
+        return int_value(node.expr)
+    if isinstance(node, c_ast.UnaryOp) and node.op == '-':
+        value = int_value(node.expr)
+        return -value if value is not None else None
+    if isinstance(node, c_ast.BinaryOp) and node.op in ('|', '+'):
+        left, right = int_value(node.left), int_value(node.right)
+        if left is None or right is None:
+            return None
+        return left | right if node.op == '|' else left + right
+    return None
+
+
+def flag_names(flags: Optional[int]) -> List[str]:
+    """Spell a METH_* flag word as flag names, e.g. ['METH_VARARGS', 'METH_KEYWORDS']."""
+    if flags is None:
+        return []
+    return [name for name, bit in METH_FLAGS.items() if flags & bit]
+
+
+def function_name(node: c_ast.Node) -> Optional[str]:
+    """Return the function named by an initializer such as 'f', '(PyCFunction)f' or '&f'."""
+    while isinstance(node, (c_ast.Cast, c_ast.UnaryOp)):
+        if isinstance(node, c_ast.UnaryOp) and node.op != '&':
+            return None
+        node = node.expr
+    if isinstance(node, c_ast.ID):
+        return node.name
+    return None
+
+
+def initializer_fields(init: c_ast.InitList, field_names) -> Dict[str, c_ast.Node]:
+    """
+    Map the fields of a struct initializer to their expressions.
+
+    Handles both positional and designated (``.name = value``) initializers.
+    """
+    fields: Dict[str, c_ast.Node] = {}
+    position = 0
+    for expr in init.exprs:
+        if isinstance(expr, c_ast.NamedInitializer) and expr.name and isinstance(expr.name[0], c_ast.ID):
+            name = expr.name[0].name
+            fields[name] = expr.expr
+            if name in field_names:
+                position = list(field_names).index(name) + 1
+        elif position < len(field_names):
+            fields[field_names[position]] = expr
+            position += 1
+    return fields
+
+
+def extract_method_tables(ast: c_ast.FileAST) -> Dict[str, List[Dict[str, Any]]]:
+    """
+    Extract every PyMethodDef array of a translation unit.
+
+    Args:
+        ast: Parsed translation unit
+
+    Returns:
+        Dictionary mapping table names to their entries; each entry holds
+        ``python_name``, ``c_function``, ``flags`` (int or None if not a
+        constant), ``flag_names`` and ``doc``. The terminating sentinel
+        is omitted.
+    """
+    tables: Dict[str, List[Dict[str, Any]]] = {}
+
+    for ext_decl in ast.ext:
+        if not (isinstance(ext_decl, c_ast.Decl) and isinstance(ext_decl.type, c_ast.ArrayDecl)
+                and isinstance(ext_decl.init, c_ast.InitList)
+                and _type_name(ext_decl.type) in ('PyMethodDef', 'struct PyMethodDef')):
+            continue
+
+        entries = []
+        for item in ext_decl.init.exprs:
+            if not isinstance(item, c_ast.InitList):
+                continue
+            fields = initializer_fields(item, METHOD_DEF_FIELDS)
+            python_name = string_value(fields['ml_name']) if 'ml_name' in fields else None
+            if python_name is None:
+                continue  # {NULL, NULL, 0, NULL} sentinel
+            flags = int_value(fields['ml_flags']) if 'ml_flags' in fields else None
+            entries.append({
+                "python_name": python_name,
+                "c_function": function_name(fields['ml_meth']) if 'ml_meth' in fields else None,
+                "flags": flags,
+                "flag_names": flag_names(flags),
+                "doc": string_value(fields['ml_doc']) if 'ml_doc' in fields else None,
+            })
+        tables[ext_decl.name] = entries
+
+    return tables
+
+
+def extract_module_defs(ast: c_ast.FileAST) -> Dict[str, Dict[str, Any]]:
+    """
+    Extract every PyModuleDef structure of a translation unit.
+
+    Args:
+        ast: Parsed translation unit
+
+    Returns:
+        Dictionary mapping variable names to ``python_name``, ``doc``,
+        ``size`` (per-module state size, -1 for none) and ``methods``
+        (name of the PyMethodDef table, if any)
+    """
+    module_defs: Dict[str, Dict[str, Any]] = {}
+
+    for ext_decl in ast.ext:
+        if not (isinstance(ext_decl, c_ast.Decl) and isinstance(ext_decl.type, c_ast.TypeDecl)
+                and isinstance(ext_decl.init, c_ast.InitList)
+                and _type_name(ext_decl.type) in ('PyModuleDef', 'struct PyModuleDef')):
+            continue
+
+        fields = initializer_fields(ext_decl.init, MODULE_DEF_FIELDS)
+        module_defs[ext_decl.name] = {
+            "python_name": string_value(fields['m_name']) if 'm_name' in fields else None,
+            "doc": string_value(fields['m_doc']) if 'm_doc' in fields else None,
+            "size": int_value(fields['m_size']) if 'm_size' in fields else None,
+            "methods": function_name(fields['m_methods']) if 'm_methods' in fields else None,
+        }
+
+    return module_defs
+
+
+def exported_functions(ast: c_ast.FileAST) -> List[str]:
+    """
+    List the C functions registered in any PyMethodDef table, in table order.
+
+    Args:
+        ast: Parsed translation unit
+
+    Returns:
+        Unique C function names
+    """
+    names: List[str] = []
+    for entries in extract_method_tables(ast).values():
+        for entry in entries:
+            if entry["c_function"] and entry["c_function"] not in names:
+                names.append(entry["c_function"])
+    return names
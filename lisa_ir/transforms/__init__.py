@@ -2,4 +2,11 @@
 Transforms module for LISA-IR
 """
 
-__all__ = []
\ No newline at end of file
+from .ssa import to_ssa, from_ssa, format_function, format_out_of_ssa
+from .simplify_cfg import simplify_cfg, propagate_temporaries, ir_size
+from .dead_temporaries import remove_dead_temporaries
+from .pass_manager import PassManager, AnalysisManager, register_analysis, register_transform
+
+__all__ = ['to_ssa', 'from_ssa', 'format_function', 'format_out_of_ssa',
+           'simplify_cfg', 'propagate_temporaries', 'ir_size', 'remove_dead_temporaries',
+           'PassManager', 'AnalysisManager', 'register_analysis', 'register_transform']
\ No newline at end of file
@@ -0,0 +1,85 @@
+"""
+Dead Temporary Removal for LISA-IR
+
+The converter gives every call result and conditional expression a
+``call_result_N``/``temp_N`` temporary and declares it in
+``FuncDef.local_vars``, whether or not anything reads it. Using liveness,
+this transform drops copies into temporaries that are never read, stops
+calls from storing results nobody reads (the call itself stays), and
+removes the declarations of temporaries no operation mentions any more.
+
+Temporaries named by a semantic operation are kept, so results the
+refcount checker tracks (a discarded new reference is a leak) stay
+visible to it.
+"""
+
+from dataclasses import replace
+from typing import Optional
+
+from lisa_ir.analysis.liveness import Liveness, uses_and_defs
+from lisa_ir.core.ast_converter import is_temporary
+from lisa_ir.ir.ir_nodes import FuncDef, Assign, Call, SemanticOp, UnaryOp, FunctionCall
+from lisa_ir.transforms.ssa import iter_nodes, VARIABLE_ATTRIBUTES
+
+
+# Bound on removal rounds (each round can make the sources of removed copies dead)
+MAX_ROUNDS = 8
+
+
+def has_side_effects(expr) -> bool:
+    """Return whether evaluating an expression may do more than compute a value."""
+    return any(isinstance(node, FunctionCall) or (isinstance(node, UnaryOp) and node.op in ('++', '--', 'p++', 'p--'))
+               for node in iter_nodes(expr))
+
+
+def remove_dead_temporaries(func: FuncDef, liveness: Optional[Liveness] = None) -> Optional[FuncDef]:
+    """
+    Remove dead temporaries from a function.
+
+    Args:
+        func: The function
+        liveness: Its liveness, if already computed
+
+    Returns:
+        The rewritten function, or None if there was nothing to remove
+    """
+    described = {op.attributes.get(key) for block in func.blocks.values() for op in block.operations
+                 if isinstance(op, SemanticOp) for key in VARIABLE_ATTRIBUTES}
+
+    def removable(name: str, live: int) -> bool:
+        return is_temporary(name) and name not in described and not live & liveness.bits([name])
+
+    result = None
+    for _ in range(MAX_ROUNDS):
+        current = result or func
+        if liveness is None or liveness.cfg.func is not current:
+            liveness = Liveness(current)
+        cfg = liveness.cfg
+        blocks = dict(current.blocks)
+        changed = False
+        for block_id, block in enumerate(cfg.blocks):
+            operations = []
+            for op, live in zip(block.operations, liveness.live_after(block_id)):
+                if isinstance(op, Assign) and removable(op.target.name, live) and not has_side_effects(op.value):
+                    continue
+                if isinstance(op, Call) and op.dest_var and removable(op.dest_var, live):
+                    op = replace(op, dest_var=None)
+                operations.append(op)
+            if len(operations) != len(block.operations) or any(a is not b for a, b in zip(operations, block.operations)):
+                blocks[cfg.names[block_id]] = replace(block, operations=operations)
+                changed = True
+        if not changed:
+            break
+        result = replace(current, blocks=blocks)
+
+    current = result or func
+    mentioned = set()
+    for block in current.blocks.values():
+        for op in block.operations + ([block.terminator] if block.terminator is not None else []):
+            uses, defs = uses_and_defs(op)
+            mentioned |= uses | defs
+    unused = [name for name in current.local_vars if is_temporary(name) and name not in mentioned]
+    if unused:
+        result = replace(current, local_vars={name: var_type for name, var_type in current.local_vars.items()
+                                              if name not in unused})
+    return result
@@ -0,0 +1,332 @@
+"""
+Pass Manager for LISA-IR
+
+This module runs pipelines of analyses and transforms over the functions
+of a module. Passes are registered by name together with the analyses
+they require:
+
+- an analysis computes a result from a ``FuncDef`` (a control flow
+  graph, dominators, ...) and is cached per function, so every pass that
+  asks for it afterwards gets the same object
+- a transform returns a replacement ``FuncDef`` (or None if it changed
+  nothing); a change invalidates every cached analysis of the function
+  except those the transform declares it preserves, and anything
+  computed from an invalidated analysis
+
+Functions are independent, so modules with many functions are processed
+in parallel worker processes, each carrying its function's cache there
+and back. Workers are forked, so passes registered at import time of any
+module are available in them. The time spent in each pass is summed over
+all functions for the ``--verbose`` report.
+"""
+
+import logging
+import os
+import time
+from concurrent.futures import ProcessPoolExecutor
+from dataclasses import dataclass
+from typing import Any, Callable, Dict, List, Optional, Sequence, Tuple
+
+from lisa_ir.analysis.cfg import ControlFlowGraph
+from lisa_ir.analysis.liveness import Liveness
+from lisa_ir.ir.ir_nodes import FuncDef, Module, Phi
+from lisa_ir.transforms.dead_temporaries import remove_dead_temporaries
+from lisa_ir.transforms.simplify_cfg import (
+    ir_size, merge_blocks, propagate_temporaries, remove_unreachable_blocks, simplify_cfg, thread_jumps
+)
+from lisa_ir.transforms.ssa import to_ssa, from_ssa
+from lisa_ir.utils.logger import get_logger
+
+
+# Smaller modules are processed in-process; worker start-up would dominate
+PARALLEL_MIN_FUNCTIONS = 32
+
+
+@dataclass(frozen=True)
+class Pass:
+    """A registered analysis or transform."""
+    name: str
+    run: Callable
+    requires: Tuple[str, ...] = ()
+    preserves: Tuple[str, ...] = ()
+    is_analysis: bool = False
+
+
+# Registered passes by name
+PASSES: Dict[str, Pass] = {}
+
+
+def register_analysis(name: str, requires: Sequence[str] = ()):
+    """
+    Register an analysis ``run(func, analyses) -> result`` under a name.
+
+    Args:
+        name: Pass name used in pipelines and ``AnalysisManager.get``
+        requires: Analyses computed before it (and invalidated with it)
+    """
+    def decorator(run: Callable) -> Callable:
+        PASSES[name] = Pass(name=name, run=run, requires=tuple(requires), is_analysis=True)
+        return run
+    return decorator
+
+
+def register_transform(name: str, requires: Sequence[str] = (), preserves: Sequence[str] = ()):
+    """
+    Register a transform ``run(func, analyses) -> Optional[FuncDef]`` under a name.
+
+    Args:
+        name: Pass name used in pipelines
+        requires: Analyses computed before it runs
+        preserves: Analyses that stay valid when it changes the function
+    """
+    def decorator(run: Callable) -> Callable:
+        PASSES[name] = Pass(name=name, run=run, requires=tuple(requires), preserves=tuple(preserves))
+        return run
+    return decorator
+
+
+class AnalysisManager:
+    """Cached analysis results of one function."""
+
+    def __init__(self, func: FuncDef):
+        """
+        Create an empty cache.
+
+        Args:
+            func: The function the results describe
+        """
+        self.func = func
+        self.results: Dict[str, Any] = {}
+        self.timings: Dict[str, List[float]] = {}
+
+    def get(self, name: str) -> Any:
+        """
+        Return an analysis result, computing it and its requirements if needed.
+
+        Args:
+            name: A registered analysis
+
+        Returns:
+            The (cached) result
+        """
+        if name in self.results:
+            return self.results[name]
+        analysis = PASSES.get(name)
+        if analysis is None or not analysis.is_analysis:
+            raise ValueError(f"Unknown analysis: {name}")
+        for requirement in analysis.requires:
+            self.get(requirement)
+        start = time.perf_counter()
+        result = analysis.run(self.func, self)
+        self._record(name, time.perf_counter() - start)
+        self.results[name] = result
+        return result
+
+    def run_transform(self, name: str) -> bool:
+        """
+        Run a transform on the function and invalidate what it changed.
+
+        Args:
+            name: A registered transform
+
+        Returns:
+            Whether the function changed
+        """
+        transform = PASSES[name]
+        for requirement in transform.requires:
+            self.get(requirement)
+        start = time.perf_counter()
+        result = transform.run(self.func, self)
+        self._record(name, time.perf_counter() - start)
+        if result is None:
+            return False
+        self.func = result
+        self.invalidate(transform.preserves)
+        return True
+
+    def invalidate(self, preserved: Sequence[str] = ()) -> None:
+        """
+        Drop cached results, except preserved analyses whose requirements are kept too.
+
+        Args:
+            preserved: Names of analyses that are still valid
+        """
+        kept: Dict[str, Any] = {}
+        for name, result in self.results.items():  # requirements were cached before their users
+            if name in preserved and all(requirement in kept for requirement in PASSES[name].requires):
+                kept[name] = result
+        self.results = kept
+
+    def _record(self, name: str, seconds: float) -> None:
+        entry = self.timings.setdefault(name, [0.0, 0])
+        entry[0] += seconds
+        entry[1] += 1
+
+
+def run_function_passes(manager: AnalysisManager, passes: Sequence[str]) -> AnalysisManager:
+    """
+    Run a pipeline on one function.
+
+    Runs in worker processes, so it takes and returns the picklable manager.
+
+    Args:
+        manager: The function's analysis manager
+        passes: Pass names in order
+
+    Returns:
+        The manager, holding the final function and its cached results
+    """
+    for name in passes:
+        if PASSES[name].is_analysis:
+            manager.get(name)
+        else:
+            manager.run_transform(name)
+    return manager
+
+
+class PassManager:
+    """Runs a pipeline of registered passes over every function of a module."""
+
+    def __init__(self, passes: Sequence[str], max_workers: Optional[int] = None,
+                 min_parallel_functions: int = PARALLEL_MIN_FUNCTIONS, verbose: bool = False):
+        """
+        Create a pass manager.
+
+        Args:
+            passes: Pass names in order
+            max_workers: Worker processes (None uses the CPU count)
+            min_parallel_functions: Modules with fewer functions are processed in-process
+            verbose: Log per-pass timing after each run
+        """
+        unknown = [name for name in passes if name not in PASSES]
+        if unknown:
+            raise ValueError(f"Unknown pass(es): {', '.join(unknown)} (known: {', '.join(sorted(PASSES))})")
+        self.passes = list(passes)
+        self.max_workers = max_workers
+        self.min_parallel_functions = min_parallel_functions
+        self.managers: Dict[str, AnalysisManager] = {}
+        self.timings: Dict[str, List[float]] = {}
+        self.sizes: Optional[Tuple[Tuple[int, int], Tuple[int, int]]] = None
+        self.logger = get_logger("PassManager", level=logging.DEBUG if verbose else logging.INFO)
+
+    def manager(self, func: FuncDef) -> AnalysisManager:
+        """Return the analysis manager of a function, starting a new cache if the function was replaced."""
+        manager = self.managers.get(func.name)
+        if manager is None or manager.func is not func:
+            manager = self.managers[func.name] = AnalysisManager(func)
+        return manager
+
+    def analysis(self, func: FuncDef, name: str) -> Any:
+        """Return a (cached) analysis result for a function."""
+        return self.manager(func).get(name)
+
+    def run(self, module: Module) -> Module:
+        """
+        Run the pipeline over a module, replacing transformed functions in place.
+
+        Args:
+            module: The lifted module
+
+        Returns:
+            The same module
+        """
+        before = ir_size(module)
+        managers = [self.manager(func) for func in module.functions.values()]
+        for manager in managers:
+            manager.timings = {}
+
+        workers = self.max_workers or os.cpu_count() or 1
+        if workers <= 1 or len(managers) < max(2, self.min_parallel_functions):
+            finished = [run_function_passes(manager, self.passes) for manager in managers]
+        else:
+            with ProcessPoolExecutor(max_workers=workers) as pool:
+                finished = list(pool.map(run_function_passes, managers, [self.passes] * len(managers)))
+
+        for manager in finished:
+            module.functions[manager.func.name] = manager.func
+            self.managers[manager.func.name] = manager
+            for name, (seconds, runs) in manager.timings.items():
+                entry = self.timings.setdefault(name, [0.0, 0])
+                entry[0] += seconds
+                entry[1] += runs
+
+        self.sizes = (before, ir_size(module))
+        self.logger.debug("Pass timing:\n" + self.timing_report())
+        return module
+
+    def timing_report(self) -> str:
+        """Render the accumulated time per pass, slowest first."""
+        lines = [f"{'pass':<24} {'runs':>6} {'seconds':>9}"]
+        for name, (seconds, runs) in sorted(self.timings.items(), key=lambda item: -item[1][0]):
+            lines.append(f"{name:<24} {runs:>6} {seconds:>9.4f}")
+        if self.sizes is not None:
+            (blocks, operations), (new_blocks, new_operations) = self.sizes
+            lines.append(f"blocks {blocks} -> {new_blocks}, operations {operations} -> {new_operations}")
+        return "\n".join(lines)
+
+
+@register_analysis("cfg")
+def _cfg(func: FuncDef, analyses: AnalysisManager) -> ControlFlowGraph:
+    return ControlFlowGraph(func)
+
+
+@register_analysis("dominators", requires=("cfg",))
+def _dominators(func: FuncDef, analyses: AnalysisManager) -> List[int]:
+    return analyses.get("cfg").immediate_dominators()
+
+
+@register_analysis("dominance-frontiers", requires=("cfg", "dominators"))
+def _dominance_frontiers(func: FuncDef, analyses: AnalysisManager):
+    return analyses.get("cfg").dominance_frontiers()
+
+
+@register_analysis("loops", requires=("cfg",))
+def _loops(func: FuncDef, analyses: AnalysisManager):
+    return analyses.get("cfg").natural_loops()
+
+
+@register_analysis("liveness", requires=("cfg",))
+def _liveness(func: FuncDef, analyses: AnalysisManager) -> Liveness:
+    return Liveness(func, analyses.get("cfg"))
+
+
+@register_transform("ssa", requires=("cfg",))
+def _ssa(func: FuncDef, analyses: AnalysisManager) -> FuncDef:
+    return to_ssa(func, analyses.get("cfg"))
+
+
+@register_transform("out-of-ssa")
+def _out_of_ssa(func: FuncDef, analyses: AnalysisManager) -> Optional[FuncDef]:
+    if not any(isinstance(op, Phi) for block in func.blocks.values() for op in block.operations):
+        return None
+    return from_ssa(func)
+
+
+@register_transform("remove-unreachable")
+def _remove_unreachable(func: FuncDef, analyses: AnalysisManager) -> Optional[FuncDef]:
+    return remove_unreachable_blocks(func)
+
+
+@register_transform("thread-jumps")
+def _thread_jumps(func: FuncDef, analyses: AnalysisManager) -> Optional[FuncDef]:
+    return thread_jumps(func)
+
+
+@register_transform("merge-blocks")
+def _merge_blocks(func: FuncDef, analyses: AnalysisManager) -> Optional[FuncDef]:
+    return merge_blocks(func)
+
+
+@register_transform("simplify-cfg")
+def _simplify_cfg(func: FuncDef, analyses: AnalysisManager) -> Optional[FuncDef]:
+    return simplify_cfg(func)
+
+
+@register_transform("propagate-temporaries")
+def _propagate_temporaries(func: FuncDef, analyses: AnalysisManager) -> Optional[FuncDef]:
+    return propagate_temporaries(func)
+
+
+@register_transform("remove-dead-temporaries", requires=("liveness",))
+def _remove_dead_temporaries(func: FuncDef, analyses: AnalysisManager) -> Optional[FuncDef]:
+    return remove_dead_temporaries(func, analyses.get("liveness"))
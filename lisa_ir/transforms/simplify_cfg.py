@@ -0,0 +1,248 @@
+"""
+CFG Simplification for LISA-IR
+
+The converter splits every fallible API call into a failure block that
+only jumps on and a success block, and every ``if``/loop into its own
+header, body and merge blocks, so lifted functions carry many blocks that
+hold a single jump or a short run of straight-line code. These transforms
+shrink that graph without changing what any path does:
+
+- ``remove_unreachable_blocks`` drops blocks the entry cannot reach
+- ``thread_jumps`` retargets branches past blocks that only jump on, and
+  turns branches whose targets coincide into jumps
+- ``merge_blocks`` appends a block to its predecessor when that is its
+  only predecessor and jumps straight to it
+- ``propagate_temporaries`` lets a call write directly into the variable
+  its ``call_result_N`` temporary is copied to, renaming the temporary in
+  the call's semantic operations
+
+``simplify_cfg`` runs the three graph transforms to a fixpoint. Each
+transform returns a new ``FuncDef`` (sharing untouched blocks) or None if
+there was nothing to do, as the pass manager expects.
+"""
+
+from dataclasses import replace
+from typing import Dict, Optional, Tuple
+
+from lisa_ir.analysis.cfg import ControlFlowGraph, terminator_targets
+from lisa_ir.core.ast_converter import CALL_RESULT_PREFIX
+from lisa_ir.ir.ir_nodes import (
+    FuncDef, Module, Variable, Assign, Call, SemanticOp, BranchIf, Jump, Switch, make_jump
+)
+from lisa_ir.transforms.ssa import iter_nodes, VARIABLE_ATTRIBUTES
+
+
+def ir_size(module: Module) -> Tuple[int, int]:
+    """Return the number of blocks and of operations (terminators included) in a module."""
+    blocks = operations = 0
+    for func in module.functions.values():
+        blocks += len(func.blocks)
+        operations += sum(len(block.operations) + (block.terminator is not None) for block in func.blocks.values())
+    return blocks, operations
+
+
+def remove_unreachable_blocks(func: FuncDef) -> Optional[FuncDef]:
+    """
+    Drop the blocks the entry cannot reach.
+
+    Args:
+        func: The function
+
+    Returns:
+        The function without them, or None if every block is reachable
+    """
+    cfg = ControlFlowGraph(func)
+    if len(cfg.rpo) == len(cfg):
+        return None
+    return replace(func, blocks={name: block for name, block in func.blocks.items()
+                                 if cfg.reachable(cfg.index[name])})
+
+
+def _retarget(terminator, forward: Dict[str, str]):
+    """Rebuild a terminator with its targets forwarded; branches to one target become jumps."""
+    if isinstance(terminator, BranchIf):
+        true_target = forward.get(terminator.true_target, terminator.true_target)
+        false_target = forward.get(terminator.false_target, terminator.false_target)
+        if true_target == false_target:
+            return make_jump(true_target, terminator.coord)
+        return replace(terminator, true_target=true_target, false_target=false_target)
+    if isinstance(terminator, Jump):
+        return replace(terminator, target=forward.get(terminator.target, terminator.target))
+    if isinstance(terminator, Switch):
+        default = terminator.default_target
+        return replace(terminator, cases={value: forward.get(target, target)
+                                          for value, target in terminator.cases.items()},
+                       default_target=forward.get(default, default))
+    return terminator
+
+
+def thread_jumps(func: FuncDef) -> Optional[FuncDef]:
+    """
+    Send branches straight to the block a chain of empty jump blocks ends in.
+
+    The entry block is never bypassed, so the function keeps its entry and
+    the skipped blocks are left unreachable for remove_unreachable_blocks.
+
+    Args:
+        func: The function
+
+    Returns:
+        The rewritten function, or None if no branch changed
+    """
+    hops = {name: block.terminator.target for name, block in func.blocks.items()
+            if name != func.entry_point and not block.operations and isinstance(block.terminator, Jump)
+            and block.terminator.target in func.blocks}
+
+    forward: Dict[str, str] = {}
+    for start in hops:
+        seen = {start}
+        target = hops[start]
+        while target in hops and target not in seen:  # an empty infinite loop stops the chain
+            seen.add(target)
+            target = hops[target]
+        forward[start] = target
+
+    blocks = {}
+    changed = False
+    for name, block in func.blocks.items():
+        terminator = _retarget(block.terminator, forward)
+        if terminator is not block.terminator and terminator != block.terminator:
+            block = replace(block, terminator=terminator)
+            changed = True
+        blocks[name] = block
+    return replace(func, blocks=blocks) if changed else None
+
+
+def merge_blocks(func: FuncDef) -> Optional[FuncDef]:
+    """
+    Append blocks to their only predecessor when it jumps straight to them.
+
+    Args:
+        func: The function
+
+    Returns:
+        The rewritten function, or None if no blocks were merged
+    """
+    pred_counts: Dict[str, int] = {}
+    for block in func.blocks.values():
+        for target in terminator_targets(block.terminator):
+            pred_counts[target] = pred_counts.get(target, 0) + 1
+
+    blocks = dict(func.blocks)
+    merged = False
+    for name in func.blocks:
+        if name not in blocks:
+            continue  # already appended to its predecessor
+        block = blocks[name]
+        while isinstance(block.terminator, Jump):
+            target = block.terminator.target
+            if (target == name or target == func.entry_point or target not in blocks
+                    or pred_counts.get(target) != 1):
+                break
+            successor = blocks.pop(target)
+            block = replace(block, operations=block.operations + successor.operations,
+                            terminator=successor.terminator)
+            merged = True
+        blocks[name] = block
+    return replace(func, blocks=blocks) if merged else None
+
+
+def simplify_cfg(func: FuncDef) -> Optional[FuncDef]:
+    """
+    Thread jumps, remove unreachable blocks and merge straight-line blocks until nothing changes.
+
+    Args:
+        func: The function
+
+    Returns:
+        The simplified function, or None if it was already simple
+    """
+    result = None
+    changed = True
+    while changed:
+        changed = False
+        for transform in (thread_jumps, remove_unreachable_blocks, merge_blocks):
+            simplified = transform(result or func)
+            if simplified is not None:
+                result = simplified
+                changed = True
+    return result
+
+
+def _mentions(op, name: str) -> int:
+    """Count how often an operation reads or writes a variable."""
+    count = sum(1 for node in iter_nodes(op) if isinstance(node, Variable) and node.name == name)
+    if isinstance(op, Call) and op.dest_var == name:
+        count += 1
+    if isinstance(op, SemanticOp):
+        count += sum(1 for key in VARIABLE_ATTRIBUTES if op.attributes.get(key) == name)
+    return count
+
+
+def propagate_temporaries(func: FuncDef) -> Optional[FuncDef]:
+    """
+    Let calls assign their final variable instead of a ``call_result_N`` temporary.
+
+    A temporary is replaced when it is only used by the semantic operations
+    following its call and by one plain copy ``x = call_result_N`` later in
+    the same block, and nothing in between touches ``x``. Run it after
+    simplify_cfg, which merges the call's success block into its block.
+
+    Args:
+        func: The function
+
+    Returns:
+        The rewritten function, or None if no temporary could be replaced
+    """
+    uses: Dict[str, int] = {}
+    for block in func.blocks.values():
+        for op in list(block.operations) + [block.terminator]:
+            if op is None:
+                continue
+            for node in iter_nodes(op):
+                if isinstance(node, Variable) and node.name.startswith(CALL_RESULT_PREFIX):
+                    uses[node.name] = uses.get(node.name, 0) + 1
+            if isinstance(op, SemanticOp):
+                for key in VARIABLE_ATTRIBUTES:
+                    value = op.attributes.get(key)
+                    if isinstance(value, str) and value.startswith(CALL_RESULT_PREFIX):
+                        uses[value] = uses.get(value, 0) + 1
+
+    blocks = dict(func.blocks)
+    local_vars = dict(func.local_vars)
+    changed = False
+    for name, block in func.blocks.items():
+        operations = list(block.operations)
+        i = 0
+        while i < len(operations):
+            op = operations[i]
+            temp = op.dest_var if isinstance(op, Call) else None
+            i += 1
+            if not temp or not temp.startswith(CALL_RESULT_PREFIX):
+                continue
+            # The semantic operations describing the call, then the copy
+            j = i
+            seen = 0
+            while j < len(operations) and isinstance(operations[j], SemanticOp):
+                seen += _mentions(operations[j], temp)
+                j += 1
+            if j == len(operations):
+                continue
+            copy = operations[j]
+            if not (isinstance(copy, Assign) and isinstance(copy.value, Variable) and copy.value.name == temp):
+                continue
+            target = copy.target.name
+            if seen + 1 != uses.get(temp) or any(_mentions(operations[k], target) for k in range(i, j)):
+                continue
+
+            operations[i - 1] = replace(op, dest_var=target)
+            for k in range(i, j):
+                attributes = {key: target if key in VARIABLE_ATTRIBUTES and value == temp else value
+                              for key, value in operations[k].attributes.items()}
+                operations[k] = replace(operations[k], attributes=attributes)
+            del operations[j]
+            local_vars.pop(temp, None)
+            changed = True
+        if len(operations) != len(block.operations):
+            blocks[name] = replace(block, operations=operations)
+    return replace(func, blocks=blocks, local_vars=local_vars) if changed else None
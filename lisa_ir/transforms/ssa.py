@@ -0,0 +1,418 @@
+"""
+SSA Construction for LISA-IR
+
+This module converts a lifted function into static single assignment
+form and back. Every local variable, parameter and call result temporary
+whose address is never taken gets one name per definition (``list.1``,
+``list.2``, ...; the value on entry keeps the plain name), and ``Phi``
+operations at the start of a block merge the versions reaching it. Uses in
+expressions, terminators and the ``target``/``dest``/``source`` attributes
+of semantic operations are renamed to the version that reaches them, so
+def-use chains can be read off the names directly.
+
+Phis are placed at the iterated dominance frontiers of each variable's
+defining blocks (Cytron et al.), using the dominators of
+``ControlFlowGraph``. Only variables that are live into some block are
+considered (semi-pruned SSA), which skips the many temporaries that are
+defined and consumed within one block; phis that still turn out dead
+(no operation reads the merged value) are removed after renaming.
+
+Leaving SSA replaces each phi with copies at the end of its predecessor
+blocks. The pass never moves or coalesces versions, so the result is
+conventional SSA and the copies are correct without splitting edges.
+"""
+
+from dataclasses import replace
+from typing import Callable, Dict, List, Optional, Set
+
+from lisa_ir.analysis.cfg import ControlFlowGraph
+from lisa_ir.analysis.liveness import VARIABLE_ATTRIBUTES
+from lisa_ir.ir.ir_nodes import (
+    IRNode, FuncDef, BasicBlock, Variable, Constant, BinaryOp, UnaryOp, Cast, FunctionCall,
+    ArrayRef, StructRef, Dereference, AddressOf, Load, Assign, Call, Store, SemanticOp, Phi,
+    Return, BranchIf, Jump, Switch, Unreachable, make_jump
+)
+
+
+# Separates a variable from its version (not valid in C identifiers)
+VERSION_SEPARATOR = "."
+
+
+def ssa_name(name: str, version: int) -> str:
+    """Return the SSA name of a variable version (version 0 is the value on entry)."""
+    return name if version == 0 else f"{name}{VERSION_SEPARATOR}{version}"
+
+
+def base_name(name: str) -> str:
+    """Return the source variable an SSA name is a version of."""
+    return name.split(VERSION_SEPARATOR, 1)[0]
+
+
+def iter_nodes(node):
+    """Yield an IR node and all nodes nested in it (depth first)."""
+    stack = [node]
+    while stack:
+        current = stack.pop()
+        yield current
+        for value in current.__dict__.values():
+            if isinstance(value, IRNode):
+                stack.append(value)
+            elif isinstance(value, list):
+                stack.extend(item for item in value if isinstance(item, IRNode))
+            elif isinstance(value, dict):
+                stack.extend(item for item in value.values() if isinstance(item, IRNode))
+
+
+def map_variables(node, rename: Callable[[str], str]):
+    """
+    Rebuild an expression (or terminator) with its variables renamed.
+
+    Unchanged subtrees are shared with the input.
+
+    Args:
+        node: The IR node
+        rename: Maps a variable name to its new name
+
+    Returns:
+        The renamed node
+    """
+    if isinstance(node, Variable):
+        name = rename(node.name)
+        return node if name == node.name else Variable(name=name, coord=node.coord)
+    if not isinstance(node, IRNode):
+        return node
+    changes = {}
+    for key, value in node.__dict__.items():
+        if isinstance(value, IRNode):
+            new_value = map_variables(value, rename)
+        elif isinstance(value, list):
+            new_value = [map_variables(item, rename) for item in value]
+            if all(a is b for a, b in zip(new_value, value)):
+                continue
+        elif isinstance(value, dict):
+            new_value = {k: map_variables(v, rename) for k, v in value.items()}
+            if all(new_value[k] is v for k, v in value.items()):
+                continue
+        else:
+            continue
+        if new_value is not value:
+            changes[key] = new_value
+    return replace(node, **changes) if changes else node
+
+
+def ssa_variables(func: FuncDef) -> Set[str]:
+    """
+    Return the variables of a function that can be put in SSA form.
+
+    These are its parameters, locals and call result temporaries, minus
+    any whose address is taken (they may change behind a pointer).
+    """
+    names = {param.name for param in func.params} | set(func.local_vars)
+    address_taken = set()
+    for block in func.blocks.values():
+        for op in block.operations:
+            if isinstance(op, Call) and op.dest_var:
+                names.add(op.dest_var)
+            for node in iter_nodes(op):
+                if isinstance(node, AddressOf) and isinstance(node.expr, Variable):
+                    address_taken.add(node.expr.name)
+    return names - address_taken
+
+
+def _operation_uses(op) -> Set[str]:
+    """Names a (non-phi) operation reads."""
+    if isinstance(op, Assign):
+        nodes = iter_nodes(op.value)
+    elif isinstance(op, SemanticOp):
+        return {op.attributes[key] for key in VARIABLE_ATTRIBUTES if isinstance(op.attributes.get(key), str)}
+    else:
+        nodes = iter_nodes(op)
+    return {node.name for node in nodes if isinstance(node, Variable)}
+
+
+def _operation_def(op) -> Optional[str]:
+    """Name a (non-phi) operation defines, if any."""
+    if isinstance(op, Assign):
+        return op.target.name
+    if isinstance(op, Call):
+        return op.dest_var
+    return None
+
+
+def to_ssa(func: FuncDef, cfg: Optional[ControlFlowGraph] = None) -> FuncDef:
+    """
+    Convert a function to SSA form.
+
+    Args:
+        func: The lifted function (left unchanged)
+        cfg: Its control flow graph, if already built
+
+    Returns:
+        A new FuncDef in SSA form; unreachable blocks are copied unrenamed
+    """
+    if cfg is None or cfg.func is not func:
+        cfg = ControlFlowGraph(func)
+    if not cfg.rpo:
+        return replace(func, blocks=dict(func.blocks), local_vars=dict(func.local_vars))
+    if cfg.preds[cfg.entry]:
+        # Phis need an edge for the value on entry, so the entry must not be a loop header
+        entry = BasicBlock(name="ssa_entry", terminator=make_jump(func.entry_point))
+        blocks = {entry.name: entry, **func.blocks}
+        return to_ssa(replace(func, entry_point=entry.name, blocks=blocks))
+
+    variables = ssa_variables(func)
+    types = dict(func.local_vars)
+    types.update({param.name: param.param_type for param in func.params})
+
+    # Defining blocks of every variable, and the variables live into some block
+    def_blocks: Dict[str, Set[int]] = {}
+    nonlocal_names: Set[str] = set()
+    for block_id in cfg.rpo:
+        block = cfg.blocks[block_id]
+        defined = set()
+        for op in block.operations:
+            nonlocal_names.update(_operation_uses(op) - defined)
+            target = _operation_def(op)
+            if target in variables:
+                defined.add(target)
+                def_blocks.setdefault(target, set()).add(block_id)
+        if block.terminator is not None:
+            nonlocal_names.update(node.name for node in iter_nodes(block.terminator)
+                                  if isinstance(node, Variable) and node.name not in defined)
+
+    phi_vars: List[List[str]] = [[] for _ in cfg.names]
+    for name, blocks in def_blocks.items():
+        if name in nonlocal_names:
+            for block_id in sorted(cfg.iterated_frontier(blocks)):
+                phi_vars[block_id].append(name)
+
+    counters: Dict[str, int] = {}
+    stacks: Dict[str, List[str]] = {}
+    new_blocks: Dict[int, BasicBlock] = {}
+    # Targets are renamed when the block is visited, operands when each predecessor is
+    phis = [[Phi(target=Variable(name), incoming={}, coord=cfg.blocks[block_id].coord) for name in names]
+            for block_id, names in enumerate(phi_vars)]
+    local_vars = dict(func.local_vars)
+
+    def current(name: str) -> str:
+        stack = stacks.get(name)
+        return stack[-1] if stack else name
+
+    def define(name: str, pushed: List[str]) -> str:
+        counters[name] = counters.get(name, 0) + 1
+        version = ssa_name(name, counters[name])
+        stacks.setdefault(name, []).append(version)
+        pushed.append(name)
+        if name in types:
+            local_vars[version] = types[name]
+        return version
+
+    def use(name: str) -> str:
+        return current(name) if name in variables else name
+
+    children = cfg.dominator_tree()
+    work = [(cfg.entry, None)]
+    while work:
+        block_id, pushed = work.pop()
+        if pushed is not None:
+            for name in pushed:
+                stacks[name].pop()
+            continue
+
+        pushed = []
+        block = cfg.blocks[block_id]
+        for phi in phis[block_id]:
+            phi.target = Variable(define(phi.target.name, pushed))
+
+        operations = list(phis[block_id])
+        for op in block.operations:
+            if isinstance(op, Assign):
+                value = map_variables(op.value, use)
+                target = op.target.name
+                if target in variables:
+                    op = replace(op, target=Variable(define(target, pushed), coord=op.target.coord), value=value)
+                elif value is not op.value:
+                    op = replace(op, value=value)
+            elif isinstance(op, Call):
+                args = [map_variables(arg, use) for arg in op.args]
+                dest = define(op.dest_var, pushed) if op.dest_var in variables else op.dest_var
+                op = replace(op, args=args, dest_var=dest)
+            elif isinstance(op, SemanticOp):
+                attributes = dict(op.attributes)
+                for key in VARIABLE_ATTRIBUTES:
+                    if isinstance(attributes.get(key), str):
+                        attributes[key] = use(attributes[key])
+                op = replace(op, attributes=attributes)
+            else:
+                op = map_variables(op, use)
+            operations.append(op)
+
+        terminator = map_variables(block.terminator, use) if block.terminator is not None else None
+        new_blocks[block_id] = replace(block, operations=operations, terminator=terminator)
+
+        for succ in cfg.succs[block_id]:
+            for phi, name in zip(phis[succ], phi_vars[succ]):
+                phi.incoming[cfg.names[block_id]] = Variable(current(name))
+
+        work.append((block_id, pushed))
+        work.extend((child, None) for child in reversed(children[block_id]))
+
+    # Drop phis whose value no operation needs (semi-pruning places some for dead variables)
+    used: Set[str] = set()
+    for block in new_blocks.values():
+        for op in block.operations:
+            if not isinstance(op, Phi):
+                used.update(_operation_uses(op))
+        if block.terminator is not None:
+            used.update(node.name for node in iter_nodes(block.terminator) if isinstance(node, Variable))
+    by_target = {phi.target.name: phi for block_phis in phis for phi in block_phis}
+    work_names = [name for name in used if name in by_target]
+    live = set(work_names)
+    while work_names:
+        for value in by_target[work_names.pop()].incoming.values():
+            if value.name in by_target and value.name not in live:
+                live.add(value.name)
+                work_names.append(value.name)
+    for block_id, block in new_blocks.items():
+        if any(phi.target.name not in live for phi in phis[block_id]):
+            block.operations = [op for op in block.operations
+                                if not (isinstance(op, Phi) and op.target.name not in live)]
+    for name in by_target.keys() - live:
+        local_vars.pop(name, None)
+
+    blocks = {}
+    for block_id, name in enumerate(cfg.names):
+        blocks[name] = new_blocks.get(block_id, cfg.blocks[block_id])
+    return replace(func, blocks=blocks, local_vars=local_vars)
+
+
+def from_ssa(func: FuncDef) -> FuncDef:
+    """
+    Translate a function out of SSA form by replacing phis with copies.
+
+    Each phi becomes one assignment at the end of every predecessor it
+    lists. Copies into one block are parallel; if a copy would read a
+    version another copy of the same edge writes, the source is saved in
+    a temporary first.
+
+    Args:
+        func: A function produced by to_ssa
+
+    Returns:
+        A new FuncDef without Phi operations
+    """
+    copies: Dict[str, List[Assign]] = {}
+    blocks: Dict[str, BasicBlock] = {}
+    for name, block in func.blocks.items():
+        operations = []
+        for op in block.operations:
+            if isinstance(op, Phi):
+                for pred, value in op.incoming.items():
+                    if not (isinstance(value, Variable) and value.name == op.target.name):
+                        copies.setdefault(pred, []).append(Assign(target=op.target, value=value, coord=op.coord))
+            else:
+                operations.append(op)
+        blocks[name] = replace(block, operations=operations)
+
+    local_vars = dict(func.local_vars)
+    for pred, edge_copies in copies.items():
+        if pred not in blocks:
+            continue
+        targets = {copy.target.name for copy in edge_copies}
+        saved = []
+        for i, copy in enumerate(edge_copies):
+            if isinstance(copy.value, Variable) and copy.value.name in targets:
+                temp = f"{copy.value.name}{VERSION_SEPARATOR}copy"
+                if copy.value.name in local_vars:
+                    local_vars[temp] = local_vars[copy.value.name]
+                saved.append(Assign(target=Variable(temp), value=copy.value, coord=copy.coord))
+                edge_copies[i] = replace(copy, value=Variable(temp))
+        block = blocks[pred]
+        blocks[pred] = replace(block, operations=block.operations + saved + edge_copies)
+    return replace(func, blocks=blocks, local_vars=local_vars)
+
+
+def format_expression(expr) -> str:
+    """Render an IR expression as C-like text."""
+    if expr is None:
+        return ""
+    if isinstance(expr, Variable):
+        return expr.name
+    if isinstance(expr, Constant):
+        return str(expr.value)
+    if isinstance(expr, BinaryOp):
+        return f"({format_expression(expr.left)} {expr.op} {format_expression(expr.right)})"
+    if isinstance(expr, UnaryOp):
+        operand = format_expression(expr.operand)
+        return f"{operand}{expr.op[1:]}" if expr.op in ('p++', 'p--') else f"{expr.op}{operand}"
+    if isinstance(expr, Cast):
+        return f"({expr.target_type}){format_expression(expr.expr)}"
+    if isinstance(expr, FunctionCall):
+        return f"{expr.function_name}({', '.join(format_expression(arg) for arg in expr.args)})"
+    if isinstance(expr, ArrayRef):
+        return f"{format_expression(expr.array)}[{format_expression(expr.index)}]"
+    if isinstance(expr, StructRef):
+        return f"{format_expression(expr.struct)}{'->' if expr.is_arrow else '.'}{expr.field}"
+    if isinstance(expr, (Dereference, Load)):
+        return f"*{format_expression(expr.expr if isinstance(expr, Dereference) else expr.address)}"
+    if isinstance(expr, AddressOf):
+        return f"&{format_expression(expr.expr)}"
+    return repr(expr)
+
+
+def format_operation(op) -> str:
+    """Render one operation or terminator as a line of C-like text."""
+    if isinstance(op, Assign):
+        return f"{op.target.name} = {format_expression(op.value)};"
+    if isinstance(op, Call):
+        call = f"{op.function_name}({', '.join(format_expression(arg) for arg in op.args)});"
+        return f"{op.dest_var} = {call}" if op.dest_var else call
+    if isinstance(op, Store):
+        return f"{format_expression(op.address)} = {format_expression(op.value)};"
+    if isinstance(op, Phi):
+        incoming = ", ".join(f"{pred}: {format_expression(value)}" for pred, value in op.incoming.items())
+        return f"{op.target.name} = phi({incoming});"
+    if isinstance(op, SemanticOp):
+        attributes = " ".join(f"{key}={value}" for key, value in op.attributes.items())
+        return f"// {op.op_type} {attributes}".rstrip()
+    if isinstance(op, Return):
+        return f"return {format_expression(op.value)};" if op.value is not None else "return;"
+    if isinstance(op, BranchIf):
+        condition = format_expression(op.condition)
+        condition = condition if condition.startswith("(") and condition.endswith(")") else f"({condition})"
+        return f"if {condition} goto {op.true_target}; else goto {op.false_target};"
+    if isinstance(op, Jump):
+        return f"goto {op.target};"
+    if isinstance(op, Switch):
+        cases = " ".join(f"case {value}: goto {target};" for value, target in op.cases.items())
+        default = f" default: goto {op.default_target};" if op.default_target else ""
+        return f"switch ({format_expression(op.expr)}) {{ {cases}{default} }}"
+    if isinstance(op, Unreachable):
+        return "__builtin_unreachable();"
+    return repr(op)
+
+
+def format_function(func: FuncDef) -> str:
+    """
+    Render a function as C-like text with one label per basic block.
+
+    Args:
+        func: The function (in or out of SSA form)
+
+    Returns:
+        The listing
+    """
+    params = ", ".join(f"{param.param_type} {param.name}" for param in func.params)
+    lines = [f"{func.return_type or 'void'} {func.name}({params})", "{"]
+    for name, block in func.blocks.items():
+        lines.append(f"{name}:")
+        lines.extend(f"    {format_operation(op)}" for op in block.operations)
+        if block.terminator is not None:
+            lines.append(f"    {format_operation(block.terminator)}")
+    lines.append("}")
+    return "\n".join(lines)
+
+
+def format_out_of_ssa(func: FuncDef) -> str:
+    """Render an SSA function after replacing its phis with copies."""
+    return format_function(from_ssa(func))
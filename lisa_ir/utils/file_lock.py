@@ -0,0 +1,128 @@
+"""
+File locking and atomic write helpers for LISA-IR
+
+These helpers let several processes share the on-disk stores (semantic
+database, caches) without corrupting them: writers hold an exclusive lock
+on a sidecar ``.lock`` file and replace the target with an atomic rename.
+"""
+
+import json
+import os
+import tempfile
+import time
+from pathlib import Path
+from typing import Any, Optional, Union
+
+try:
+    import fcntl
+except ImportError:  # pragma: no cover - Windows
+    fcntl = None
+    import msvcrt
+
+
+class FileLock:
+    """
+    Exclusive inter-process lock backed by a sidecar lock file.
+
+    The lock is advisory: every process touching the protected file must
+    use a FileLock on the same path. Usable as a context manager.
+    """
+
+    def __init__(self, path: Union[str, Path], timeout: Optional[float] = 30.0,
+                 poll_interval: float = 0.05):
+        """
+        Initialize the lock.
+
+        Args:
+            path: Path of the file to protect (the lock file is ``<path>.lock``)
+            timeout: Seconds to wait for the lock, or None to wait forever
+            poll_interval: Seconds between acquisition attempts
+        """
+        self.lock_path = Path(str(path) + ".lock")
+        self.timeout = timeout
+        self.poll_interval = poll_interval
+        self._fd = None
+
+    def acquire(self) -> None:
+        """
+        Acquire the lock, blocking until it is available.
+
+        Raises:
+            TimeoutError: If the lock could not be acquired within the timeout
+        """
+        self.lock_path.parent.mkdir(parents=True, exist_ok=True)
+        fd = os.open(str(self.lock_path), os.O_RDWR | os.O_CREAT, 0o644)
+        deadline = None if self.timeout is None else time.monotonic() + self.timeout
+
+        while True:
+            try:
+                if fcntl is not None:
+                    fcntl.flock(fd, fcntl.LOCK_EX | fcntl.LOCK_NB)
+                else:  # pragma: no cover - Windows
+                    msvcrt.locking(fd, msvcrt.LK_NBLCK, 1)
+                self._fd = fd
+                return
+            except (BlockingIOError, PermissionError, OSError):
+                if deadline is not None and time.monotonic() >= deadline:
+                    os.close(fd)
+                    raise TimeoutError(f"Timed out waiting for lock {self.lock_path}")
+                time.sleep(self.poll_interval)
+
+    def release(self) -> None:
+        """Release the lock if it is held."""
+        if self._fd is None:
+            return
+        try:
+            if fcntl is not None:
+                fcntl.flock(self._fd, fcntl.LOCK_UN)
+            else:  # pragma: no cover - Windows
+                msvcrt.locking(self._fd, msvcrt.LK_UNLCK, 1)
+        finally:
+            os.close(self._fd)
+            self._fd = None
+
+    def __enter__(self) -> 'FileLock':
+        self.acquire()
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback) -> None:
+        self.release()
+
+
+def atomic_write_text(path: Union[str, Path], text: str) -> None:
+    """
+    Write text to a file atomically.
+
+    The content is written to a temporary file in the same directory,
+    flushed to disk and then renamed over the target, so readers observe
+    either the old or the new content, never a partial write.
+
+    Args:
+        path: Destination file path
+        text: Content to write
+    """
+    path = Path(path)
+    path.parent.mkdir(parents=True, exist_ok=True)
+    fd, tmp_path = tempfile.mkstemp(prefix=f".{path.name}.", suffix=".tmp", dir=str(path.parent))
+    try:
+        with os.fdopen(fd, 'w', encoding='utf-8') as f:
+            f.write(text)
+            f.flush()
+            os.fsync(f.fileno())
+        os.replace(tmp_path, path)
+    except BaseException:
+        if os.path.exists(tmp_path):
+            os.unlink(tmp_path)
+        raise
+
+
+def atomic_write_json(path: Union[str, Path], data: Any, indent: Optional[int] = 2) -> None:
+    """
+    Serialize data as JSON and write it atomically.
+
+    Args:
+        path: Destination file path
+        data: JSON-serializable data
+        indent: Indentation passed to json.dumps
+    """
+    atomic_write_text(path, json.dumps(data, indent=indent, ensure_ascii=False))
@@ -0,0 +1,314 @@
+#!/usr/bin/env python3
+"""
+Mock LLM Server for the Auxiliary Layer
+
+A local stand-in for the OpenAI-compatible chat completions endpoint the
+auxiliary layer talks to. It answers with canned semantic information
+(or responses replayed from a recording) after a configurable latency,
+and fails a configurable fraction of requests, so the auxiliary layer
+can be tested and benchmarked offline. Streamed completions are sent as
+server-sent events, optionally followed by commentary after the JSON
+answer the way verbose models do.
+"""
+
+import hashlib
+import json
+import random
+import re
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from typing import Dict, Any, Optional
+
+import requests
+
+
+# Code blocks holding the functions to analyze (everything after the few-shot examples)
+_QUERY_MARKER = "Now analyze"
+_CODE_BLOCK_PATTERN = re.compile(r'```c\n(.*?)\n```', re.DOTALL)
+_FUNCTION_NAME_PATTERN = re.compile(r'([A-Za-z_][A-Za-z0-9_]*)\s*\([^()]*\)\s*$')
+
+# Characters sent per streamed chunk (roughly a few tokens)
+STREAM_CHUNK_CHARS = 16
+
+_COMMENTARY = ("The analysis above follows from the comment and the signature; "
+               "callers must release the returned reference when it is new. ")
+
+
+def prompt_key(prompt: str) -> str:
+    """Hash identifying a prompt in recordings."""
+    return hashlib.sha256(prompt.encode('utf-8')).hexdigest()
+
+
+def canned_answer(prompt: str) -> str:
+    """
+    Build a plausible answer for a single or batched auxiliary-layer prompt.
+
+    Each queried function is classified with the auxiliary layer's comment
+    heuristics, falling back to a new reference returned as NULL on error.
+
+    Args:
+        prompt: Prompt text (thinking markers included)
+
+    Returns:
+        Response content with a fenced JSON object keyed by function name
+    """
+    from lisa_ir.core.auxiliary_layer import classify_by_heuristics
+
+    query = prompt.split(_QUERY_MARKER, 1)[-1]
+    answer = {}
+    for block in _CODE_BLOCK_PATTERN.findall(query):
+        comment_end = block.rfind('*/')
+        comment = block[:comment_end].strip('/* \n') if comment_end != -1 else ""
+        signature = block[comment_end + 2:].strip() if comment_end != -1 else block.strip()
+        name_match = _FUNCTION_NAME_PATTERN.search(signature)
+        if not name_match:
+            continue
+        answer[name_match.group(1)] = classify_by_heuristics(signature, comment) or {
+            "return_ref_type": "new_ref",
+            "arg_ref_steal": {},
+            "error_return": "NULL"
+        }
+    return "```json\n" + json.dumps(answer, indent=2) + "\n```"
+
+
+class _Server(ThreadingHTTPServer):
+    daemon_threads = True
+    request_queue_size = 128  # concurrent clients must not overflow the listen backlog
+
+
+class MockLLMServer:
+    """
+    Threaded mock of an OpenAI-compatible chat completions endpoint.
+
+    Usable as a context manager; ``url`` is the endpoint to pass to the
+    auxiliary layer once started.
+    """
+
+    def __init__(self,
+                 host: str = "127.0.0.1",
+                 port: int = 0,
+                 latency: float = 0.0,
+                 latency_jitter: float = 0.0,
+                 error_rate: float = 0.0,
+                 responses: Optional[Dict[str, str]] = None,
+                 record_from: Optional[str] = None,
+                 trailing_chars: int = 0,
+                 chunk_delay: float = 0.0,
+                 seed: Optional[int] = None):
+        """
+        Initialize the server.
+
+        Args:
+            host: Interface to bind
+            port: Port to bind (0 picks a free port)
+            latency: Mean seconds before each answer
+            latency_jitter: Maximum seconds added to or removed from the latency
+            error_rate: Fraction of requests answered with HTTP 500
+            responses: Recorded responses keyed by prompt_key(); unknown prompts get canned answers
+            record_from: Real endpoint to forward unknown prompts to, recording its answers
+            trailing_chars: Commentary characters appended after each answer
+            chunk_delay: Seconds between streamed chunks (simulated generation speed)
+            seed: Seed for the latency and error randomness
+        """
+        self.latency = latency
+        self.latency_jitter = latency_jitter
+        self.error_rate = error_rate
+        self.responses = dict(responses or {})
+        self.record_from = record_from
+        self.trailing_chars = trailing_chars
+        self.chunk_delay = chunk_delay
+        self.random = random.Random(seed)
+        self.lock = threading.Lock()
+        self.request_count = 0
+        self.error_count = 0
+        self.streams_closed_early = 0
+
+        self.httpd = _Server((host, port), self._make_handler())
+        self.thread: Optional[threading.Thread] = None
+
+    @property
+    def url(self) -> str:
+        host, port = self.httpd.server_address[:2]
+        return f"http://{host}:{port}/v1/chat/completions"
+
+    def _make_handler(self):
+        server = self
+
+        class Handler(BaseHTTPRequestHandler):
+            def log_message(self, format, *args):
+                pass
+
+            def do_POST(self):
+                length = int(self.headers.get('Content-Length', 0))
+                try:
+                    payload = json.loads(self.rfile.read(length) or b'{}')
+                except json.JSONDecodeError:
+                    self._send(400, {"error": "invalid JSON"})
+                    return
+                status, body = server.handle_completion(payload)
+                if status == 200 and payload.get("stream"):
+                    self._send_stream(body["choices"][0]["message"]["content"])
+                else:
+                    if status == 200 and server.chunk_delay:
+                        # A complete response arrives only after the whole answer is generated
+                        content = body["choices"][0]["message"]["content"]
+                        time.sleep(server.chunk_delay * -(-len(content) // STREAM_CHUNK_CHARS))
+                    self._send(status, body)
+
+            def _send_stream(self, content: str):
+                self.send_response(200)
+                self.send_header('Content-Type', 'text/event-stream')
+                self.send_header('Cache-Control', 'no-cache')
+                self.end_headers()
+                try:
+                    for start in range(0, len(content), STREAM_CHUNK_CHARS):
+                        chunk = {"object": "chat.completion.chunk",
+                                 "choices": [{"index": 0, "delta": {"content": content[start:start + STREAM_CHUNK_CHARS]},
+                                              "finish_reason": None}]}
+                        self.wfile.write(f"data: {json.dumps(chunk)}\n\n".encode('utf-8'))
+                        self.wfile.flush()
+                        if server.chunk_delay:
+                            time.sleep(server.chunk_delay)
+                    self.wfile.write(b"data: [DONE]\n\n")
+                    self.wfile.flush()
+                except (BrokenPipeError, ConnectionResetError):
+                    with server.lock:
+                        server.streams_closed_early += 1
+
+            def _send(self, status: int, body: Dict[str, Any]):
+                data = json.dumps(body).encode('utf-8')
+                self.send_response(status)
+                self.send_header('Content-Type', 'application/json')
+                self.send_header('Content-Length', str(len(data)))
+                self.end_headers()
+                self.wfile.write(data)
+
+        return Handler
+
+    def _draw(self) -> tuple:
+        """Draw this request's latency and failure outcome."""
+        with self.lock:
+            self.request_count += 1
+            delay = self.latency + self.random.uniform(-self.latency_jitter, self.latency_jitter)
+            failed = self.random.random() < self.error_rate
+            if failed:
+                self.error_count += 1
+        return max(0.0, delay), failed
+
+    def answer_for(self, prompt: str, payload: Dict[str, Any]) -> str:
+        """Return the recorded, forwarded or canned answer for a prompt."""
+        key = prompt_key(prompt)
+        with self.lock:
+            recorded = self.responses.get(key)
+        if recorded is not None:
+            return recorded
+
+        if self.record_from:
+            upstream = requests.post(self.record_from, json=dict(payload, stream=False), timeout=300)
+            upstream.raise_for_status()
+            content = upstream.json()["choices"][0]["message"]["content"]
+            with self.lock:
+                self.responses[key] = content
+            return content
+
+        return canned_answer(prompt)
+
+    def handle_completion(self, payload: Dict[str, Any]) -> tuple:
+        """
+        Answer one chat completion request.
+
+        Args:
+            payload: Decoded request body
+
+        Returns:
+            Tuple (HTTP status, response body)
+        """
+        delay, failed = self._draw()
+        time.sleep(delay)
+        if failed:
+            return 500, {"error": {"message": "injected failure"}}
+
+        messages = payload.get("messages") or [{}]
+        prompt = messages[-1].get("content", "")
+        content = self.answer_for(prompt, payload)
+        if self.trailing_chars:
+            commentary = _COMMENTARY * (self.trailing_chars // len(_COMMENTARY) + 1)
+            content += "\n\n" + commentary[:self.trailing_chars]
+        return 200, {
+            "object": "chat.completion",
+            "model": payload.get("model", "mock"),
+            "choices": [{"index": 0, "message": {"role": "assistant", "content": content},
+                         "finish_reason": "stop"}]
+        }
+
+    def start(self) -> 'MockLLMServer':
+        """Serve requests on a background thread."""
+        self.thread = threading.Thread(target=self.httpd.serve_forever, daemon=True)
+        self.thread.start()
+        return self
+
+    def stop(self) -> None:
+        """Stop serving and release the port."""
+        self.httpd.shutdown()
+        self.httpd.server_close()
+        if self.thread is not None:
+            self.thread.join()
+
+    def save_recording(self, path: str) -> None:
+        """Write the recorded responses to a JSON file."""
+        with self.lock:
+            data = dict(self.responses)
+        with open(path, 'w', encoding='utf-8') as f:
+            json.dump(data, f, indent=2, ensure_ascii=False)
+
+    def __enter__(self) -> 'MockLLMServer':
+        return self.start()
+
+    def __exit__(self, exc_type, exc_value, traceback) -> None:
+        self.stop()
+
+
+def main():
+    """Run the mock server from the command line."""
+    import argparse
+
+    parser = argparse.ArgumentParser(
+        description="Mock OpenAI-compatible LLM endpoint for the auxiliary layer"
+    )
+    parser.add_argument("--host", default="127.0.0.1", help="Interface to bind (default: 127.0.0.1)")
+    parser.add_argument("--port", type=int, default=6006, help="Port to bind (default: 6006)")
+    parser.add_argument("--latency", type=float, default=0.0, help="Mean response latency in seconds")
+    parser.add_argument("--latency-jitter", type=float, default=0.0, help="Maximum latency jitter in seconds")
+    parser.add_argument("--error-rate", type=float, default=0.0, help="Fraction of requests failing with HTTP 500")
+    parser.add_argument("--trailing-chars", type=int, default=0, help="Commentary characters after each answer")
+    parser.add_argument("--chunk-delay", type=float, default=0.0, help="Seconds between streamed chunks")
+    parser.add_argument("--replay", help="JSON file of recorded responses to serve")
+    parser.add_argument("--record-from", help="Forward unknown prompts to this endpoint and record the answers")
+    parser.add_argument("--record", help="Write recorded responses to this file on exit")
+    parser.add_argument("--seed", type=int, default=None, help="Seed for latency and error randomness")
+    args = parser.parse_args()
+
+    responses = None
+    if args.replay:
+        with open(args.replay, 'r', encoding='utf-8') as f:
+            responses = json.load(f)
+
+    server = MockLLMServer(host=args.host, port=args.port, latency=args.latency,
+                           latency_jitter=args.latency_jitter, error_rate=args.error_rate,
+                           responses=responses, record_from=args.record_from,
+                           trailing_chars=args.trailing_chars, chunk_delay=args.chunk_delay, seed=args.seed)
+    print(f"Mock LLM server listening on {server.url}")
+    try:
+        server.httpd.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        server.httpd.server_close()
+        if args.record:
+            server.save_recording(args.record)
+            print(f"Recorded {len(server.responses)} responses to {args.record}")
+
+
+if __name__ == "__main__":
+    main()
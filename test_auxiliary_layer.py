@@ -0,0 +1,357 @@
+#!/usr/bin/env python3
+"""
+Test script for the auxiliary layer against the local mock LLM server
+"""
+
+import logging
+import os
+import tempfile
+import time
+
+from lisa_ir.core.auxiliary_layer import (AuxiliaryLayer, CircuitBreaker, JSONStreamScanner, LatencyTracker,
+                                          LLMResponseCache, RateLimiter, MIN_ADAPTIVE_TIMEOUT, MIN_LATENCY_SAMPLES,
+                                          OUTPUT_TOKENS_PER_FUNCTION, classify_by_heuristics, classify_by_signature,
+                                          get_rate_limiter, scan_comments)
+from lisa_ir.core.lifter import Lifter
+from mock_llm_server import MockLLMServer
+
+
+SOURCE = """#include <Python.h>
+/* Merges the widget state with the supplied value and gives back the outcome. */
+static PyObject *merge_state(PyObject *self, PyObject *value)
+{
+    return 0;
+}
+"""
+
+
+def test_rate_limiter():
+    """The token bucket lets a burst through at once, then holds requests to the configured rate."""
+    limiter = RateLimiter(rate=50, burst=5)
+    started = time.monotonic()
+    for _ in range(5):
+        limiter.acquire()
+    assert time.monotonic() - started < 0.05
+    for _ in range(10):
+        limiter.acquire()
+    elapsed = time.monotonic() - started
+    assert 0.18 <= elapsed < 0.6
+
+    assert get_rate_limiter("http://endpoint", None) is None
+    shared = get_rate_limiter("http://endpoint", 4)
+    assert shared is get_rate_limiter("http://endpoint", 4) and shared.capacity == 4
+    assert get_rate_limiter("http://endpoint", 8) is not shared
+
+
+def test_latency_percentile():
+    """Percentiles use the nearest rank over the most recent window only."""
+    tracker = LatencyTracker(window=10)
+    assert tracker.percentile(95) is None
+    for seconds in range(1, 21):
+        tracker.record(float(seconds))
+    assert tracker.percentile(50) == 15.0
+    assert tracker.percentile(95) == 20.0
+    assert tracker.percentile(0) == 11.0
+
+
+def test_batch_planning():
+    """Batches split at the function limit and at the token budget, keeping source order."""
+    items = [(f"f{i}", f"PyObject *f{i}(PyObject *arg)", f"Comment number {i}.") for i in range(7)]
+    template = "x" * 400
+    by_size = AuxiliaryLayer(use_cache=False, batch_size=3)
+    assert by_size._plan_batches(items, template) == [[0, 1, 2], [3, 4, 5], [6]]
+
+    layer = AuxiliaryLayer(use_cache=False, batch_size=10)
+    cost = layer._estimate_tokens(layer._format_function_input(*items[0][1:])) + OUTPUT_TOKENS_PER_FUNCTION
+    layer.batch_token_budget = layer._estimate_tokens(template) + 2 * cost
+    assert layer._plan_batches(items, template) == [[0, 1], [2, 3], [4, 5], [6]]
+
+    # A function larger than the budget still gets a batch of its own
+    layer.batch_token_budget = 1
+    assert layer._plan_batches(items[:2], template) == [[0], [1]]
+
+
+def test_classify_by_signature():
+    """Only scalar functions without object parameters are resolved from the signature."""
+    assert classify_by_signature("int count(const char *s, size_t n)") == {"return_ref_type": "none",
+                                                                          "arg_ref_steal": {}}
+    assert classify_by_signature("int add(PyObject *list, PyObject *item)") is None
+    assert classify_by_signature("PyObject *make(void)") is None
+    assert classify_by_signature("PyMODINIT_FUNC PyInit_mod(void)") is None
+
+
+def test_classify_by_heuristics():
+    """Unambiguous comments are resolved; contradictions and silence about stealing are left to the LLM."""
+    assert classify_by_heuristics("PyObject *make(PyObject *arg)", "Returns a new reference, NULL on failure.") == {
+        "return_ref_type": "new_ref", "arg_ref_steal": {}, "error_return": "NULL"}
+    assert classify_by_heuristics("PyObject *peek(PyObject *list)", "Returns a borrowed reference.") == {
+        "return_ref_type": "borrowed_ref", "arg_ref_steal": {}, "error_return": "NULL"}
+    assert classify_by_heuristics("PyObject *odd(void)", "Returns a new reference or a borrowed reference.") is None
+    assert classify_by_heuristics("PyObject *vague(void)", "Builds the widget for the caller.") is None
+
+    # Stolen arguments are matched by name, or must be the only object parameter
+    assert classify_by_heuristics("int set(PyObject *list, Py_ssize_t i, PyObject *item)",
+                                  "Stores item, stealing the reference to item. Returns -1 on failure.") == {
+        "return_ref_type": "none", "arg_ref_steal": {"2": True}, "error_return": "-1"}
+    assert classify_by_heuristics("int give(PyObject *obj)", "Steals a reference.")["arg_ref_steal"] == {"0": True}
+    assert classify_by_heuristics("int put(PyObject *a, PyObject *b)", "Steals a reference.") is None
+
+    # A scalar result says nothing about the object parameters unless stealing is mentioned
+    assert classify_by_heuristics("int add(PyObject *list, PyObject *item)", "Appends item, -1 on error.") is None
+    assert classify_by_heuristics("int add(PyObject *list, PyObject *item)",
+                                  "Appends item without stealing it.")["arg_ref_steal"] == {}
+    assert classify_by_heuristics("int size(const char *s)", "Counts the characters of s.") == {
+        "return_ref_type": "none", "arg_ref_steal": {}}
+
+
+def test_stream_scanner():
+    """The scanner must ignore braces in strings and invalid candidates."""
+    scanner = JSONStreamScanner()
+    pieces = ['thinking {not json} then ', '{"f": {"doc": "a } \\" {', '"}, "g"', ': 1} trailing {']
+    results = [scanner.feed(piece) for piece in pieces]
+    assert results == [False, False, False, True]
+    assert scanner.result == '{"f": {"doc": "a } \\" {"}, "g": 1}'
+
+
+def test_stream_scanner_chunking():
+    """Objects split at every character are found, and only the first of several objects in a chunk."""
+    answer = '{"f": {"return_ref_type": "new_ref", "arg_ref_steal": {"0": true}}}'
+    scanner = JSONStreamScanner()
+    results = [scanner.feed(char) for char in "noise " + answer + " more"]
+    assert results.index(True) == len("noise " + answer) - 1
+    assert scanner.result == answer
+
+    scanner = JSONStreamScanner()
+    assert scanner.feed('{"a": 1}{"b": 2}')
+    assert scanner.result == '{"a": 1}'
+    assert scanner.feed('{"c": 3}') and scanner.result == '{"a": 1}'
+
+    scanner = JSONStreamScanner()
+    assert not scanner.feed('{"a": "}')
+    assert scanner.feed('"}') and scanner.result == '{"a": "}"}'
+
+
+def test_scan_comments():
+    """Comments are found in one pass; literals are skipped and // runs merged."""
+    code = (
+        'const char *s = "/* not a comment */";\n'
+        "char c = '\\'';\n"
+        "/* block\n   comment */\n"
+        "// first line\n"
+        "// second line\n"
+        "\n"
+        "int x; // trailing\n"
+    )
+    assert scan_comments(code) == [
+        (3, 4, "block\n   comment"),
+        (5, 6, "first line\nsecond line"),
+        (8, 8, "trailing"),
+    ]
+
+
+def test_streaming_closes_early():
+    """A streamed answer is parsed as soon as its JSON closes, before the commentary is sent."""
+    logging.disable(logging.WARNING)
+    try:
+        with MockLLMServer(trailing_chars=20000, chunk_delay=0.001) as server:
+            streamed = AuxiliaryLayer(llm_endpoint=server.url, use_cache=False, stream=True)
+            hints = streamed.extract_semantic_hints(SOURCE)
+            assert hints["merge_state"]["return_ref_type"] == "new_ref"
+
+            # The server notices the closed connection on its next write
+            deadline = time.monotonic() + 5
+            while not server.streams_closed_early and time.monotonic() < deadline:
+                time.sleep(0.01)
+            assert server.streams_closed_early == 1
+
+            buffered = AuxiliaryLayer(llm_endpoint=server.url, use_cache=False, stream=False)
+            assert buffered.extract_semantic_hints(SOURCE) == hints
+    finally:
+        logging.disable(logging.NOTSET)
+
+
+def test_stream_deadline():
+    """A stream trickling in below the read timeout still fails once the whole answer is overdue."""
+    logging.disable(logging.WARNING)
+    try:
+        with MockLLMServer(chunk_delay=0.25) as server:
+            auxiliary = AuxiliaryLayer(llm_endpoint=server.url, use_cache=False, stream=True, timeout=0.5,
+                                       max_retries=1, breaker_threshold=1)
+            started = time.monotonic()
+            assert auxiliary.extract_semantic_hints(SOURCE) == {}
+            assert time.monotonic() - started < 1.0
+            assert auxiliary.breaker.state == CircuitBreaker.OPEN
+            assert auxiliary.latency.percentile(50) >= 0.5
+    finally:
+        logging.disable(logging.NOTSET)
+
+
+def test_adaptive_timeout():
+    """Timeouts follow the latency percentile once enough samples exist, within bounds."""
+    tracker = LatencyTracker()
+    assert tracker.timeout(60) == 60
+    for _ in range(MIN_LATENCY_SAMPLES):
+        tracker.record(0.01)
+    assert tracker.timeout(60) == MIN_ADAPTIVE_TIMEOUT
+    for _ in range(MIN_LATENCY_SAMPLES):
+        tracker.record(2.0)
+    assert tracker.timeout(60) == 6.0
+    assert tracker.timeout(4) == 4
+
+
+def test_circuit_breaker_transitions():
+    """closed -> open after the threshold, half-open with one probe after the reset time, then closed or open."""
+    breaker = CircuitBreaker(failure_threshold=2, reset_timeout=0.05)
+    assert breaker.allow() and not breaker.record_failure()
+    breaker.record_success()
+    assert not breaker.record_failure()  # successes reset the failure count
+    assert breaker.record_failure()
+    assert breaker.state == CircuitBreaker.OPEN and breaker.is_open() and not breaker.allow()
+
+    time.sleep(0.06)
+    assert not breaker.is_open()
+    assert breaker.allow() and breaker.state == CircuitBreaker.HALF_OPEN
+    assert not breaker.allow()  # only one probe at a time
+    assert breaker.record_failure()  # a failed probe reopens at once
+    assert breaker.state == CircuitBreaker.OPEN and not breaker.allow()
+
+    time.sleep(0.06)
+    assert breaker.allow()
+    breaker.record_success()
+    assert breaker.state == CircuitBreaker.CLOSED and breaker.failures == 0
+    assert breaker.allow() and breaker.allow()
+
+
+def test_circuit_breaker_skips_functions():
+    """A failing endpoint stops receiving requests and the skipped functions are reported."""
+    functions = 12
+    source = "#include <Python.h>\n" + "\n".join(
+        f"/* Merges the widget state with the supplied value, variant {i}. */\n"
+        f"static PyObject *merge_{i}(PyObject *self, PyObject *value) {{ return 0; }}"
+        for i in range(functions))
+
+    logging.disable(logging.WARNING)
+    try:
+        with MockLLMServer(error_rate=1.0) as server:
+            auxiliary = AuxiliaryLayer(llm_endpoint=server.url, use_cache=False, max_workers=1,
+                                       max_retries=1, breaker_threshold=3)
+            assert auxiliary.extract_semantic_hints(source) == {}
+            assert server.request_count == 3
+            assert auxiliary.report["circuit_skipped"] == functions - 3
+    finally:
+        logging.disable(logging.NOTSET)
+
+
+def test_response_cache():
+    """Answers survive a save; expired entries miss and the least recently used are evicted."""
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        path = os.path.join(tmp_dir, "llm_cache.json")
+        cache = LLMResponseCache(path, max_entries=2)
+        keys = [LLMResponseCache.make_key("model", f"int f{i}(void)", "") for i in range(3)]
+        cache.put(keys[0], {"return_ref_type": "new_ref"})
+        cache.put(keys[1], {})
+        cache.save()
+
+        cache = LLMResponseCache(path, max_entries=2)
+        assert cache.get(keys[0]) == {"return_ref_type": "new_ref"} and cache.get(keys[1]) == {}
+        assert not cache.dirty
+        stale = LLMResponseCache(path, refresh_interval=0)
+        assert stale.get(keys[0]) and stale.dirty  # hits on stale recency are saved
+        time.sleep(0.01)
+        cache.get(keys[0])  # keys[1] is now the least recently used
+        cache.put(keys[2], {})
+        cache.save()
+        assert set(LLMResponseCache(path).entries) == {keys[0], keys[2]}
+
+        expiring = LLMResponseCache(path, ttl=0)
+        time.sleep(0.01)
+        assert expiring.get(keys[0]) is None and expiring.misses == 1
+
+
+def test_response_cache_warm_run():
+    """A run answered entirely from the cache does not rewrite the cache file."""
+    logging.disable(logging.WARNING)
+    try:
+        with tempfile.TemporaryDirectory() as tmp_dir, MockLLMServer() as server:
+            path = os.path.join(tmp_dir, "llm_cache.json")
+            cold = AuxiliaryLayer(llm_endpoint=server.url, cache=LLMResponseCache(path))
+            hints = cold.extract_semantic_hints(SOURCE)
+            assert hints and server.request_count == 1
+            with open(path, 'rb') as f:
+                contents = f.read()
+            modified = os.stat(path).st_mtime_ns
+
+            warm_cache = LLMResponseCache(path)
+            warm = AuxiliaryLayer(llm_endpoint=server.url, cache=warm_cache)
+            assert warm.extract_semantic_hints(SOURCE) == hints
+            assert server.request_count == 1 and warm_cache.hits == 1 and warm_cache.misses == 0
+            with open(path, 'rb') as f:
+                assert f.read() == contents
+            assert os.stat(path).st_mtime_ns == modified
+    finally:
+        logging.disable(logging.NOTSET)
+
+
+def test_unparsed_answer_not_cached():
+    """An answer that does not parse is not cached, so the next run asks again."""
+    logging.disable(logging.WARNING)
+    try:
+        with tempfile.TemporaryDirectory() as tmp_dir, MockLLMServer() as server:
+            path = os.path.join(tmp_dir, "llm_cache.json")
+            answer_for = server.answer_for
+            server.answer_for = lambda prompt, payload: '{"merge_state": {"return_ref_type": "maybe"}}'
+            broken = AuxiliaryLayer(llm_endpoint=server.url, cache=LLMResponseCache(path), batch_size=1)
+            assert broken.extract_semantic_hints(SOURCE) == {}
+            assert LLMResponseCache(path).entries == {}
+            asked = server.request_count
+
+            server.answer_for = answer_for
+            retry = AuxiliaryLayer(llm_endpoint=server.url, cache=LLMResponseCache(path), batch_size=1)
+            assert retry.extract_semantic_hints(SOURCE)["merge_state"]["return_ref_type"] == "new_ref"
+            assert server.request_count == asked + 1
+    finally:
+        logging.disable(logging.NOTSET)
+
+
+def test_lifter_ai_hints_stage():
+    """The --ai-hints stage commits hints to the database before converting their callers."""
+    source = SOURCE + """
+static PyObject *use_state(PyObject *self, PyObject *value)
+{
+    PyObject *merged = merge_state(self, value);
+    return merged;
+}
+"""
+    logging.disable(logging.WARNING)
+    try:
+        with tempfile.TemporaryDirectory() as tmp_dir, MockLLMServer() as server:
+            lifter = Lifter(semantic_db_path=os.path.join(tmp_dir, "semantic_db.json"), ai_hints=True,
+                            ai_options={"llm_endpoint": server.url, "use_cache": False})
+            module = lifter.lift_code(source)
+
+            assert list(module.functions) == ["merge_state", "use_state"]
+            assert lifter.semantic_db.get_function_info("merge_state")["return_ref_type"] == "new_ref"
+            assert lifter.get_stats()["ai_hints"]["committed"] == 1
+    finally:
+        logging.disable(logging.NOTSET)
+
+
+if __name__ == "__main__":
+    test_rate_limiter()
+    test_latency_percentile()
+    test_batch_planning()
+    test_classify_by_signature()
+    test_classify_by_heuristics()
+    test_stream_scanner()
+    test_stream_scanner_chunking()
+    test_scan_comments()
+    test_streaming_closes_early()
+    test_stream_deadline()
+    test_adaptive_timeout()
+    test_circuit_breaker_transitions()
+    test_circuit_breaker_skips_functions()
+    test_response_cache()
+    test_response_cache_warm_run()
+    test_unparsed_answer_not_cached()
+    test_lifter_ai_hints_stage()
+    print("All auxiliary layer tests passed")
@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+"""
+Test script for the call site index and targeted re-analysis
+"""
+
+import json
+import logging
+import os
+import tempfile
+
+from lisa_ir.core.lifter import Lifter
+from lisa_ir.database.call_index import CallSiteIndex, recheck_callers
+
+
+MAKER = """
+#include <Python.h>
+
+PyObject *Foo_Make(void);
+
+static PyObject *make(PyObject *self, PyObject *args)
+{
+    PyObject *x = Foo_Make();
+    if (x == NULL)
+        return NULL;
+    return PyLong_FromLong(0);
+}
+
+static PyObject *other(PyObject *self, PyObject *args)
+{
+    return PyLong_FromLong(1);
+}
+"""
+
+USER = """
+#include <Python.h>
+
+PyObject *Foo_Make(void);
+
+static PyObject *use(PyObject *self, PyObject *list)
+{
+    PyObject *x = Foo_Make();
+    if (x == NULL)
+        return NULL;
+    PyList_SetItem(list, 0, x);
+    return PyLong_FromLong(0);
+}
+"""
+
+HELPER = """
+#include <Python.h>
+
+PyObject *Foo_Get(PyObject *list);
+
+PyObject *helper(PyObject *list)
+{
+    return Foo_Get(list);
+}
+
+static PyObject *wrapper(PyObject *self, PyObject *list)
+{
+    PyObject *item = helper(list);
+    if (item == NULL)
+        return NULL;
+    return PyLong_FromLong(0);
+}
+"""
+
+HELPER_USER = """
+#include <Python.h>
+
+PyObject *helper(PyObject *list);
+
+static PyObject *outer(PyObject *self, PyObject *list)
+{
+    PyObject *item = helper(list);
+    if (item == NULL)
+        return NULL;
+    return PyLong_FromLong(0);
+}
+"""
+
+
+def write(tmp_dir, name, code):
+    path = os.path.join(tmp_dir, name)
+    with open(path, 'w') as f:
+        f.write(code)
+    return path
+
+
+def test_index_and_query():
+    """Lifting records every call site compactly; re-lifting a file replaces its sites."""
+    logging.disable(logging.WARNING)
+    try:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            index_path = os.path.join(tmp_dir, "calls.json")
+            maker, user = write(tmp_dir, "maker.c", MAKER), write(tmp_dir, "user.c", USER)
+            lifter = Lifter(semantic_db_path=os.path.join(tmp_dir, "semantic_db.json"), call_index_path=index_path)
+            lifter.lift_file(maker)
+            lifter.lift_file(user)
+
+            index = CallSiteIndex(index_path)
+            assert index.files == sorted([maker, user])
+            sites = index.callers("Foo_Make")
+            assert [(site.file, site.function, site.line) for site in sites] == [(maker, "make", 8), (user, "use", 8)]
+            assert sites[0].coord == f"{maker}:8:19"
+            assert [site.function for site in index.callers("PyList_SetItem")] == ["use"]
+            assert index.calling_functions(["Foo_Make", "PyLong_FromLong"]) == {maker: ["make", "other"],
+                                                                                 user: ["use"]}
+
+            with open(index_path) as f:
+                data = json.load(f)
+            assert set(data) == {"version", "files", "strings", "sites"}
+            assert all(isinstance(value, int) for flat in data["sites"].values() for value in flat)
+
+            # A second writer re-indexes one file without losing the other's sites
+            write(tmp_dir, "user.c", USER.replace("Foo_Make", "Bar_Make"))
+            Lifter(semantic_db_path=os.path.join(tmp_dir, "semantic_db.json"),
+                   call_index_path=index_path).lift_file(user)
+            index = CallSiteIndex(index_path)
+            assert [site.file for site in index.callers("Foo_Make")] == [maker]
+            assert [site.file for site in index.callers("Bar_Make")] == [user]
+            assert index.remove_file(user) and CallSiteIndex(index_path).files == [maker]
+    finally:
+        logging.disable(logging.NOTSET)
+
+
+def test_unreadable_index_is_kept():
+    """A save leaves an index file it could not read alone and keeps the re-indexed file pending."""
+    logging.disable(logging.ERROR)
+    try:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            index_path = os.path.join(tmp_dir, "calls.json")
+            maker, user = write(tmp_dir, "maker.c", MAKER), write(tmp_dir, "user.c", USER)
+            lifter = Lifter(semantic_db_path=os.path.join(tmp_dir, "semantic_db.json"), call_index_path=index_path)
+            lifter.lift_file(maker)
+            with open(index_path) as f:
+                truncated = f.read()[:-10]
+            with open(index_path, 'w') as f:
+                f.write(truncated)
+
+            lifter.lift_file(user)
+            with open(index_path) as f:
+                assert f.read() == truncated
+
+            os.remove(index_path)
+            lifter.call_index.save()
+            assert CallSiteIndex(index_path).files == [user]
+    finally:
+        logging.disable(logging.NOTSET)
+
+
+def test_recheck_callers():
+    """After an API's entry changes, only its callers are re-lifted and checked against it."""
+    logging.disable(logging.WARNING)
+    try:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            db_path = os.path.join(tmp_dir, "semantic_db.json")
+            index_path = os.path.join(tmp_dir, "calls.json")
+            maker, user = write(tmp_dir, "maker.c", MAKER), write(tmp_dir, "user.c", USER)
+            lifter = Lifter(semantic_db_path=db_path, call_index_path=index_path)
+            for path in (maker, user):
+                lifter.lift_file(path)
+
+            lifter.semantic_db.update_function("Foo_Make", {"return_ref_type": "new_ref", "error_return": "NULL"})
+            lifter = Lifter(semantic_db_path=db_path, call_index_path=index_path)
+            results = recheck_callers(lifter.call_index, ["Foo_Make"], lifter)
+            assert sorted(results) == [maker, user]
+            assert results[maker].skipped == ["other"]
+            assert [(issue.kind, issue.function, issue.variable) for issue in results[maker].issues] == \
+                [("leak", "make", "x")]
+            assert results[user].issues == []
+            assert recheck_callers(lifter.call_index, ["Unknown_Api"], lifter) == {}
+    finally:
+        logging.disable(logging.NOTSET)
+
+
+def test_recheck_caller_chains():
+    """Callers of callers are re-checked, in the same file and, through changed summaries, in others."""
+    logging.disable(logging.WARNING)
+    try:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            db_path = os.path.join(tmp_dir, "semantic_db.json")
+            index_path = os.path.join(tmp_dir, "calls.json")
+            helpers, users = write(tmp_dir, "helpers.c", HELPER), write(tmp_dir, "users.c", HELPER_USER)
+            lifter = Lifter(semantic_db_path=db_path, call_index_path=index_path)
+            for path in (helpers, users):
+                lifter.lift_file(path)
+
+            lifter.semantic_db.update_function("Foo_Get", {"return_ref_type": "new_ref", "error_return": "NULL"})
+            lifter = Lifter(semantic_db_path=db_path, call_index_path=index_path)
+            results = recheck_callers(lifter.call_index, ["Foo_Get"], lifter)
+            assert sorted(results) == [helpers, users]
+            assert "helper" in results[helpers].updated
+            assert lifter.semantic_db.get_function_info("helper")["return_ref_type"] == "new_ref"
+            issues = [(issue.kind, issue.function, issue.variable) for result in results.values()
+                      for issue in result.issues]
+            assert sorted(issues) == [("leak", "outer", "item"), ("leak", "wrapper", "item")]
+    finally:
+        logging.disable(logging.NOTSET)
+
+
+if __name__ == "__main__":
+    test_index_and_query()
+    test_unreadable_index_is_kept()
+    test_recheck_callers()
+    test_recheck_caller_chains()
+    print("All call index tests passed")
@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+"""
+Test script for PyArg_Parse*/Py_BuildValue format string decoding
+"""
+
+import os
+
+from lift_helpers import lift
+from lisa_ir.analysis.cfg import terminator_targets
+from lisa_ir.analysis.refcount import RefcountChecker, check_function
+from lisa_ir.ir.ir_nodes import BranchIf, Call, SemanticOp
+from lisa_ir.parsers.format_strings import decode_format, literal_format
+
+
+EXAMPLE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "examples", "leaky_module.c")
+
+SOURCE = """
+#include <Python.h>
+
+static PyObject *pack(PyObject *self, PyObject *args)
+{
+    PyObject *items = NULL;
+    int count;
+    const char *name;
+    Py_ssize_t length;
+
+    if (!PyArg_ParseTuple(args, "O|is#:pack", &items, &count, &name, &length))
+        return NULL;
+    PyObject *number = PyLong_FromLong(count);
+    if (number == NULL)
+        return NULL;
+    PyObject *result = Py_BuildValue("(NO)", number, items);
+    Py_DECREF(number);
+    return result;
+}
+
+static PyObject *pack_copy(PyObject *self, PyObject *args)
+{
+    PyObject *number = PyLong_FromLong(1);
+    if (number == NULL)
+        return NULL;
+    PyObject *result = Py_BuildValue("O", number);
+    Py_DECREF(number);
+    return result;
+}
+"""
+
+
+def semantic_ops(func, *kinds):
+    """Collect a function's semantic operations of the given kinds."""
+    return [op for block in func.blocks.values() for op in block.operations
+            if isinstance(op, SemanticOp) and op.op_type in kinds]
+
+
+def test_decode_format():
+    """Format units map to argument roles, and each distinct string is decoded once."""
+    spec = decode_format("parse", "O!|is#:func")
+    assert [(a.unit, a.role) for a in spec.args] == [
+        ("O!", "type"), ("O!", "object"), ("i", "value"), ("s#", "value"), ("s#", "length"),
+    ]
+    assert spec.function_name == "func"
+    assert [a.optional for a in spec.args] == [False, False, True, True, True]
+    assert [a.role for a in decode_format("parse", "O&es#").args] == [
+        "converter", "convert-target", "encoding", "value", "length",
+    ]
+    assert [a.role for a in decode_format("build", "{s:O,s:N}").args] == ["value", "object", "value", "steal"]
+    assert decode_format("parse", "q").error is not None
+
+    hits = decode_format.cache_info().hits
+    assert decode_format("parse", "O!|is#:func") is spec
+    assert decode_format.cache_info().hits == hits + 1
+
+    assert literal_format('"O!"') == "O!"
+    assert literal_format("fmt") is None
+
+
+def test_parse_semantics():
+    """Parsed object outputs are typed borrowed references; C outputs are plain assignments."""
+    func = lift(path=EXAMPLE).functions["complex_processing"]
+    [borrow] = [op for op in semantic_ops(func, "borrow-ref") if op.attributes["func"] == "PyArg_ParseTuple"]
+    assert borrow.attributes["dest"] == "input_dict"
+    assert borrow.attributes["source"] == "args"
+    assert borrow.attributes["type"] == "PyDict_Type"
+
+    func = lift(code=SOURCE).functions["pack"]
+    assigned = [(op.attributes["target"], op.attributes["c_type"]) for op in semantic_ops(func, "parse-assign")]
+    assert assigned == [("count", "int"), ("name", "const char *"), ("length", "Py_ssize_t")]
+
+
+def test_build_value_steals():
+    """Py_BuildValue steals N arguments but leaves O arguments to the caller."""
+    module = lift(code=SOURCE)
+    [steal] = semantic_ops(module.functions["pack"], "steal-ref")
+    assert steal.attributes == {"target": "number", "func": "Py_BuildValue", "arg_index": 1}
+
+    issues = check_function(module.functions["pack"])
+    assert [(i.kind, i.variable) for i in issues] == [("use-after-steal", "number")]
+    assert check_function(module.functions["pack_copy"]) == []
+
+
+def test_format_semantics_on_success():
+    """Parse outputs only apply where the call succeeded; Py_BuildValue steals its N arguments on both edges."""
+    code = """
+#include <Python.h>
+
+static PyObject *first(PyObject *self, PyObject *args)
+{
+    PyObject *item;
+    if (!PyArg_ParseTuple(args, "O", &item))
+        return NULL;
+    Py_INCREF(item);
+    return item;
+}
+
+static PyObject *wrap(PyObject *self, PyObject *args)
+{
+    PyObject *number = PyLong_FromLong(1);
+    if (number == NULL)
+        return NULL;
+    PyObject *result = Py_BuildValue("(N)", number);
+    if (result == NULL) {
+        Py_DECREF(number);
+        return NULL;
+    }
+    return result;
+}
+"""
+    module = lift(code=code)
+    func = module.functions["first"]
+    [ok_block] = [block for block in func.blocks.values()
+                  if any(isinstance(op, SemanticOp) and op.op_type == "borrow-ref" for op in block.operations)]
+    [branch] = [block for block in func.blocks.values() if ok_block.name in terminator_targets(block.terminator)]
+    assert isinstance(branch.terminator, BranchIf) and branch.terminator.false_target == ok_block.name
+    assert RefcountChecker(func, path_sensitive=True).check() == []
+
+    func = module.functions["wrap"]
+    [call_block] = [block for block in func.blocks.values()
+                    if any(isinstance(op, SemanticOp) and op.op_type == "steal-ref" for op in block.operations)]
+    assert any(isinstance(op, Call) and op.function_name == "Py_BuildValue" for op in call_block.operations)
+    issues = RefcountChecker(func, path_sensitive=True).check()
+    assert [(issue.kind, issue.variable) for issue in issues] == [("use-after-steal", "number")]
+
+
+if __name__ == "__main__":
+    test_decode_format()
+    test_parse_semantics()
+    test_build_value_steals()
+    test_format_semantics_on_success()
+    print("All format string tests passed")
@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""
+Test script for header ownership annotations
+"""
+
+import logging
+import os
+import tempfile
+
+from lisa_ir.core.lifter import Lifter
+from lisa_ir.parsers.header_annotations import extract_annotations, find_included_headers
+
+
+HEADER = """
+#ifndef FOO_H
+#define FOO_H
+#include <Python.h>
+/* LISA_NEW_REF PyObject *Commented_Out(void); */
+LISA_NEW_REF LISA_ERROR_RETURN(NULL) PyObject *Foo_New(const char *name);
+LISA_STEALS(2) LISA_ERROR_RETURN(-1)
+int Foo_SetItem(PyObject *foo, Py_ssize_t i, PyObject *item);
+LISA_BORROWED_REF LISA_NO_ERROR PyObject *Foo_Peek(PyObject *foo);
+const char *Foo_Name(PyObject *foo);
+#endif
+"""
+
+SOURCE = """
+#include "foo.h"
+
+static PyObject *make(PyObject *self, PyObject *args)
+{
+    return Foo_New("x");
+}
+"""
+
+
+def write(path, text):
+    with open(path, 'w') as f:
+        f.write(text)
+    return path
+
+
+def test_extract_annotations():
+    """Annotated prototypes become entries; comments and unannotated prototypes do not."""
+    entries = extract_annotations(HEADER)
+    assert entries == {
+        "Foo_New": {"return_ref_type": "new_ref", "arg_ref_steal": {}, "error_return": "NULL"},
+        "Foo_SetItem": {"return_ref_type": "none", "arg_ref_steal": {"2": True}, "error_return": "-1"},
+        "Foo_Peek": {"return_ref_type": "borrowed_ref", "arg_ref_steal": {}, "error_return": None},
+    }
+
+
+def test_included_headers():
+    """Quoted includes resolve next to the including file, transitively."""
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        os.mkdir(os.path.join(tmp_dir, "sub"))
+        outer = write(os.path.join(tmp_dir, "outer.h"), '#include "sub/inner.h"\n')
+        inner = write(os.path.join(tmp_dir, "sub", "inner.h"), '#include "leaf.h"\n#include <missing.h>\n')
+        leaf = write(os.path.join(tmp_dir, "sub", "leaf.h"), "")
+        assert find_included_headers('#include "outer.h"\n', [], tmp_dir) == [outer, inner, leaf]
+
+
+def test_builtin_scope():
+    """Builtins only come from the headers of the current lift and follow header edits."""
+    logging.disable(logging.WARNING)
+    try:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            header = write(os.path.join(tmp_dir, "foo.h"), HEADER)
+            with_header = write(os.path.join(tmp_dir, "a.c"), SOURCE)
+            without = write(os.path.join(tmp_dir, "b.c"), "int plain(void) { return 0; }\n")
+            lifter = Lifter(semantic_db_path=os.path.join(tmp_dir, "semantic_db.json"))
+            db = lifter.semantic_db
+
+            lifter.lift_file(with_header)
+            assert db.get_function_info("Foo_New")["return_ref_type"] == "new_ref"
+            lifter.lift_file(without)
+            assert db.get_function_info("Foo_New") is None
+
+            # A rescanned header replaces its entries; removed annotations are dropped
+            write(header, HEADER.replace("LISA_NEW_REF LISA_ERROR_RETURN(NULL) ", ""))
+            stat = os.stat(header)
+            os.utime(header, (stat.st_atime, stat.st_mtime + 10))
+            lifter.lift_file(with_header)
+            assert db.get_function_info("Foo_New") is None
+            assert db.get_function_info("Foo_SetItem")["arg_ref_steal"] == {"2": True}
+    finally:
+        logging.disable(logging.NOTSET)
+
+
+if __name__ == "__main__":
+    test_extract_annotations()
+    test_included_headers()
+    test_builtin_scope()
+    print("All header annotation tests passed")
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""
+Test script for liveness, dead temporary removal and liveness-narrowed refcount checking
+"""
+
+import os
+
+from lift_helpers import lift
+from lisa_ir.analysis.liveness import Liveness
+from lisa_ir.analysis.refcount import RefcountChecker
+from lisa_ir.ir.ir_nodes import Assign, Call
+from lisa_ir.transforms.dead_temporaries import remove_dead_temporaries
+
+
+EXAMPLE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "examples", "leaky_module.c")
+
+SOURCE = """
+#include <Python.h>
+
+static int log_value(long value)
+{
+    return 0;
+}
+
+static PyObject *total(PyObject *self, PyObject *seq)
+{
+    long sum = 0;
+    Py_ssize_t n = PySequence_Size(seq);
+    for (Py_ssize_t i = 0; i < n; i++) {
+        PyObject *item = PySequence_GetItem(seq, i);
+        if (item == NULL)
+            return NULL;
+        sum += PyLong_AsLong(item);
+        Py_DECREF(item);
+        log_value(sum);
+    }
+    PyObject *unused = PyLong_FromLong(sum);
+    return PyLong_FromLong(sum);
+}
+"""
+
+
+def issue_set(issues):
+    """Issues as comparable tuples."""
+    return {(i.kind, i.function, i.variable, i.coord) for i in issues}
+
+
+def test_live_ranges():
+    """Loop-carried variables are live around the loop, body temporaries only inside it."""
+    func = lift(code=SOURCE).functions["total"]
+    liveness = Liveness(func)
+    assert "NULL" not in liveness.index
+    ranges = liveness.live_ranges()
+    header = next(name for name in func.blocks if name.startswith("for_header"))
+    body = next(name for name in func.blocks if name.startswith("for_body"))
+    assert liveness.is_live_in("sum", header) and liveness.is_live_in("n", header)
+    assert not liveness.is_live_in("item", header)
+    assert header not in ranges["item"] and body not in ranges["item"]
+    assert ranges["unused"] == []
+
+    # Within a block: the result of the size call dies once it is copied to n
+    [(block_id, index)] = [(liveness.cfg.index[name], i) for name, block in func.blocks.items()
+                           for i, op in enumerate(block.operations)
+                           if isinstance(op, Assign) and op.target.name == "n"]
+    size_temp = func.blocks[liveness.cfg.names[block_id]].operations[index].value.name
+    assert liveness.live_in[block_id] & liveness.bits([size_temp])
+    assert not liveness.live_after(block_id)[index] & liveness.bits([size_temp])
+
+
+def test_remove_dead_temporaries():
+    """Ignored results of calls without semantics lose their temporary; tracked results stay."""
+    func = lift(code=SOURCE).functions["total"]
+    cleaned = remove_dead_temporaries(func)
+    [log_call] = [op for block in cleaned.blocks.values() for op in block.operations
+                  if isinstance(op, Call) and op.function_name == "log_value"]
+    assert log_call.dest_var is None
+    [original] = [op for block in func.blocks.values() for op in block.operations
+                  if isinstance(op, Call) and op.function_name == "log_value"]
+    assert original.dest_var not in cleaned.local_vars and original.dest_var in func.local_vars
+    assert issue_set(RefcountChecker(cleaned).check()) == issue_set(RefcountChecker(func).check())
+    assert remove_dead_temporaries(cleaned) is None
+
+
+def test_liveness_narrowing():
+    """Narrowing to live ranges keeps every issue and shrinks the path-sensitive state space."""
+    module = lift(path=EXAMPLE)
+    for func in module.functions.values():
+        for options in ({}, {"path_sensitive": True, "merge_states": False}):
+            narrowed = RefcountChecker(func, **options)
+            full = RefcountChecker(func, narrow_liveness=False, **options)
+            assert issue_set(narrowed.check()) == issue_set(full.check())
+            assert narrowed.states <= full.states
+
+    func = lift(code=SOURCE).functions["total"]
+    narrowed = RefcountChecker(func, path_sensitive=True, merge_states=False)
+    full = RefcountChecker(func, path_sensitive=True, merge_states=False, narrow_liveness=False)
+    assert issue_set(narrowed.check()) == issue_set(full.check())
+    assert ("leak", "total", "unused") in {issue[:3] for issue in issue_set(narrowed.issues.values())}
+    assert narrowed.states < full.states
+
+
+if __name__ == "__main__":
+    test_live_ranges()
+    test_remove_dead_temporaries()
+    test_liveness_narrowing()
+    print("All liveness tests passed")
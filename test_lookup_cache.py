@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""
+Test script for the Bloom filter and the converter's semantic lookup cache
+"""
+
+import logging
+import os
+import tempfile
+
+from lisa_ir.core.ast_converter import ASTConverter
+from lisa_ir.core.lookup_cache import SemanticLookupCache
+from lisa_ir.parsers.c_parser import CCodeParser
+from lisa_ir.database.semantic_db import SemanticDatabase
+from lisa_ir.utils.bloom import BloomFilter
+
+
+def make_db(tmp_dir, count):
+    db = SemanticDatabase(os.path.join(tmp_dir, "semantic_db.json"))
+    db.bulk_update([{"func_name": f"Api_{i}", "info": {"return_ref_type": "new_ref"}} for i in range(count)])
+    return db
+
+
+def test_bloom_filter():
+    """No false negatives, and false positives near the configured rate."""
+    names = [f"name_{i}" for i in range(5000)]
+    bloom = BloomFilter.from_items(names, error_rate=0.01)
+    assert all(name in bloom for name in names)
+    false_positives = sum(f"other_{i}" in bloom for i in range(5000))
+    assert false_positives < 150
+
+
+def test_lookup_cache():
+    """Hits are memoized, misses answered by the filter, and new names added without rebuilding."""
+    logging.disable(logging.WARNING)
+    try:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            db = make_db(tmp_dir, 500)
+            cache = SemanticLookupCache(db)
+            cache.reset()
+            assert all(cache.get_function_info(f"Api_{i}") is not None for i in range(500))
+            assert cache.get_function_info("Api_7")["return_ref_type"] == "new_ref"
+            assert cache.get_function_info("local_helper") is None
+            stats = cache.get_stats()
+            assert stats["lookups"] == 502 and stats["memo_hits"] == 1 and stats["db_hits"] == 500
+            assert stats["bloom_negatives"] + stats["db_misses"] == 1
+
+            # Later entries and header annotations reach the filter incrementally
+            db.update_function("Late_Api", {"return_ref_type": "borrowed_ref"})
+            db.register_builtin({"Header_Api": {"return_ref_type": "new_ref"}})
+            for _ in range(3):
+                cache.reset()
+            assert cache.rebuilds == 1
+            assert cache.get_function_info("Late_Api")["return_ref_type"] == "borrowed_ref"
+            assert cache.get_function_info("Header_Api") is not None
+
+            # Names another writer added show up after a save merges them
+            make_db(tmp_dir, 0).update_function("Other_Api", {"return_ref_type": "none"})
+            db.update_function("Mine", {"return_ref_type": "none"})
+            cache.reset()
+            assert cache.get_function_info("Other_Api") is not None and cache.rebuilds == 1
+
+            # Outgrowing the filter rebuilds it, still without false negatives
+            db.bulk_update([{"func_name": f"More_{i}", "info": {}} for i in range(1500)])
+            cache.reset()
+            assert cache.rebuilds == 2
+            assert all(f"More_{i}" in cache.bloom for i in range(1500))
+    finally:
+        logging.disable(logging.NOTSET)
+
+
+def test_deferred_lookup_stats():
+    """Converting deferred functions refreshes the memo but keeps the lookup counters of the whole lift."""
+    code = """
+#include <Python.h>
+
+PyObject *helper(void);
+
+static PyObject *first(void) { return PyLong_FromLong(1); }
+static PyObject *second(void) { PyLong_FromLong(2); return helper(); }
+"""
+    logging.disable(logging.WARNING)
+    try:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            db = make_db(tmp_dir, 0)
+            converter = ASTConverter(db)
+            converter.convert_ast(CCodeParser().parse(code), "<input>", defer={"helper"},
+                                  before_deferred=lambda: db.update_function("helper", {"return_ref_type": "new_ref"}))
+            assert converter.lookup_cache.get_stats()["lookups"] == 3
+            assert converter.lookup_cache.get_function_info("helper")["return_ref_type"] == "new_ref"
+    finally:
+        logging.disable(logging.NOTSET)
+
+
+if __name__ == "__main__":
+    test_bloom_filter()
+    test_lookup_cache()
+    test_deferred_lookup_stats()
+    print("All lookup cache tests passed")
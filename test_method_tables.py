@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""
+Test script for method table metadata, signature checks and entry-point reachability
+"""
+
+import os
+
+from lift_helpers import lift
+from lisa_ir.analysis.interprocedural import analyze_module, reachable_functions
+from lisa_ir.analysis.signatures import check_method_signatures
+
+
+EXAMPLE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "examples", "leaky_module.c")
+
+SOURCE = """
+#include <Python.h>
+
+static PyObject *unused_helper(void)
+{
+    return PyLong_FromLong(1);
+}
+
+static PyObject *helper(void)
+{
+    return PyLong_FromLong(2);
+}
+
+static PyObject *fast_sum(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    return helper();
+}
+
+static PyObject *takes_keywords(PyObject *self, PyObject *args)
+{
+    PyObject *leaked = PyLong_FromLong(3);
+    return unused_helper == NULL ? NULL : Py_None;
+}
+
+static PyMethodDef Methods[] = {
+    {"fast_sum", (PyCFunction)fast_sum, METH_FASTCALL, "Sum the arguments."},
+    {.ml_name = "kw", .ml_meth = (PyCFunction)takes_keywords, .ml_flags = METH_VARARGS | METH_KEYWORDS},
+    {NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef example = {PyModuleDef_HEAD_INIT, "example", "Example module.", 0, Methods};
+
+PyMODINIT_FUNC PyInit_example(void)
+{
+    return PyModule_Create(&example);
+}
+"""
+
+
+def test_metadata():
+    """Method tables, module definitions and entry points are lifted into module metadata."""
+    module = lift(code=SOURCE)
+    table = module.metadata["method_tables"]["Methods"]
+    assert [(e["python_name"], e["c_function"], e["flag_names"]) for e in table] == [
+        ("fast_sum", "fast_sum", ["METH_FASTCALL"]),
+        ("kw", "takes_keywords", ["METH_VARARGS", "METH_KEYWORDS"]),
+    ]
+    assert table[0]["doc"] == "Sum the arguments."
+    assert module.metadata["module_defs"]["example"] == {
+        "python_name": "example", "doc": "Example module.", "size": 0, "methods": "Methods"
+    }
+    assert module.metadata["entry_points"] == ["fast_sum", "takes_keywords", "PyInit_example"]
+    assert "unused_helper" in module.metadata["static_functions"]
+
+
+def test_signature_mismatches():
+    """Registered functions are checked against their calling convention."""
+    issues = check_method_signatures(lift(code=SOURCE))
+    assert [(i.function, i.python_name) for i in issues] == [("takes_keywords", "kw")]
+    assert "takes 2 parameter(s) but METH_VARARGS|METH_KEYWORDS passes 3" in issues[0].message
+
+    issues = {i.function for i in check_method_signatures(lift(path=EXAMPLE))}
+    assert {"create_int_list", "process_sequence", "list_append_no_steal"} <= issues
+
+
+def test_reachable_only():
+    """Static helpers no entry point reaches are skipped by the refcount analysis."""
+    module = lift(code=SOURCE)
+    assert reachable_functions(module) == ["helper", "fast_sum", "takes_keywords", "PyInit_example"]
+
+    result = analyze_module(module, max_workers=1, reachable_only=True)
+    assert result.skipped == ["unused_helper"]
+    assert "unused_helper" not in result.summaries
+    assert [(i.kind, i.function, i.variable) for i in result.issues] == [("leak", "takes_keywords", "leaked")]
+
+
+if __name__ == "__main__":
+    test_metadata()
+    test_signature_mismatches()
+    test_reachable_only()
+    print("All method table tests passed")
@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""
+Test script for the IR pass manager: analysis caching, invalidation and parallel runs
+"""
+
+import os
+
+from lift_helpers import lift
+from lisa_ir.ir.ir_nodes import Phi
+from lisa_ir.transforms.pass_manager import PassManager, register_analysis, register_transform
+
+
+EXAMPLE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "examples", "leaky_module.c")
+
+COMPUTED = []
+
+
+@register_analysis("test-block-count", requires=("cfg",))
+def block_count(func, analyses):
+    """Counts its own runs so caching can be observed."""
+    COMPUTED.append(func.name)
+    return len(analyses.get("cfg"))
+
+
+@register_transform("test-rename", preserves=("cfg", "test-block-count"))
+def rename_nothing(func, analyses):
+    """Reports a change but keeps the function (and its graph) as it is."""
+    return func
+
+
+def test_caching_and_invalidation():
+    """Analyses are computed once per function and dropped when a transform changes it."""
+    module = lift(EXAMPLE)
+    func = module.functions["create_int_list"]
+    manager = PassManager(["test-block-count"], max_workers=1)
+    manager.run(module)
+    cfg = manager.analysis(func, "cfg")
+    assert manager.analysis(func, "test-block-count") == len(func.blocks)
+    assert COMPUTED.count("create_int_list") == 1
+
+    # Rerunning the pipeline and preserving transforms keep the cache
+    manager.run(module)
+    manager.managers[func.name].run_transform("test-rename")
+    assert manager.analysis(func, "cfg") is cfg
+    assert COMPUTED.count("create_int_list") == 1
+
+    # SSA replaces the function: its cached graph and dependents are recomputed
+    ssa_manager = manager.managers[func.name]
+    ssa_manager.get("dominators")
+    assert ssa_manager.run_transform("ssa")
+    assert ssa_manager.results == {}
+    assert ssa_manager.get("cfg") is not cfg
+    assert ssa_manager.get("test-block-count") == len(ssa_manager.func.blocks)
+    assert COMPUTED.count("create_int_list") == 2
+
+
+def test_parallel_pipeline():
+    """Functions run in worker processes give the same result as in-process, with timing per pass."""
+    serial, parallel = lift(EXAMPLE), lift(EXAMPLE)
+    PassManager(["ssa", "dominators"], max_workers=1).run(serial)
+    manager = PassManager(["ssa", "dominators"], max_workers=2, min_parallel_functions=1)
+    manager.run(parallel)
+
+    assert list(serial.functions) == list(parallel.functions)
+    for name, func in parallel.functions.items():
+        assert func.to_dict() == serial.functions[name].to_dict()
+        assert manager.managers[name].results["dominators"][0] >= 0
+    assert any(isinstance(op, Phi) for func in parallel.functions.values()
+               for block in func.blocks.values() for op in block.operations)
+    assert manager.timings["ssa"][1] == len(parallel.functions)
+    assert manager.timing_report().splitlines()[0].split() == ["pass", "runs", "seconds"]
+
+
+def test_unknown_pass():
+    """Pipelines naming unregistered passes are rejected up front."""
+    try:
+        PassManager(["ssa", "no-such-pass"])
+    except ValueError as error:
+        assert "no-such-pass" in str(error)
+    else:
+        raise AssertionError("unknown pass accepted")
+
+
+if __name__ == "__main__":
+    test_caching_and_invalidation()
+    test_parallel_pipeline()
+    test_unknown_pass()
+    print("All pass manager tests passed")
@@ -0,0 +1,379 @@
+#!/usr/bin/env python3
+"""
+Test script for the reference count checker
+"""
+
+import logging
+import os
+import tempfile
+
+from lift_helpers import lift
+from lisa_ir.analysis.interprocedural import analyze_module, strongly_connected_components, INFERRED_SOURCE
+from lisa_ir.analysis.refcount import RefcountChecker, check_module
+from lisa_ir.ir.ir_nodes import Switch
+
+
+EXAMPLE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "examples", "leaky_module.c")
+
+
+def issue_set(issues):
+    """Reduce issues to (kind, function, variable, line) tuples."""
+    return {(i.kind, i.function, i.variable, int(i.coord.split(":")[1])) for i in issues}
+
+
+def test_leaky_module():
+    """The intentional bugs of the example module are reported, and nothing else."""
+    issues = issue_set(check_module(lift(path=EXAMPLE)))
+    assert issues == {
+        ("leak", "create_int_list", "list", 39),
+        ("leak", "create_int_list", "list", 46),
+        ("use-after-steal", "create_int_list", "item", 45),
+        ("over-decref", "dict_get_borrowed", "value", 78),
+        ("over-decref", "list_append_no_steal", "item", 98),
+        ("use-after-steal", "process_sequence", "processed_item", 188),
+        ("use-after-steal", "complex_processing", "processed_value", 261),
+    }
+
+
+def test_null_paths_and_overwrite():
+    """NULL checks prune impossible paths, and overwriting an owned reference leaks it."""
+    code = """
+#include <Python.h>
+
+static PyObject *checked(PyObject *self, PyObject *arg)
+{
+    PyObject *a = PyLong_FromLong(1);
+    if (a == NULL)
+        return NULL;
+    PyObject *b = PyLong_FromLong(2);
+    if (!b) {
+        Py_DECREF(a);
+        return NULL;
+    }
+    Py_DECREF(b);
+    return a;
+}
+
+static PyObject *overwritten(PyObject *self, PyObject *arg)
+{
+    PyObject *a = PyLong_FromLong(1);
+    a = PyLong_FromLong(2);
+    return a;
+}
+"""
+    issues = issue_set(check_module(lift(code=code)))
+    assert {(kind, func, var) for kind, func, var, _ in issues} == {("leak", "overwritten", "a")}
+
+
+def test_path_sensitive_mode():
+    """Per-path states drop a correlated false leak; a tiny budget falls back to the joined result."""
+    code = """
+#include <Python.h>
+
+static PyObject *str_or_repr(PyObject *self, PyObject *obj)
+{
+    PyObject *text = NULL;
+    PyObject *repr = NULL;
+    if (PyObject_IsTrue(obj)) {
+        text = PyObject_Str(obj);
+        if (text == NULL)
+            return NULL;
+    }
+    else {
+        repr = PyObject_Repr(obj);
+        if (repr == NULL)
+            return NULL;
+    }
+    if (text != NULL)
+        return text;
+    return repr;
+}
+"""
+    func = lift(code=code).functions["str_or_repr"]
+    assert issue_set(RefcountChecker(func).check()) == {("leak", "str_or_repr", "repr", 19)}
+
+    checker = RefcountChecker(func, path_sensitive=True)
+    assert checker.check() == []
+    assert not checker.budget_exhausted
+
+    checker = RefcountChecker(func, path_sensitive=True, state_budget=2)
+    assert issue_set(checker.check()) == {("leak", "str_or_repr", "repr", 19)}
+    assert checker.budget_exhausted
+
+
+def test_copied_references():
+    """A copy shares its reference: releasing, stealing or NULL-testing one name applies to both."""
+    code = """
+#include <Python.h>
+
+static PyObject *copy_then_release(PyObject *self, PyObject *arg)
+{
+    PyObject *a = PyLong_FromLong(1);
+    PyObject *b = a;
+    if (!b)
+        return NULL;
+    Py_DECREF(b);
+    Py_RETURN_NONE;
+}
+
+static PyObject *str_or_null(PyObject *self, PyObject *obj)
+{
+    PyObject *result = NULL;
+    PyObject *text = PyObject_Str(obj);
+    if (text)
+        result = text;
+    if (result == NULL)
+        return NULL;
+    return result;
+}
+
+static PyObject *copy_then_steal(PyObject *self, PyObject *list)
+{
+    PyObject *a = PyLong_FromLong(1);
+    if (a == NULL)
+        return NULL;
+    PyObject *b = a;
+    PyList_SetItem(list, 0, b);
+    Py_DECREF(a);
+    Py_RETURN_NONE;
+}
+
+static PyObject *copy_then_incref(PyObject *self, PyObject *arg)
+{
+    PyObject *a = PyLong_FromLong(1);
+    if (a == NULL)
+        return NULL;
+    PyObject *b = a;
+    Py_INCREF(b);
+    Py_DECREF(b);
+    return PyLong_FromLong(0);
+}
+"""
+    module = lift(code=code)
+    expected = {
+        ("use-after-steal", "copy_then_steal", "a", 32),
+        ("leak", "copy_then_incref", "a", 44),
+    }
+    assert issue_set(check_module(module)) == expected
+    assert issue_set(check_module(module, path_sensitive=True)) == expected
+
+
+def test_goto_and_switch():
+    """Labels, goto and switch are lowered to blocks, so cleanup paths and cases are checked too."""
+    code = """
+#include <Python.h>
+
+static PyObject *collect(PyObject *self, PyObject *args)
+{
+    int kind = 0;
+    PyObject *item = PyLong_FromLong(1);
+    if (item == NULL)
+        return NULL;
+    PyObject *list = PyList_New(0);
+    if (list == NULL)
+        goto error;
+    switch (kind) {
+    case 0:
+        if (PyList_Append(list, item) < 0)
+            goto error;
+        break;
+    default:
+        Py_DECREF(list);
+        return NULL;
+    }
+    Py_DECREF(item);
+    return list;
+error:
+    Py_XDECREF(list);
+    return NULL;
+}
+"""
+    module = lift(code=code)
+    func = module.functions["collect"]
+    [switch] = [block.terminator for block in func.blocks.values() if isinstance(block.terminator, Switch)]
+    assert list(switch.cases) == [0] and switch.default_target.startswith("switch_default")
+    assert any(name.startswith("label_error") for name in func.blocks)
+    assert issue_set(check_module(module)) == {("leak", "collect", "item", 20), ("leak", "collect", "item", 26)}
+
+
+def test_loop_widening():
+    """Loop headers settle in a bounded number of visits without losing loop leaks."""
+    code = """
+#include <Python.h>
+
+static PyObject *shift(PyObject *self, PyObject *list)
+{
+    PyObject *last = NULL, *prev = NULL, *older = NULL, *oldest = NULL;
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            oldest = older;
+            older = prev;
+            prev = last;
+            last = PyList_GetItem(list, j);
+        }
+        PyObject *count = PyLong_FromLong(i);
+    }
+    return NULL;
+}
+"""
+    func = lift(code=code).functions["shift"]
+    for path_sensitive in (False, True):
+        # Liveness alone already forgets the dead shift chain; compare widening without it
+        plain = RefcountChecker(func, path_sensitive=path_sensitive, widen_delay=None, narrow_liveness=False)
+        widened = RefcountChecker(func, path_sensitive=path_sensitive, narrow_liveness=False)
+        expected = {("leak", "shift", "count", 14), ("leak", "shift", "count", 16)}
+        assert issue_set(widened.check()) == issue_set(plain.check()) == expected
+        assert max(widened.header_visits.values()) <= 5 < max(plain.header_visits.values())
+
+
+HELPERS = """
+#include <Python.h>
+
+static PyObject *pong(int n);
+
+static PyObject *ping(int n)
+{
+    if (n == 0)
+        return PyLong_FromLong(0);
+    return pong(n - 1);
+}
+
+static PyObject *pong(int n)
+{
+    return ping(n);
+}
+
+static int put_first(PyObject *tuple, PyObject *item)
+{
+    return PyTuple_SetItem(tuple, 0, item);
+}
+
+static PyObject *caller(PyObject *self, PyObject *arg)
+{
+    PyObject *pair = PyTuple_New(2);
+    if (!pair)
+        return NULL;
+    PyObject *item = ping(3);
+    if (!item)
+        return NULL;
+    if (put_first(pair, item) < 0) {
+        Py_DECREF(item);
+        Py_DECREF(pair);
+        return NULL;
+    }
+    return pair;
+}
+"""
+
+
+def test_strongly_connected_components():
+    """Components come out callees first, with cycles kept together."""
+    graph = {"main": ["a", "c"], "a": ["b"], "b": ["a", "c"], "c": []}
+    assert strongly_connected_components(graph) == [["c"], ["a", "b"], ["main"]]
+
+
+def test_interprocedural_summaries():
+    """Helper summaries are inferred bottom-up, stored, and used to check their callers."""
+    logging.disable(logging.WARNING)
+    try:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            module, semantic_db = lift(code=HELPERS, db_path=os.path.join(tmp_dir, "semantic_db.json"))
+            serial = analyze_module(module, semantic_db, max_workers=1)
+            parallel = analyze_module(module, max_workers=2, min_parallel_functions=0)
+
+            assert serial.components == 3
+            assert serial.summaries["ping"]["return_ref_type"] == "new_ref"
+            assert serial.summaries["pong"]["return_ref_type"] == "new_ref"
+            assert serial.summaries["put_first"] == {"arg_ref_steal": {"1": True}}
+            assert issue_set(serial.issues) == {
+                ("leak", "caller", "pair", 30),
+                ("use-after-steal", "caller", "item", 32),
+            }
+            assert issue_set(parallel.issues) == issue_set(serial.issues)
+            assert parallel.summaries == serial.summaries
+
+            assert serial.stored == 4
+            assert semantic_db.get_function_info("put_first")["source"] == INFERRED_SOURCE
+    finally:
+        logging.disable(logging.NOTSET)
+
+
+def test_edited_helper():
+    """Re-lifting after a helper changed checks its callers against the new summary, not the stored one."""
+    template = """
+#include <Python.h>
+
+static PyObject *first(PyObject *list)
+{
+    return %s;
+}
+
+static PyObject *use_first(PyObject *self, PyObject *list)
+{
+    PyObject *s = first(list);
+    if (s == NULL)
+        return NULL;
+    %s
+    Py_RETURN_NONE;
+}
+"""
+    new_ref = template % ("PyLong_FromLong(1)", "Py_DECREF(s);")
+    borrowed = template % ("PyList_GetItem(list, 0)", "")
+    logging.disable(logging.WARNING)
+    try:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            db_path = os.path.join(tmp_dir, "semantic_db.json")
+            for code, ref_type in ((new_ref, "new_ref"), (borrowed, "borrowed_ref"), (new_ref, "new_ref")):
+                module, semantic_db = lift(code=code, db_path=db_path)
+                result = analyze_module(module, semantic_db, max_workers=1)
+                assert result.issues == []
+                assert result.summaries["first"]["return_ref_type"] == ref_type
+                assert semantic_db.get_function_info("first")["return_ref_type"] == ref_type
+    finally:
+        logging.disable(logging.NOTSET)
+
+
+def test_changed_summary_replaces_entry():
+    """A re-inferred summary replaces the stored one whole, and a summary no longer inferred is removed."""
+    template = """
+#include <Python.h>
+
+%s give(PyObject *list, PyObject *item)
+{
+    %s
+}
+"""
+    steals = template % ("int", "if (PyList_SetItem(list, 0, item) < 0)\n        return -1;\n    return 0;")
+    borrows = template % ("int", "if (PyList_Append(list, item) < 0)\n        return -1;\n    return 0;")
+    void = template % ("void", "PyList_Append(list, item);")
+    logging.disable(logging.WARNING)
+    try:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            db_path = os.path.join(tmp_dir, "semantic_db.json")
+            expected = [{"error_return": "-1", "arg_ref_steal": {"1": True}}, {"error_return": "-1"}, None]
+            for code, summary in zip((steals, borrows, void), expected):
+                module, semantic_db = lift(code=code, db_path=db_path)
+                result = analyze_module(module, semantic_db, max_workers=1)
+                assert result.updated == ["give"]
+                stored = semantic_db.get_function_info("give")
+                if summary is None:
+                    assert stored is None
+                else:
+                    assert {k: v for k, v in stored.items() if k != "_version"} == dict(summary, source=INFERRED_SOURCE)
+            assert analyze_module(module, semantic_db, max_workers=1).updated == []
+    finally:
+        logging.disable(logging.NOTSET)
+
+
+if __name__ == "__main__":
+    test_leaky_module()
+    test_null_paths_and_overwrite()
+    test_path_sensitive_mode()
+    test_copied_references()
+    test_goto_and_switch()
+    test_loop_widening()
+    test_strongly_connected_components()
+    test_interprocedural_summaries()
+    test_edited_helper()
+    test_changed_summary_replaces_entry()
+    print("All refcount tests passed")
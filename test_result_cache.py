@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""
+Test script for the refcount result cache
+"""
+
+import logging
+import os
+import shutil
+import tempfile
+
+from lisa_ir.analysis.interprocedural import analyze_module, build_call_graph
+from lisa_ir.analysis.result_cache import RefcountResultCache
+from lisa_ir.core.lifter import Lifter
+from lisa_ir.ir.ir_nodes import Call
+
+
+EXAMPLE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "examples", "leaky_module.c")
+
+
+def affected_by(module, api):
+    """Functions calling an API, directly or through other module functions."""
+    graph = build_call_graph(module)
+    affected = {name for name, func in module.functions.items()
+                for block in func.blocks.values() for op in block.operations
+                if isinstance(op, Call) and op.function_name == api}
+    changed = True
+    while changed:
+        callers = {name for name, callees in graph.items() if affected.intersection(callees)}
+        changed = not callers <= affected
+        affected |= callers
+    return affected
+
+
+def issue_strings(result):
+    return [str(issue) for issue in result.issues]
+
+
+def test_result_cache():
+    """Unchanged components come from the cache and an all-hit run does not rewrite the file."""
+    logging.disable(logging.WARNING)
+    try:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            lifter = Lifter(semantic_db_path=os.path.join(tmp_dir, "semantic_db.json"))
+            module = lifter.lift_file(EXAMPLE)
+            db = lifter.semantic_db
+            cache_path = os.path.join(tmp_dir, ".lisa_cache", "refcount_cache.json")
+
+            first = analyze_module(module, db, cache=RefcountResultCache(cache_path))
+            assert first.cached == 0 and first.issues
+            modified = os.stat(cache_path).st_mtime_ns
+
+            # A new cache instance loaded from the file answers everything, serially or in parallel
+            for workers in (1, 2):
+                again = analyze_module(module, db, cache=RefcountResultCache(cache_path),
+                                       max_workers=workers, min_parallel_functions=1)
+                assert again.cached == again.components
+                assert issue_strings(again) == issue_strings(first)
+                assert again.summaries == first.summaries
+            assert os.stat(cache_path).st_mtime_ns == modified
+
+            # Hits on entries whose stored recency is stale are written back
+            stale = RefcountResultCache(cache_path, refresh_interval=0)
+            assert analyze_module(module, db, cache=stale).cached == first.components
+            assert os.stat(cache_path).st_mtime_ns != modified
+            entries = RefcountResultCache(cache_path).entries.values()
+            assert all(entry["accessed"] > entry["created"] for entry in entries)
+
+            # Options are part of the key
+            assert analyze_module(module, db, cache=RefcountResultCache(cache_path),
+                                  path_sensitive=True).cached == 0
+
+            # Rewriting an entry with the same semantics keeps the keys
+            api = "PyList_SetItem"
+            db.update_function(api, dict(db.get_function_info(api)))
+            assert analyze_module(module, db, cache=RefcountResultCache(cache_path)).cached == first.components
+    finally:
+        logging.disable(logging.NOTSET)
+
+
+def test_result_cache_invalidation():
+    """A changed API entry or function body misses for the affected components and gives the new result."""
+    logging.disable(logging.WARNING)
+    try:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            db_path = os.path.join(tmp_dir, "semantic_db.json")
+            cache_path = os.path.join(tmp_dir, ".lisa_cache", "refcount_cache.json")
+            source = shutil.copy(EXAMPLE, os.path.join(tmp_dir, "leaky_module.c"))
+            lifter = Lifter(semantic_db_path=db_path)
+            first = analyze_module(lifter.lift_file(source), lifter.semantic_db, cache=RefcountResultCache(cache_path))
+
+            # The converter reads the database, so a changed entry only shows after re-lifting
+            api = "PyList_SetItem"
+            lifter.semantic_db.update_function(api, dict(lifter.semantic_db.get_function_info(api),
+                                                         arg_ref_steal={}))
+            lifter = Lifter(semantic_db_path=db_path)
+            module = lifter.lift_file(source)
+            changed = analyze_module(module, lifter.semantic_db, cache=RefcountResultCache(cache_path))
+            affected = affected_by(module, api)
+            assert 0 < len(affected) and changed.cached == changed.components - len(affected)
+            assert issue_strings(changed) != issue_strings(first)
+            assert issue_strings(changed) == issue_strings(analyze_module(module, lifter.semantic_db))
+
+            # Editing one function's body (on the same lines) re-checks just that function
+            with open(source) as f:
+                code = f.read()
+            with open(source, 'w') as f:
+                f.write(code.replace("    Py_DECREF(value);  // This will cause issues!", "    ;"))
+            module = lifter.lift_file(source)
+            edited = analyze_module(module, lifter.semantic_db, cache=RefcountResultCache(cache_path))
+            assert edited.cached == edited.components - 1
+            removed = set(issue_strings(changed)) - set(issue_strings(edited))
+            assert len(removed) == 1 and "over-decref" in removed.pop()
+            assert issue_strings(edited) == issue_strings(analyze_module(module, lifter.semantic_db))
+    finally:
+        logging.disable(logging.NOTSET)
+
+
+if __name__ == "__main__":
+    test_result_cache()
+    test_result_cache_invalidation()
+    print("All result cache tests passed")
@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""
+Test script for concurrent semantic database updates
+"""
+
+import json
+import logging
+import multiprocessing
+import os
+import tempfile
+
+from lisa_ir.database.semantic_db import SemanticDatabase
+
+
+def _writer(db_path: str, writer_id: int, count: int) -> None:
+    """Write private entries and one shared entry from a separate process."""
+    db = SemanticDatabase(db_path)
+    for i in range(count):
+        db.update_function(f"writer{writer_id}_func{i}", {"return_ref_type": "new_ref"})
+        shared = db.get_function_info("shared_func") or {}
+        steals = dict(shared.get("arg_ref_steal", {}), **{str(writer_id): True})
+        db.update_function("shared_func", {"arg_ref_steal": steals})
+
+
+def test_parallel_writers():
+    """Parallel writers must neither lose entries nor corrupt the file."""
+    writers, count = 4, 10
+
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        db_path = os.path.join(tmp_dir, "semantic_db.json")
+
+        processes = [multiprocessing.Process(target=_writer, args=(db_path, w, count))
+                     for w in range(writers)]
+        for p in processes:
+            p.start()
+        for p in processes:
+            p.join()
+            assert p.exitcode == 0
+
+        with open(db_path, 'r', encoding='utf-8') as f:
+            db = json.load(f)
+
+        for w in range(writers):
+            for i in range(count):
+                assert f"writer{w}_func{i}" in db
+
+        for w in range(writers):
+            for i in range(count):
+                assert db[f"writer{w}_func{i}"]["return_ref_type"] == "new_ref"
+
+        # Every shared update must land as its own version, merged with the others
+        shared = db["shared_func"]
+        assert shared["_version"] == writers * count
+        assert shared["arg_ref_steal"] == {str(w): True for w in range(writers)}
+
+
+def test_conflict_policies():
+    """A stale writer resolves conflicts according to its policy."""
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        db_path = os.path.join(tmp_dir, "semantic_db.json")
+        SemanticDatabase(db_path).update_function("f", {"return_ref_type": "new_ref", "error_return": "NULL"})
+
+        stale_theirs = SemanticDatabase(db_path, conflict_policy='theirs')
+        stale_merge = SemanticDatabase(db_path)
+        SemanticDatabase(db_path).update_function("f", {"return_ref_type": "borrowed_ref"})
+
+        stale_theirs.update_function("f", {"return_ref_type": "none"})
+        assert stale_theirs.get_function_info("f")["return_ref_type"] == "borrowed_ref"
+
+        stale_merge.update_function("f", dict(stale_merge.get_function_info("f"), error_return="-1"))
+        merged = stale_merge.get_function_info("f")
+        assert merged["return_ref_type"] == "borrowed_ref"
+        assert merged["error_return"] == "-1"
+        assert merged["_version"] == 3
+
+
+def test_update_replaces_entry():
+    """Without a concurrent writer an update replaces the entry, dropping fields and steal flags."""
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        db_path = os.path.join(tmp_dir, "semantic_db.json")
+        db = SemanticDatabase(db_path)
+        db.update_function("f", {"return_ref_type": "none", "arg_ref_steal": {"0": True, "1": True},
+                                 "error_return": "-1"})
+        db.update_function("f", {"return_ref_type": "none", "arg_ref_steal": {"1": True}})
+        assert SemanticDatabase(db_path).get_function_info("f") == {
+            "return_ref_type": "none", "arg_ref_steal": {"1": True}, "_version": 2}
+
+        # On a conflict only the flags we changed are applied to the other writer's entry
+        stale = SemanticDatabase(db_path)
+        concurrent = {"return_ref_type": "none", "arg_ref_steal": {"1": True, "2": True}}
+        SemanticDatabase(db_path).update_function("f", concurrent)
+        stale.update_function("f", {"return_ref_type": "none", "arg_ref_steal": {}})
+        assert SemanticDatabase(db_path).get_function_info("f")["arg_ref_steal"] == {"2": True}
+
+
+def test_unreadable_file_is_kept():
+    """A save never replaces a file it could not read; only a missing file counts as empty."""
+    logging.disable(logging.ERROR)
+    try:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            db_path = os.path.join(tmp_dir, "semantic_db.json")
+            db = SemanticDatabase(db_path)
+            with open(db_path, 'w', encoding='utf-8') as f:
+                f.write('{"f": {"return_ref_type": "new_ref"}, "g": ')
+            db.update_function("h", {"return_ref_type": "none"})
+            with open(db_path, 'r', encoding='utf-8') as f:
+                assert f.read().endswith('"g": ')
+
+            os.remove(db_path)
+            db.update_function("k", {"return_ref_type": "none"})
+            assert sorted(SemanticDatabase(db_path).get_all_functions()) == ["h", "k"]
+    finally:
+        logging.disable(logging.NOTSET)
+
+
+if __name__ == "__main__":
+    test_parallel_writers()
+    test_conflict_policies()
+    test_update_replaces_entry()
+    test_unreadable_file_is_kept()
+    print("All semantic database tests passed")
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""
+Test script for the CFG simplification and temporary propagation transforms
+"""
+
+import os
+
+from lift_helpers import lift
+from lisa_ir.analysis.refcount import check_module
+from lisa_ir.ir.ir_nodes import (
+    FuncDef, BasicBlock, Call, Variable, make_assign, make_call, make_jump, make_return, make_semantic_op,
+    make_variable
+)
+from lisa_ir.transforms.pass_manager import PassManager
+from lisa_ir.transforms.simplify_cfg import ir_size, propagate_temporaries, simplify_cfg
+
+
+EXAMPLE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "examples", "leaky_module.c")
+
+
+def issue_keys(module):
+    """Refcount issues of a module as comparable tuples."""
+    return [(i.kind, i.function, i.variable, i.coord) for i in check_module(module)]
+
+
+def test_simplify_leaky_module():
+    """Simplification shrinks the lifted module without changing what the refcount checker finds."""
+    module = lift(EXAMPLE)
+    original = issue_keys(module)
+    blocks, operations = ir_size(module)
+
+    manager = PassManager(["simplify-cfg", "propagate-temporaries"], max_workers=1)
+    manager.run(module)
+    new_blocks, new_operations = ir_size(module)
+    assert manager.sizes == ((blocks, operations), (new_blocks, new_operations))
+    assert new_blocks < blocks * 0.6
+    assert new_operations < operations * 0.8
+    assert issue_keys(module) == original
+
+    func = module.functions["create_int_list"]
+    assert func.entry_point in func.blocks
+    assert not any(name.endswith(("_fail_2", "_success_1")) for name in func.blocks)
+    [call] = [op for op in func.blocks[func.entry_point].operations if isinstance(op, Call)]
+    assert call.dest_var == "list"
+    assert "call_result_0" not in func.local_vars
+    assert simplify_cfg(func) is None  # already at the fixpoint
+
+
+def test_jump_only_loop():
+    """A cycle of empty jump blocks is kept (threading stops at the cycle)."""
+    func = FuncDef(name="spin", entry_point="entry")
+    func.add_block(BasicBlock(name="entry", terminator=make_jump("a")))
+    func.add_block(BasicBlock(name="a", terminator=make_jump("b")))
+    func.add_block(BasicBlock(name="b", terminator=make_jump("a")))
+    func.add_block(BasicBlock(name="dead", terminator=make_return(None)))
+    simplified = simplify_cfg(func)
+    assert simplified.entry_point == "entry"
+    assert "dead" not in simplified.blocks
+    assert len(func.blocks) == 4  # the input is left alone
+
+
+def test_propagation_guard():
+    """A temporary is kept when its copy target is touched between the call and the copy."""
+    func = FuncDef(name="f", entry_point="entry")
+    func.add_local_var("x", "PyObject *")
+    func.add_local_var("call_result_0", "PyObject *")
+    func.add_block(BasicBlock(name="entry", operations=[
+        make_call("call_result_0", "wrap", [make_variable("x")]),
+        make_semantic_op("steal-ref", {"target": "x", "func": "wrap", "arg_index": 0}),
+        make_semantic_op("new-ref", {"target": "call_result_0"}),
+        make_assign("x", make_variable("call_result_0")),
+    ], terminator=make_return(Variable(name="x"))))
+    assert propagate_temporaries(func) is None
+
+    func.blocks["entry"].operations.pop(1)
+    propagated = propagate_temporaries(func)
+    ops = propagated.blocks["entry"].operations
+    assert [type(op).__name__ for op in ops] == ["Call", "SemanticOp"]
+    assert ops[0].dest_var == "x" and ops[1].attributes == {"target": "x"}
+
+
+if __name__ == "__main__":
+    test_simplify_leaky_module()
+    test_jump_only_loop()
+    test_propagation_guard()
+    print("All CFG simplification tests passed")
@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""
+Test script for dominators, SSA construction and the out-of-SSA printer
+"""
+
+from lift_helpers import lift
+from lisa_ir.analysis.cfg import ControlFlowGraph
+from lisa_ir.ir.ir_nodes import (
+    FuncDef, BasicBlock, Param, Phi, Assign, Call, make_assign, make_binary_op, make_branch_if,
+    make_constant_int, make_jump, make_return, make_variable
+)
+from lisa_ir.transforms.ssa import to_ssa, from_ssa, format_out_of_ssa, base_name
+
+
+SOURCE = """
+#include <Python.h>
+
+static PyObject *sum(PyObject *self, PyObject *seq)
+{
+    long total = 0;
+    Py_ssize_t i, n = PySequence_Size(seq);
+    for (i = 0; i < n; i++) {
+        PyObject *item = PySequence_GetItem(seq, i);
+        if (item == NULL)
+            return NULL;
+        total += PyLong_AsLong(item);
+        Py_DECREF(item);
+    }
+    return PyLong_FromLong(total);
+}
+"""
+
+
+def build(edges, entry="A", assigns=None):
+    """Build a function from {block: [successors]}; blocks assign the variables listed in assigns."""
+    func = FuncDef(name="f", params=[Param(name="x", param_type="int")], entry_point=entry, return_type="int")
+    func.add_local_var("x", "int")
+    for name, succs in edges.items():
+        block = BasicBlock(name=name)
+        for var in (assigns or {}).get(name, []):
+            block.add_operation(make_assign(var, make_binary_op('+', make_variable(var), make_constant_int(1))))
+        if len(succs) == 2:
+            block.set_terminator(make_branch_if(make_variable("x"), succs[0], succs[1]))
+        elif succs:
+            block.set_terminator(make_jump(succs[0]))
+        else:
+            block.set_terminator(make_return(make_variable("x")))
+        func.add_block(block)
+    return func
+
+
+def test_dominators():
+    """Immediate dominators and frontiers, including an irreducible region and a loop to the entry."""
+    edges = {"A": ["B", "C"], "B": ["D"], "C": ["D", "E"], "D": ["E", "F"], "E": ["D"], "F": ["A"], "G": ["F"]}
+    cfg = ControlFlowGraph(build(edges))
+    idom = {cfg.names[b]: cfg.names[d] for b, d in enumerate(cfg.immediate_dominators()) if d >= 0}
+    assert idom == {"A": "A", "B": "A", "C": "A", "D": "A", "E": "A", "F": "D"}
+    assert not cfg.reachable(cfg.index["G"])
+    assert cfg.dominates(cfg.index["D"], cfg.index["F"]) and not cfg.dominates(cfg.index["C"], cfg.index["E"])
+
+    frontiers = {cfg.names[b]: sorted(cfg.names[s] for s in df) for b, df in enumerate(cfg.dominance_frontiers())}
+    assert frontiers["B"] == ["D"]
+    assert frontiers["C"] == ["D", "E"]
+    assert frontiers["E"] == ["D"]
+    assert frontiers["F"] == ["A"]
+    assert frontiers["A"] == ["A"]
+    assert sorted(cfg.names[b] for b in cfg.iterated_frontier([cfg.index["B"]])) == ["A", "D", "E"]
+
+
+def test_ssa_form():
+    """Every version is defined once and loop-carried variables meet in phis at the header."""
+    func = lift(code=SOURCE).functions["sum"]
+    ssa = to_ssa(func)
+
+    defined = []
+    phis = {}
+    for block in ssa.blocks.values():
+        for op in block.operations:
+            if isinstance(op, Phi):
+                defined.append(op.target.name)
+                phis.setdefault(block.name, []).append(base_name(op.target.name))
+            elif isinstance(op, Assign):
+                defined.append(op.target.name)
+            elif isinstance(op, Call) and op.dest_var:
+                defined.append(op.dest_var)
+    assert len(defined) == len(set(defined))
+    [header] = [name for name in phis if name.startswith("for_header")]
+    assert phis == {header: ["total", "i"]}
+
+    # The decrement and its semantic op name the version the loop body assigned
+    decrefs = [op for block in ssa.blocks.values() for op in block.operations
+               if getattr(op, "op_type", None) == "decr-ref"]
+    [item] = [op.target.name for block in ssa.blocks.values() for op in block.operations
+              if isinstance(op, Assign) and base_name(op.target.name) == "item"]
+    assert [op.attributes["target"] for op in decrefs] == [item]
+    assert func.blocks[header].operations == []  # the input is left alone
+
+    listing = format_out_of_ssa(ssa)
+    assert "phi(" not in listing
+    assert "total.2 = total.3;" in listing
+    assert all(not isinstance(op, Phi) for block in from_ssa(ssa).blocks.values() for op in block.operations)
+
+
+def test_entry_loop():
+    """A loop back to the entry gets a fresh entry block so its phi has an incoming edge."""
+    ssa = to_ssa(build({"A": ["B", "C"], "B": ["A"], "C": []}, assigns={"B": ["x"]}))
+    assert ssa.entry_point == "ssa_entry"
+    [phi] = ssa.blocks["A"].operations
+    assert {pred: value.name for pred, value in phi.incoming.items()} == {"ssa_entry": "x", "B": "x.2"}
+
+
+if __name__ == "__main__":
+    test_dominators()
+    test_ssa_form()
+    test_entry_loop()
+    print("All SSA tests passed")